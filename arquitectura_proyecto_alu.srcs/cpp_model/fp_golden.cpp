@@ -0,0 +1,118 @@
+// =============================================================================
+// fp_golden.cpp
+// Generador de salidas esperadas con el modelo bit-exacto (fp_model.hpp).
+// Sustituye a compute.py: lee un tb_vectors_*.mem y escribe el
+// tb_expected_output*.mem correspondiente, con los resultados y flags que
+// produce el RTL (no los de un IEEE-754 "ideal").
+//
+// Compilacion (desde arquitectura_proyecto_alu.srcs/):
+//   g++ -O2 -std=c++17 -pthread -o fp_golden cpp_model/fp_golden.cpp
+//
+// Uso:
+//   fp_golden [-j N] tb_vectors_16_1000.mem [tb_expected_output16_1000.mem]
+//     -j N     hilos (por defecto, todos los nucleos)
+//     --quiet  sin estadisticas en stderr
+//   Sin fichero de salida escribe en stdout. La entrada puede ser texto o
+//   binaria (gen_random/vecbin.py); una salida terminada en .bin se escribe
+//   en el formato binario.
+// Codigo de salida: 0 correcto, 1 error de E/S o de formato.
+// =============================================================================
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fp_model.hpp"
+#include "vectors.hpp"
+
+using namespace fpmodel;
+
+// Vectores por bloque: la memoria es la de un bloque de resultados y su
+// salida, no la del fichero entero
+static const size_t BLOQUE = (size_t)1 << 18;
+
+// La entrada se recorre por bloques; cada hilo evalua y codifica (texto o
+// binario) una parte contigua del bloque, leyendo los vectores directamente
+// de la vista (el .bin mapeado), y las partes se escriben en orden
+template <class Alu>
+static bool run(const VectorSet &vec, int width, unsigned threads, bool bin, std::FILE *out) {
+  const size_t n = vec.size();
+  std::vector<std::string> chunks(threads);
+  std::vector<Result> res(n < BLOQUE ? n : BLOQUE);
+  for (size_t base = 0; base < n; base += BLOQUE) {
+    const size_t len = n - base < BLOQUE ? n - base : BLOQUE;
+    const size_t per = (len + threads - 1) / threads;
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+      pool.emplace_back([&, t]() {
+        const size_t lo = t * per < len ? t * per : len, hi = lo + per < len ? lo + per : len;
+        std::string &s = chunks[t];
+        s.clear();
+        eval_vectors<Alu>(vec, base + lo, base + hi, res.data() + lo);
+        for (size_t i = lo; i < hi; ++i) {
+          if (bin) append_expected_bin(res[i], width, s);
+          else     format_expected(res[i], width, s);
+        }
+      });
+    }
+    for (std::thread &th : pool) th.join();
+    for (const std::string &s : chunks)
+      if (std::fwrite(s.data(), 1, s.size(), out) != s.size()) return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  unsigned threads = std::thread::hardware_concurrency();
+  const char *in_path = nullptr, *out_path = nullptr;
+  bool quiet = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "-j") && i + 1 < argc) threads = (unsigned)std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--quiet")) quiet = true;
+    else if (argv[i][0] != '-' && !in_path) in_path = argv[i];
+    else if (argv[i][0] != '-' && !out_path) out_path = argv[i];
+    else {
+      std::fprintf(stderr, "uso: fp_golden [-j N] [--quiet] vectores.mem [esperado.mem]\n");
+      return 1;
+    }
+  }
+  if (!in_path) {
+    std::fprintf(stderr, "uso: fp_golden [-j N] [--quiet] vectores.mem [esperado.mem]\n");
+    return 1;
+  }
+  if (threads == 0) threads = 1;
+
+  const auto t0 = std::chrono::steady_clock::now();
+  int width = 0;
+  VectorSet vec;
+  std::string err;
+  if (!load_vectors(in_path, width, vec, err)) {
+    std::fprintf(stderr, "fp_golden: %s\n", err.c_str());
+    return 1;
+  }
+
+  const size_t len = out_path ? std::strlen(out_path) : 0;
+  const bool bin = len >= 4 && !std::strcmp(out_path + len - 4, ".bin");
+  FILE *out = out_path ? std::fopen(out_path, "wb") : stdout;
+  if (!out) {
+    std::fprintf(stderr, "fp_golden: no se puede escribir %s\n", out_path);
+    return 1;
+  }
+  bool ok = !bin || write_expected_header(out, width, vec.size());
+  if (ok) ok = width == 16 ? run<Half>(vec, width, threads, bin, out) : run<Single>(vec, width, threads, bin, out);
+  if (!ok || (out_path && std::fclose(out) != 0)) {
+    std::fprintf(stderr, "fp_golden: error al escribir %s\n", out_path ? out_path : "stdout");
+    return 1;
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+
+  if (!quiet) {
+    const double s = std::chrono::duration<double>(t1 - t0).count();
+    std::fprintf(stderr, "%zu vectores de %d bits, %u hilos, %.3f s (%.1f M vectores/s)\n",
+                 vec.size(), width, threads, s, s > 0 ? vec.size() / s / 1e6 : 0.0);
+  }
+  return 0;
+}
@@ -0,0 +1,470 @@
+// =============================================================================
+// fp_model.hpp
+// Modelo de referencia bit-exacto (header-only) de la ALU IEEE-754 'alu'.
+//
+// Replica, modulo por modulo, el camino de datos de sources_1/new:
+//   Suma16Bits (SumaResta.v), ProductHP/Prod (Multiplicacion.v),
+//   DivHP/Division (Division.v), RoundNearestEven, fp16_special_case_handler
+//   y la composicion de flags de alu.v.
+// No es un modelo IEEE "ideal": reproduce tambien los truncamientos de ancho
+// de Verilog y las particularidades del RTL (p. ej. both_are_inf instancia
+// is_inf_detector sin parametros y en 32 bits mira solo los 16 LSB).
+//
+// Parametros de plantilla: EXP = bits de exponente, FRAC = bits de fraccion.
+//   FpAlu<5, 10>  == alu #(.system(16))
+//   FpAlu<8, 23>  == alu #(.system(32))
+// Flags: {invalid, div0, ovf, unf, inx} (bit 4 .. bit 0), igual que ALUFlags.
+// =============================================================================
+#ifndef FP_MODEL_HPP
+#define FP_MODEL_HPP
+
+#include <cstdint>
+
+namespace fpmodel {
+
+enum Op : unsigned { ADD = 0, SUB = 1, MUL = 2, DIV = 3 };
+
+struct Result {
+  uint32_t y;
+  unsigned flags;  // {invalid, div0, ovf, unf, inx}
+};
+
+template <int EXP, int FRAC>
+class FpAlu {
+  static_assert(EXP >= 5 && FRAC >= 10 && EXP + FRAC + 1 <= 32,
+                "formato fuera del rango soportado por el RTL");
+
+ public:
+  // Alias con los mismos nombres que los parametros del RTL
+  static constexpr int MBS = FRAC - 1;
+  static constexpr int EBS = EXP - 1;
+  static constexpr int BS = EXP + FRAC;
+  static constexpr int WIDTH = BS + 1;
+  static constexpr int FSIZE = MBS + 5;
+  static constexpr uint64_t BIAS = (EBS == 4) ? 15 : 127;  // igual que el RTL
+
+  static constexpr uint64_t mask(int n) {
+    return n >= 64 ? ~0ull : ((1ull << n) - 1);
+  }
+  static constexpr uint64_t EMAX = mask(EBS + 1);
+  static constexpr uint64_t QNAN = (EBS == 4) ? 0x7E00u : 0x7FC00000u;
+
+  static Result eval(uint32_t a, uint32_t b, unsigned op) {
+    return alu(a & mask(WIDTH), b & mask(WIDTH), op & 3u);
+  }
+
+  // ------------------------------------------------------------------------
+  // Campos IEEE-754
+  // ------------------------------------------------------------------------
+  static uint64_t man(uint64_t v) { return v & mask(MBS + 1); }
+  static uint64_t expo(uint64_t v) { return (v >> (MBS + 1)) & mask(EBS + 1); }
+  static unsigned sgn(uint64_t v) { return (unsigned)((v >> BS) & 1u); }
+  static uint64_t pack(unsigned s, uint64_t e, uint64_t m) {
+    return ((uint64_t)s << BS) | ((e & EMAX) << (MBS + 1)) | (m & mask(MBS + 1));
+  }
+
+  // Desplazamientos con semantica Verilog (shift >= ancho => 0)
+  static uint64_t shr(uint64_t v, uint64_t s) { return s >= 64 ? 0 : v >> s; }
+  static uint64_t shl(uint64_t v, uint64_t s) { return s >= 64 ? 0 : v << s; }
+
+  // ------------------------------------------------------------------------
+  // RoundNearestEven (FSIZE = MBS+5 en todas las instancias)
+  // ------------------------------------------------------------------------
+  static void rne(uint64_t ms, uint64_t exp, uint64_t &ms_round, uint64_t &exp_round) {
+    const bool guard = (ms >> 4) & 1;
+    const bool rest = (ms & 0xF) != 0;
+    const bool is_even = !((ms >> 5) & 1);
+    const uint64_t temp = ((ms >> 5) & mask(MBS + 1)) + ((guard && (rest || !is_even)) ? 1 : 0);
+    ms_round = temp & mask(MBS + 1);
+    exp_round = (exp + ((temp >> (MBS + 1)) & 1)) & EMAX;
+  }
+
+  // ------------------------------------------------------------------------
+  // SumaResta.v
+  // ------------------------------------------------------------------------
+  struct Shifted {
+    uint64_t F;
+    bool guard, sticky, inexact;
+  };
+
+  // right_shift_pf_sum: {1, mantisa, 10'b0} >> shifts
+  static Shifted right_shift_pf_sum(uint64_t mantisa, uint64_t shifts) {
+    const uint64_t full = (1ull << (MBS + 11)) | (mantisa << 10);
+    const uint64_t sh = shr(full, shifts);
+    return {(sh >> 10) & mask(MBS + 2), ((sh >> 9) & 1) != 0, (sh & 0x1FF) != 0,
+            (sh & 0x3FF) != 0};
+  }
+
+  static void sum_mantisa(uint64_t S, uint64_t R, bool gS, bool gR, uint64_t exp_in,
+                          bool sticky, uint64_t &F, uint64_t &exp_out) {
+    const uint64_t A = (S << 1) | (gS ? 1 : 0);
+    const uint64_t B = (R << 1) | (gR ? 1 : 0);
+    const uint64_t sum = A + B;
+    const bool carry = (sum >> (MBS + 3)) & 1;
+    const uint64_t bits = sum & mask(MBS + 3);
+    const uint64_t ms = carry ? ((bits << 3) | (sticky ? 1 : 0))
+                              : (((bits & mask(MBS + 2)) << 4) | (sticky ? 1 : 0));
+    const uint64_t e = carry ? ((exp_in + 1) & EMAX) : exp_in;
+    rne(ms, e, F, exp_out);
+  }
+
+  // first_one_9bits: distancia desde el MSB de la fraccion hasta el primer '1'
+  static uint64_t first_one_frac(uint64_t val) {
+    for (int idx = MBS; idx >= 0; --idx)
+      if ((val >> idx) & 1) return (uint64_t)(MBS + 1 - idx) & EMAX;
+    return 0;
+  }
+
+  static void resta_mantisa(uint64_t S, uint64_t R, bool is_same_exp, bool is_mayus_exp,
+                            uint64_t exp_in, uint64_t &F, uint64_t &exp_out) {
+    const uint64_t f_aux = (S - R) & mask(MBS + 1);
+    const uint64_t f_aux_e = (R - S) & mask(MBS + 1);
+    const bool debe = S < R;    // borrow de salida de S - R
+    const bool debe_e = R < S;  // borrow de salida de R - S
+
+    const uint64_t idx = first_one_frac(f_aux);
+    const uint64_t idx_e = first_one_frac(f_aux_e);
+
+    const bool cond_idx = (!is_mayus_exp && !is_same_exp) || (is_same_exp && debe);
+    const bool cond_f_shift =
+        (!is_mayus_exp && debe_e) || is_same_exp || (is_mayus_exp && debe);
+
+    const uint64_t idx_to_use = cond_idx ? idx_e : idx;
+    const uint64_t f_to_use = (is_mayus_exp || S >= R) ? f_aux : f_aux_e;
+    const uint64_t exp_aux = (exp_in - idx_to_use) & EMAX;
+
+    const uint64_t exp_tmp = cond_f_shift ? exp_aux : exp_in;
+    const uint64_t f_tmp = cond_f_shift ? (shl(f_to_use, idx_to_use) & mask(MBS + 1)) : f_to_use;
+    const uint64_t lost_bits = shr(f_to_use, (uint64_t)(MBS + 1) - idx_to_use) & mask(MBS + 1);
+
+    rne((f_tmp << 5) | (lost_bits & 0x1F), exp_tmp, F, exp_out);
+  }
+
+  struct Unit {
+    uint64_t F;
+    bool overflow, underflow, invalid, inexact;
+  };
+
+  static Unit suma(uint64_t S, uint64_t R) {
+    const uint64_t m1 = man(S), m2 = man(R);
+    const uint64_t e1 = expo(S), e2 = expo(R);
+    const uint64_t diff1 = (e1 - e2) & EMAX;
+    const uint64_t diff2 = (e2 - e1) & EMAX;
+    const unsigned s1 = sgn(S), s2 = sgn(R);
+
+    const bool mayor = e1 > e2;
+    const bool same = e1 == e2;
+
+    const Shifted sh1 = right_shift_pf_sum(m1, diff2);
+    const Shifted sh2 = right_shift_pf_sum(m2, diff1);
+
+    const uint64_t hidden = 1ull << (MBS + 1);
+    const uint64_t m1_11 = mayor ? (hidden | m1) : sh1.F;
+    const uint64_t m2_11 = mayor ? sh2.F : (hidden | m2);
+    const bool g1 = mayor ? false : sh1.guard;
+    const bool g2 = mayor ? sh2.guard : false;
+
+    const bool sticky = sh1.sticky || sh2.sticky;
+    const bool lost_align = sh1.inexact || sh2.inexact;
+
+    const uint64_t m1_10 = mayor ? m1 : (sh1.F & mask(MBS + 1));
+    const uint64_t m2_10 = mayor ? (sh2.F & mask(MBS + 1)) : m2;
+    const uint64_t exp_aux = mayor ? e1 : e2;
+
+    const bool dif_sign = s1 != s2;
+    const unsigned sign =
+        dif_sign ? ((e1 > e2) ? s1 : (e1 < e2) ? s2 : (m1 >= m2) ? s1 : s2) : s1;
+
+    const bool is_zero_result = (dif_sign && m1 == m2 && e1 == e2) ||
+                                (!dif_sign && m1 == 0 && m2 == 0 && e1 == 0 && e2 == 0);
+
+    uint64_t f_add, e_add, f_sub, e_sub;
+    sum_mantisa(m1_11, m2_11, g1, g2, exp_aux, sticky, f_add, e_add);
+    resta_mantisa(m1_10, m2_10, same, mayor, exp_aux, f_sub, e_sub);
+
+    const uint64_t op_sum = dif_sign ? f_sub : f_add;
+    const uint64_t final_exp = dif_sign ? e_sub : e_add;
+
+    Unit u;
+    u.F = pack((dif_sign && is_zero_result) ? 0 : sign, is_zero_result ? 0 : final_exp,
+               is_zero_result ? 0 : op_sum);
+    u.inexact = lost_align;
+    u.overflow = final_exp == EMAX;
+    u.underflow = final_exp == 0 && u.inexact;
+    u.invalid = false;
+    return u;
+  }
+
+  // ------------------------------------------------------------------------
+  // Multiplicacion.v
+  // ------------------------------------------------------------------------
+  static void prod(uint64_t Sm, uint64_t Rm, uint64_t exp_in, uint64_t &Fm, uint64_t &exp_out,
+                   bool &overflow, bool &inexact) {
+    const int MSIZE = MBS + MBS + 3;
+    const int STEAMSIZE = MBS + MBS + 3 + 6;
+    const uint64_t result = Sm * Rm;
+    const bool debe = (result >> MSIZE) & 1;
+    const bool shift_cond = !debe && !((result >> (MSIZE - 1)) & 1);
+
+    uint64_t first = 0;  // first_one (con el limite inferior fijo 'idx >= 9' del RTL)
+    for (int idx = MBS + MBS; idx >= 9; --idx)
+      if ((result >> idx) & 1) {
+        first = (uint64_t)(MBS + MBS + 2 - idx) & EMAX;
+        break;
+      }
+    const uint64_t shifts = shift_cond ? first : 0;
+
+    const uint64_t exp_pre = debe ? ((exp_in + 1) & EMAX) : ((exp_in - shifts) & EMAX);
+
+    const uint64_t stream0 = result << 6;
+    const uint64_t stream1 = debe ? (stream0 >> (MBS + 2)) : (stream0 >> (MBS + 1));
+    const uint64_t stream2 =
+        shift_cond ? (shl(stream1, shifts) & mask(STEAMSIZE + 1)) : stream1;
+
+    const uint64_t top = (stream2 >> 6) & mask(MBS + 1);
+    const uint64_t guard = (stream2 >> 5) & 1;
+    const uint64_t rest3 = (stream2 >> 2) & 7;
+    const uint64_t sticky = (stream2 & 3) != 0;
+    const uint64_t rest4 = (rest3 << 1) | sticky;
+
+    rne((top << 5) | (guard << 4) | rest4, exp_pre, Fm, exp_out);
+
+    inexact = guard || rest4 != 0;
+    const bool h_overflow = (exp_in + 1) >= EMAX;  // is_overflow (EBS+2 bits)
+    overflow = debe ? h_overflow : false;
+  }
+
+  static Unit producto(uint64_t S, uint64_t R) {
+    const uint64_t m1 = man(S), m2 = man(R);
+    const uint64_t e1 = expo(S), e2 = expo(R);
+    const unsigned sign = sgn(S) ^ sgn(R);
+
+    const bool zero = (e1 == 0 && m1 == 0) || (e2 == 0 && m2 == 0);
+
+    const uint64_t exp_to_use = (e1 + e2 - BIAS) & EMAX;
+    const uint64_t evaluate_flags = e1 + e2;
+    const uint64_t despues = (e1 + e2 - BIAS) & mask(EBS + 2);
+
+    uint64_t m_final, e_final;
+    bool over_t2, inexact_core;
+    const uint64_t hidden = 1ull << (MBS + 1);
+    prod(hidden | m1, hidden | m2, exp_to_use, m_final, e_final, over_t2, inexact_core);
+
+    Unit u;
+    u.F = zero ? 0 : pack(sign, e_final, m_final);
+    u.invalid = e1 == EMAX || e2 == EMAX;  // is_invalid_op: Inf o NaN en la entrada
+    const bool over_t1 = evaluate_flags >= BIAS && despues >= EMAX;
+    const bool under_t1 = evaluate_flags < BIAS;
+    u.overflow = zero ? false : (over_t1 || over_t2 || u.invalid);
+    u.underflow = zero ? false : under_t1;
+    u.inexact = zero ? false : inexact_core;
+    return u;
+  }
+
+  // ------------------------------------------------------------------------
+  // Division.v
+  // ------------------------------------------------------------------------
+  static void division(uint64_t Sm, uint64_t Rm, uint64_t exp_in, uint64_t &Fm,
+                       uint64_t &exp_out, bool &underflow, bool &inexact) {
+    const uint64_t num = Sm << (FSIZE + 1);
+    const uint64_t result = (num / Rm) & mask(FSIZE + 11);
+    const uint64_t faux = result & mask(FSIZE + 3);
+
+    const bool debe = (faux >> (FSIZE + 2)) & 1;
+    const bool shift_cond = !debe && !((faux >> (FSIZE + 1)) & 1);
+
+    uint64_t first = 0;  // first_one_div
+    for (int idx = FSIZE; idx >= 0; --idx)
+      if ((faux >> idx) & 1) {
+        first = (uint64_t)(FSIZE + 1 - idx) & EMAX;
+        break;
+      }
+    const uint64_t shifts = shift_cond ? first : 0;
+
+    const uint64_t fm_out = debe ? ((faux >> 1) & mask(FSIZE + 1))
+                                 : (shl(faux & mask(FSIZE + 1), shifts) & mask(FSIZE + 1));
+    const uint64_t exp_tmp = debe ? ((exp_in + 1) & EMAX) : ((exp_in - shifts) & EMAX);
+
+    rne(fm_out, exp_tmp, Fm, exp_out);
+
+    const bool rem_nz = (num % Rm) != 0;
+    const bool lost_pre_bit = debe ? (faux & 1) : false;
+    const uint64_t low_mask = (shl(1, shifts) - 1) & mask(FSIZE + 3);
+    const bool lost_shift_bits = (!debe && shifts != 0) ? (faux & low_mask) != 0 : false;
+    const bool guard_bit = (fm_out >> 4) & 1;
+    const bool tail_nz = (fm_out & 0xF) != 0;
+
+    inexact = guard_bit || tail_nz || lost_pre_bit || lost_shift_bits || rem_nz;
+    underflow = exp_out == 0 && inexact;
+  }
+
+  static Unit cociente(uint64_t S, uint64_t R) {
+    const uint64_t m1 = man(S), m2 = man(R);
+    const uint64_t e1 = expo(S), e2 = expo(R);
+    const unsigned sign = sgn(S) ^ sgn(R);
+
+    const bool zero_dividend = e1 == 0 && m1 == 0;
+    const bool zero_divisor = e2 == 0 && m2 == 0;
+    const bool zero_case = zero_dividend && !zero_divisor;
+
+    const uint64_t exp_to_use = (e1 - e2 + BIAS) & EMAX;
+    const uint64_t evaluate_flags = e1 + BIAS;
+    const uint64_t despues = (e1 - e2 + BIAS) & mask(EBS + 2);
+
+    uint64_t m_final, e_final;
+    bool uf_core, ix_core;
+    const uint64_t hidden = 1ull << (MBS + 1);
+    division(hidden | m1, hidden | m2, exp_to_use, m_final, e_final, uf_core, ix_core);
+
+    Unit u;
+    u.F = zero_case ? 0 : pack(sign, e_final, m_final);
+    u.invalid = e1 == EMAX || e2 == EMAX;
+    const bool over_h = evaluate_flags >= e2 && despues >= EMAX;
+    const bool under_h = evaluate_flags < e2;
+    u.overflow = zero_case ? false : over_h;
+    u.underflow = zero_case ? false : (uf_core || under_h);
+    u.inexact = zero_case ? false : ix_core;
+    return u;
+  }
+
+  // ------------------------------------------------------------------------
+  // fp16_special_cases.v
+  // ------------------------------------------------------------------------
+  struct Class {
+    bool zero, denorm, normal, inf, nan;
+    unsigned sign;
+  };
+
+  static Class classify(uint64_t v) {
+    const uint64_t e = expo(v), m = man(v);
+    return {e == 0 && m == 0, e == 0 && m != 0, e != 0 && e != EMAX, e == EMAX && m == 0,
+            e == EMAX && m != 0, sgn(v)};
+  }
+
+  struct Special {
+    bool is_special, invalid, div_zero;
+    uint64_t result;
+  };
+
+  static Special special_case(uint64_t a, uint64_t b, unsigned op) {
+    const Class A = classify(a), B = classify(b);
+    const uint64_t pos_zero = 0, neg_zero = 1ull << BS;
+    const uint64_t pos_inf = EMAX << (MBS + 1), neg_inf = neg_zero | pos_inf;
+    const uint64_t signed_inf_a = A.sign ? neg_inf : pos_inf;
+    const unsigned result_sign = A.sign ^ B.sign;
+    const uint64_t b_neg = b ^ (1ull << BS);
+
+    Special s = {false, false, false, 0};
+    if (A.nan || B.nan) {
+      s = {true, true, false, QNAN};
+    } else if (op == ADD || op == SUB) {
+      if (A.inf && B.inf) {
+        if ((op == ADD && A.sign == B.sign) || (op == SUB && A.sign != B.sign))
+          s = {true, false, false, signed_inf_a};
+        else
+          s = {true, true, false, QNAN};
+      } else if (A.inf) {
+        s = {true, false, false, a};
+      } else if (B.inf) {
+        s = {true, false, false, op == ADD ? b : b_neg};
+      } else if (A.zero && B.zero) {
+        s = {true, false, false, (A.sign && B.sign) ? neg_zero : pos_zero};
+      } else if (A.denorm && B.zero) {
+        s = {true, false, false, a};
+      } else if (A.zero && B.denorm) {
+        s = {true, false, false, op == ADD ? b : b_neg};
+      }
+    } else if (op == MUL) {
+      if ((A.inf && B.zero) || (A.zero && B.inf))
+        s = {true, true, false, QNAN};
+      else if (A.inf || B.inf)
+        s = {true, false, false, result_sign ? neg_inf : pos_inf};
+      else if (A.zero || B.zero)
+        s = {true, false, false, result_sign ? neg_zero : pos_zero};
+    } else {  // DIV
+      if (A.zero && B.zero)
+        s = {true, true, false, result_sign ? neg_zero : pos_zero};
+      else if (A.inf && B.inf)
+        s = {true, true, false, QNAN};
+      else if (B.zero && !A.zero)
+        s = {true, false, true, result_sign ? neg_inf : pos_inf};
+      else if (A.inf && !B.inf)
+        s = {true, false, false, result_sign ? neg_inf : pos_inf};
+      else if (B.inf && !A.inf)
+        s = {true, false, false, result_sign ? neg_zero : pos_zero};
+      else if (A.zero && !B.zero)
+        s = {true, false, false, result_sign ? neg_zero : pos_zero};
+    }
+    return s;
+  }
+
+  // is_inf_detector con parametros por defecto (half): ver both_are_inf
+  static bool is_inf_half(uint64_t v) {
+    return ((v >> 10) & 0x1F) == 0x1F && (v & 0x3FF) == 0;
+  }
+
+  // ------------------------------------------------------------------------
+  // alu.v
+  // ------------------------------------------------------------------------
+  static Result alu(uint64_t a, uint64_t b, unsigned op) {
+    const Special sp = special_case(a, b, op);
+
+    if (sp.is_special) {
+      const uint64_t sp_exp = expo(sp.result), sp_frac = man(sp.result);
+      const bool special_is_inf = sp_exp == EMAX && sp_frac == 0;
+      const bool special_is_denorm = sp_exp == 0 && sp_frac != 0;
+      const Class A = classify(a), B = classify(b);
+      const bool any_pos_inf = (A.inf && !A.sign) || (B.inf && !B.sign);
+      const bool any_neg_inf = (A.inf && A.sign) || (B.inf && B.sign);
+      const bool both_inf = is_inf_half(a & 0xFFFF) && is_inf_half(b & 0xFFFF);
+
+      unsigned flags;
+      if (sp.div_zero)
+        flags = (sp.invalid ? 0x10u : 0u) | 0x08u | 0x02u;
+      else if (sp.invalid || both_inf)
+        flags = 0x10u;
+      else if (special_is_inf)
+        flags = 0x01u | (any_neg_inf ? 0x02u : 0u) | (any_pos_inf ? 0x04u : 0u);
+      else
+        flags = special_is_denorm ? 0x02u : 0u;
+      return {(uint32_t)sp.result, flags};
+    }
+
+    Unit u;
+    switch (op) {
+      case ADD: u = suma(a, b); break;
+      case SUB: u = suma(a, b ^ (1ull << BS)); break;
+      case MUL: u = producto(a, b); break;
+      default:  u = cociente(a, b); break;
+    }
+    const bool iv_sel = (op == MUL || op == DIV) ? u.invalid : false;
+
+    const unsigned sign_res = (op == MUL || op == DIV) ? (sgn(a) ^ sgn(b)) : sgn(u.F);
+    uint64_t y = u.F;
+    if (u.overflow) y = pack(sign_res, EMAX, 0);
+    if (u.underflow) y = pack(sign_res, 0, 0);
+
+    const uint64_t r_exp = expo(y), r_frac = man(y);
+    const bool r_is_inf = r_exp == EMAX && r_frac == 0;
+    const bool r_is_zero = r_exp == 0 && r_frac == 0;
+    const bool r_is_sub = r_exp == 0 && r_frac != 0;
+    const bool a_is_zero = expo(a) == 0 && man(a) == 0;
+    const bool b_is_zero = expo(b) == 0 && man(b) == 0;
+
+    const bool ovf = r_is_inf || u.overflow;
+    const bool unf = r_is_sub || u.underflow ||
+                     ((op & 2) && r_is_zero && !a_is_zero && !b_is_zero);
+    const bool inx = u.inexact || ovf || unf;
+
+    const unsigned flags = (iv_sel ? 0x10u : 0u) | (ovf ? 0x04u : 0u) | (unf ? 0x02u : 0u) |
+                           (inx ? 0x01u : 0u);
+    return {(uint32_t)y, flags};
+  }
+};
+
+using Half = FpAlu<5, 10>;
+using Single = FpAlu<8, 23>;
+
+}  // namespace fpmodel
+
+#endif  // FP_MODEL_HPP
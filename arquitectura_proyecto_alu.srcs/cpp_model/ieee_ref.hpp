@@ -0,0 +1,135 @@
+// =============================================================================
+// ieee_ref.hpp
+// Referencia IEEE-754 independiente (header-only) para comparar con la ALU:
+// suma, resta, multiplicacion y division con redondeo al par mas cercano y
+// los cinco flags {invalid, div0, ovf, unf, inx}, igual que ALUFlags.
+//
+// No sale del RTL ni de fp_model.hpp: el resultado lo calcula la FPU del
+// host.
+//   Single  operacion en float; resultado y flags de <cfenv> (fetestexcept)
+//   Half    operacion en double, exacta para +, - y * de dos half y con 53
+//           bits para / (>= 2*11+2: el doble redondeo no cambia el
+//           resultado), y redondeo a half con el mismo metodo que
+//           Stimulus::to_half; los flags se deducen del resultado
+// Convenios, los mismos que formal/ieee_ref.v:
+//   - NaN de salida canonico (0x7E00 / 0x7FC00000); invalid solo con un
+//     sNaN de entrada o una operacion invalida (Inf - Inf, 0 * Inf, 0 / 0,
+//     Inf / Inf), no con un qNaN
+//   - unf = diminuto e inexacto, diminuto detectado despues de redondear
+//     (como x86 SSE y la extension F de RISC-V)
+//   - div0 solo en x / 0 con x finito distinto de cero
+//
+// Requisitos del host: FPU IEEE en modo al par mas cercano y sin FTZ/DAZ,
+// es decir, sin -ffast-math. Los operandos son volatile para que el
+// compilador no reordene la operacion respecto a feclearexcept/fetestexcept.
+//
+//   ieeeref::eval(a, b, op, 16)  == lo que deberia dar alu #(.system(16))
+// =============================================================================
+#ifndef FP_IEEE_REF_HPP
+#define FP_IEEE_REF_HPP
+
+#include <cfenv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace ieeeref {
+
+struct Result {
+  uint32_t y;
+  unsigned flags;  // {invalid, div0, ovf, unf, inx}
+};
+
+enum Flag : unsigned { INX = 0x01, UNF = 0x02, OVF = 0x04, DIV0 = 0x08, INVALID = 0x10 };
+
+// half -> double (exacto)
+inline double from_half(uint32_t v) {
+  const int e = (int)((v >> 10) & 0x1F), m = (int)(v & 0x3FF);
+  double x;
+  if (e == 0x1F)
+    x = m ? NAN : INFINITY;
+  else
+    x = e ? std::ldexp(1024 + m, e - 25) : std::ldexp(m, -24);
+  return (v & 0x8000) ? -x : x;
+}
+
+// double -> half con redondeo al par mas cercano (como Stimulus::to_half)
+inline uint32_t to_half(double x) {
+  const uint32_t s = std::signbit(x) ? 0x8000u : 0u;
+  x = std::fabs(x);
+  if (std::isnan(x)) return 0x7E00u;
+  if (x >= 65520.0) return s | 0x7C00u;  // redondea a infinito
+  if (x == 0.0) return s;
+  int e;
+  std::frexp(x, &e);
+  int exp = e - 1 < -14 ? -14 : e - 1;  // los subnormales usan el ulp de 2^-24
+  uint32_t q = (uint32_t)std::nearbyint(std::ldexp(x, 10 - exp));
+  if (q == 2048) { q = 1024; ++exp; }
+  if (q < 1024) return s | q;  // subnormal (exp == -14)
+  return s | (uint32_t)(exp + 15) << 10 | (q - 1024);
+}
+
+inline Result half(uint32_t a, uint32_t b, unsigned op) {
+  const bool a_nan = (a & 0x7C00) == 0x7C00 && (a & 0x3FF);
+  const bool b_nan = (b & 0x7C00) == 0x7C00 && (b & 0x3FF);
+  if (a_nan || b_nan) {
+    const bool snan = (a_nan && !(a & 0x200)) || (b_nan && !(b & 0x200));
+    return {0x7E00u, snan ? INVALID : 0u};
+  }
+
+  volatile double x = from_half(a), z = from_half(b);
+  std::feclearexcept(FE_ALL_EXCEPT);
+  volatile double r;
+  switch (op & 3u) {
+    case 0: r = x + z; break;
+    case 1: r = x - z; break;
+    case 2: r = x * z; break;
+    default: r = x / z; break;
+  }
+  const int ex = std::fetestexcept(FE_INVALID | FE_DIVBYZERO);
+  if (ex & FE_INVALID) return {0x7E00u, INVALID};
+  // un Inf en double es exacto: Inf op x o x / 0 (half no desborda un double)
+  if (std::isinf(r)) return {to_half(r), (ex & FE_DIVBYZERO) ? DIV0 : 0u};
+
+  const uint32_t y = to_half(r);
+  const double h = from_half(y);
+  const bool ovf = std::isinf(h);
+  // r es exacto salvo en la division; h * z si lo es (11 x 11 bits)
+  const bool inx = ovf || ((op & 3u) == 3 ? h * z != x : h != r);
+  // diminuto despues de redondear: por debajo de 2^-14 incluso con 11 bits
+  // de precision y exponente sin limite
+  const bool tiny = r != 0 && std::fabs(r) < std::ldexp(1.0, -14) - std::ldexp(1.0, -26);
+  return {y, (ovf ? OVF : 0u) | (tiny && inx ? UNF : 0u) | (inx ? INX : 0u)};
+}
+
+inline Result single(uint32_t a, uint32_t b, unsigned op) {
+  float fa, fb;
+  std::memcpy(&fa, &a, 4);
+  std::memcpy(&fb, &b, 4);
+  volatile float x = fa, z = fb;
+  std::feclearexcept(FE_ALL_EXCEPT);
+  volatile float r;
+  switch (op & 3u) {
+    case 0: r = x + z; break;
+    case 1: r = x - z; break;
+    case 2: r = x * z; break;
+    default: r = x / z; break;
+  }
+  const int ex = std::fetestexcept(FE_ALL_EXCEPT);
+  const float fr = r;
+  uint32_t y;
+  std::memcpy(&y, &fr, 4);
+  if (std::isnan(fr)) y = 0x7FC00000u;
+  return {y, ((ex & FE_INVALID) ? INVALID : 0u) | ((ex & FE_DIVBYZERO) ? DIV0 : 0u) |
+                 ((ex & FE_OVERFLOW) ? OVF : 0u) | ((ex & FE_UNDERFLOW) ? UNF : 0u) |
+                 ((ex & FE_INEXACT) ? INX : 0u)};
+}
+
+// width = 16 o 32, como el parametro system del RTL
+inline Result eval(uint32_t a, uint32_t b, unsigned op, int width) {
+  return width == 16 ? half(a & 0xFFFFu, b & 0xFFFFu, op) : single(a, b, op);
+}
+
+}  // namespace ieeeref
+
+#endif  // FP_IEEE_REF_HPP
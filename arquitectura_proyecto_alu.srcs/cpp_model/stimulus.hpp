@@ -0,0 +1,103 @@
+// =============================================================================
+// stimulus.hpp
+// Generador de estimulos (header-only) con la misma mezcla de casos que
+// gen_operand/gen_vector de gen_random/gec_vector.py:
+//   1.25% NaN, 1.25% cero, 5% valores diminutos en (-1e-6, 1e-6),
+//   5% cerca del overflow o +-Inf, 87.5% normales en (-10, 10);
+//   operacion uniforme entre suma, resta, multiplicacion y division.
+//
+// Es un generador sin estado: el vector numero 'index' de la semilla 'seed'
+// siempre es el mismo, asi que cualquier fallo se reproduce con (seed, index)
+// sin volver a generar los anteriores.
+// =============================================================================
+#ifndef FP_STIMULUS_HPP
+#define FP_STIMULUS_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "vectors.hpp"
+
+namespace fpmodel {
+
+class Stimulus {
+ public:
+  explicit Stimulus(uint64_t seed) : seed_(seed) {}
+
+  Vector at(uint64_t index, int width) const {
+    Rng r(seed_ ^ (index * 0x9E3779B97F4A7C15ull));
+    const unsigned op = (unsigned)(r.next() & 3);
+    const uint32_t a = operand(r, width);
+    const uint32_t b = operand(r, width);
+    return {a, b, op};
+  }
+
+  // double -> half con redondeo al par mas cercano (como numpy.float16)
+  static uint32_t to_half(double x) {
+    const uint32_t s = std::signbit(x) ? 0x8000u : 0u;
+    x = std::fabs(x);
+    if (std::isnan(x)) return s | 0x7E00u;
+    if (x >= 65520.0) return s | 0x7C00u;  // redondea a infinito
+    if (x == 0.0) return s;
+    int e;
+    std::frexp(x, &e);
+    int exp = e - 1 < -14 ? -14 : e - 1;  // los subnormales usan el ulp de 2^-24
+    uint32_t q = (uint32_t)std::nearbyint(std::ldexp(x, 10 - exp));
+    if (q == 2048) { q = 1024; ++exp; }
+    if (q < 1024) return s | q;  // subnormal (exp == -14)
+    return s | (uint32_t)(exp + 15) << 10 | (q - 1024);
+  }
+
+  // double -> single con redondeo al par mas cercano (como struct.pack('f'))
+  static uint32_t to_single(double x) {
+    const float f = (float)x;
+    uint32_t u;
+    std::memcpy(&u, &f, 4);
+    return u;
+  }
+
+ private:
+  // splitmix64: cada vector siembra su propio flujo a partir de (seed, index)
+  struct Rng {
+    uint64_t s;
+    explicit Rng(uint64_t seed) : s(seed) {}
+    uint64_t next() {
+      uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      return z ^ (z >> 31);
+    }
+    double uniform(double lo, double hi) {
+      return lo + (hi - lo) * ((double)(next() >> 11) * (1.0 / 9007199254740992.0));
+    }
+  };
+
+  static uint32_t convert(double v, int width) { return width == 32 ? to_single(v) : to_half(v); }
+
+  static uint32_t operand(Rng &r, int width) {
+    const int mbits = width == 32 ? 23 : 10;
+    const double p = r.uniform(0, 100);
+    if (p < 1.25) {  // NaN con signo y mantisa aleatorios
+      const uint32_t sign = (uint32_t)(r.next() & 1) << (width - 1);
+      const uint32_t exp = (width == 32 ? 0xFFu : 0x1Fu) << mbits;
+      const uint32_t mant = 1 + (uint32_t)(r.next() % ((1u << mbits) - 1));
+      return sign | exp | mant;
+    }
+    if (p < 2.5) return 0;  // cero exacto
+    if (p < 7.5) return convert(r.uniform(-1e-6, 1e-6), width);  // underflow / denormales
+    if (p < 12.5) {  // overflow: +-Inf o cerca del maximo
+      double v = r.uniform(0, 1) < 0.5 ? INFINITY
+                 : width == 32 ? r.uniform(3e38, 3.4e38) : r.uniform(6e4, 6.55e4);
+      if (r.uniform(0, 1) < 0.5) v = -v;
+      return convert(v, width);
+    }
+    return convert(r.uniform(-10, 10), width);  // normales
+  }
+
+  uint64_t seed_;
+};
+
+}  // namespace fpmodel
+
+#endif  // FP_STIMULUS_HPP
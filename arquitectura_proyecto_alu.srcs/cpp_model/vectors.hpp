@@ -0,0 +1,347 @@
+// =============================================================================
+// vectors.hpp
+// Lectura/escritura (header-only) de los ficheros de vectores de gen_random/.
+//
+//   tb_vectors_<bits>_<n>.mem          "aaaa...a bbbb...b oo"   (a, b, op en binario)
+//   tb_expected_output<bits>_<n>.mem   "yyyy...y fffff"         (resultado, flags)
+//
+// op: 00 suma, 01 resta, 10 multiplicacion, 11 division (igual que el RTL).
+// El ancho (16 o 32) se deduce del primer operando de la primera linea;
+// las lineas vacias o mal formadas se ignoran, como en compute.py.
+//
+// Los mismos ficheros en formato binario (gen_random/vecbin.py): cabecera de
+// 16 bytes {"FPVB", version 1, kind 'V'/'E', width, 0, count u64} y registros
+// fijos con cada campo en una palabra little-endian de 'width' bits
+// ({a, b, op} o {y, flags}). BinFile los mapea en memoria (POSIX mmap);
+// load_vectors/load_expected aceptan cualquiera de los dos formatos y dan
+// una vista por indice (VectorSet/ResultSet) que no copia los registros de
+// un .bin. Las salidas se escriben por bloques (format_expected,
+// append_expected_bin), sin guardar todos los resultados en memoria.
+// =============================================================================
+#ifndef FP_VECTORS_HPP
+#define FP_VECTORS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fp_model.hpp"
+
+namespace fpmodel {
+
+struct Vector {
+  uint32_t a, b;
+  unsigned op;
+};
+
+namespace detail {
+
+// Lee un campo binario de exactamente n digitos en p; avanza p
+inline bool parse_bin(const char *&p, const char *end, int n, uint32_t &v) {
+  if (end - p < n) return false;
+  v = 0;
+  for (int i = 0; i < n; ++i) {
+    const unsigned d = (unsigned)(p[i] - '0');
+    if (d > 1) return false;
+    v = (v << 1) | d;
+  }
+  p += n;
+  return true;
+}
+
+// Lee un campo binario de 1 a n digitos; uno mas largo es un error (no se
+// trunca a los n bits bajos como haria $sscanf, igual que en vecbin.py)
+inline bool parse_bin_upto(const char *&p, const char *end, int n, uint32_t &v) {
+  const char *q = p;
+  v = 0;
+  while (q < end && (*q == '0' || *q == '1')) v = (v << 1) | (uint32_t)(*q++ - '0');
+  if (q == p || q - p > n) return false;
+  p = q;
+  return true;
+}
+
+inline void skip_blank(const char *&p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+}
+
+}  // namespace detail
+
+// Parsea el contenido completo de un tb_vectors_*.mem.
+// width vale 0 a la entrada para deducirlo (16 o 32); devuelve false si no
+// hay ninguna linea valida o si los anchos no son 16/32.
+inline bool parse_vectors(const std::string &text, int &width, std::vector<Vector> &out) {
+  const char *p = text.data();
+  const char *const end = p + text.size();
+  while (p < end) {
+    const char *eol = p;
+    while (eol < end && *eol != '\n') ++eol;
+
+    const char *q = p;
+    detail::skip_blank(q, eol);
+    if (width == 0) {
+      const char *t = q;
+      while (t < eol && (*t == '0' || *t == '1')) ++t;
+      if (t - q == 16 || t - q == 32) width = (int)(t - q);
+    }
+
+    Vector v;
+    uint32_t op = 0;
+    bool ok = width != 0 && detail::parse_bin(q, eol, width, v.a);
+    if (ok) { detail::skip_blank(q, eol); ok = detail::parse_bin(q, eol, width, v.b); }
+    if (ok) { detail::skip_blank(q, eol); ok = detail::parse_bin(q, eol, 2, op); }
+    if (ok) { detail::skip_blank(q, eol); ok = q == eol; }
+    if (ok) {
+      v.op = op;
+      out.push_back(v);
+    }
+    p = eol + 1;
+  }
+  return width != 0 && !out.empty();
+}
+
+// Parsea un tb_expected_output*.mem del ancho dado; una entrada por linea no
+// vacia. Una linea mal formada o con un campo de mas de 'width' (o 5) bits
+// hace fallar el parseo (lineno = su numero).
+inline bool parse_expected(const std::string &text, int width, std::vector<Result> &out,
+                           size_t &lineno) {
+  const char *p = text.data();
+  const char *const end = p + text.size();
+  while (p < end) {
+    const char *eol = p;
+    while (eol < end && *eol != '\n') ++eol;
+
+    const char *q = p;
+    Result r;
+    uint32_t flags = 0;
+    ++lineno;
+    detail::skip_blank(q, eol);
+    if (q != eol) {
+      bool ok = detail::parse_bin_upto(q, eol, width, r.y);
+      if (ok) { detail::skip_blank(q, eol); ok = detail::parse_bin_upto(q, eol, 5, flags); }
+      if (ok) { detail::skip_blank(q, eol); ok = q == eol; }
+      if (!ok) return false;
+      r.flags = flags;
+      out.push_back(r);
+    }
+    p = eol + 1;
+  }
+  lineno = 0;
+  return true;
+}
+
+// Agrega "yyyy fffff\n" a out (formato de tb_expected_output*.mem)
+inline void format_expected(const Result &r, int width, std::string &out) {
+  char line[32 + 1 + 5 + 1];
+  char *c = line;
+  for (int i = width - 1; i >= 0; --i) *c++ = (char)('0' + ((r.y >> i) & 1u));
+  *c++ = ' ';
+  for (int i = 4; i >= 0; --i) *c++ = (char)('0' + ((r.flags >> i) & 1u));
+  *c++ = '\n';
+  out.append(line, (size_t)(c - line));
+}
+
+// Agrega el registro binario {y, flags} a out (el host es little-endian)
+inline void append_expected_bin(const Result &r, int width, std::string &out) {
+  const uint32_t v[2] = {r.y, r.flags};
+  for (uint32_t x : v)
+    for (int b = 0; b < width / 8; ++b) out.push_back((char)(uint8_t)(x >> (8 * b)));
+}
+
+// ----------------------------------------------------------------------------
+// Formato binario
+// ----------------------------------------------------------------------------
+enum BinKind : uint8_t { BIN_VECTORS = 'V', BIN_EXPECTED = 'E' };
+
+struct BinHeader {
+  char magic[4];  // "FPVB"
+  uint8_t version, kind, width, reserved;
+  uint64_t count;
+};
+static_assert(sizeof(BinHeader) == 16, "cabecera FPVB de 16 bytes");
+
+// Fichero binario mapeado en memoria (solo lectura); los registros se
+// decodifican al vuelo, asi que no hace falta cargarlo entero en RAM
+class BinFile {
+ public:
+  BinFile() = default;
+  BinFile(const BinFile &) = delete;
+  BinFile &operator=(const BinFile &) = delete;
+  ~BinFile() {
+    if (map_) munmap(map_, len_);
+  }
+
+  static bool is_bin(const char *path) {
+    char m[4] = {};
+    std::FILE *f = std::fopen(path, "rb");
+    if (!f) return false;
+    const bool ok = std::fread(m, 1, 4, f) == 4 && std::memcmp(m, "FPVB", 4) == 0;
+    std::fclose(f);
+    return ok;
+  }
+
+  bool open(const char *path, BinKind kind, std::string &err) {
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0) { err = std::string("no se puede abrir ") + path; return false; }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(BinHeader)) {
+      ::close(fd);
+      err = std::string(path) + ": cabecera FPVB incompleta";
+      return false;
+    }
+    len_ = (size_t)st.st_size;
+    map_ = mmap(nullptr, len_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map_ == MAP_FAILED) { map_ = nullptr; err = std::string("mmap de ") + path; return false; }
+
+    std::memcpy(&h_, map_, sizeof h_);
+    fields_ = kind == BIN_VECTORS ? 3 : 2;
+    if (std::memcmp(h_.magic, "FPVB", 4) != 0 || h_.version != 1 || h_.kind != kind ||
+        (h_.width != 16 && h_.width != 32)) {
+      err = std::string(path) + ": no es un fichero FPVB de " +
+            (kind == BIN_VECTORS ? "vectores" : "resultados esperados");
+      return false;
+    }
+    if (len_ < sizeof h_ + h_.count * record_size()) {
+      err = std::string(path) + ": fichero truncado";
+      return false;
+    }
+    recs_ = (const uint8_t *)map_ + sizeof h_;
+    return true;
+  }
+
+  int width() const { return h_.width; }
+  size_t size() const { return (size_t)h_.count; }
+  size_t record_size() const { return (size_t)fields_ * (h_.width / 8); }
+
+  Vector vector(size_t i) const {
+    const uint8_t *r = recs_ + i * record_size();
+    return {field(r, 0), field(r, 1), field(r, 2)};
+  }
+  Result result(size_t i) const {
+    const uint8_t *r = recs_ + i * record_size();
+    return {field(r, 0), field(r, 1)};
+  }
+  void read(size_t i, Vector &v) const { v = vector(i); }
+  void read(size_t i, Result &r) const { r = result(i); }
+
+ private:
+  uint32_t field(const uint8_t *r, int k) const {
+    if (h_.width == 16) {
+      uint16_t v;
+      std::memcpy(&v, r + 2 * k, 2);
+      return v;
+    }
+    uint32_t v;
+    std::memcpy(&v, r + 4 * k, 4);
+    return v;
+  }
+
+  void *map_ = nullptr;
+  size_t len_ = 0;
+  BinHeader h_{};
+  int fields_ = 0;
+  const uint8_t *recs_ = nullptr;
+};
+
+// Cabecera de un fichero de count resultados {y, flags}; los registros van
+// detras (append_expected_bin)
+inline bool write_expected_header(std::FILE *f, int width, size_t count) {
+  BinHeader h = {{'F', 'P', 'V', 'B'}, 1, BIN_EXPECTED, (uint8_t)width, 0, count};
+  return std::fwrite(&h, sizeof h, 1, f) == 1;
+}
+
+// Registros de un fichero de vectores (VectorSet) o de resultados
+// (ResultSet) con acceso por indice. Un .bin se queda mapeado y cada
+// registro se decodifica al leerlo, sin copiarlo; un .mem de texto no tiene
+// registros de tamaño fijo y se parsea a memoria
+template <class T>
+class RecordSet {
+ public:
+  size_t size() const { return bin_ ? file_.size() : text_.size(); }
+  T operator[](size_t i) const {
+    if (!bin_) return text_[i];
+    T r;
+    file_.read(i, r);
+    return r;
+  }
+
+ private:
+  friend bool load_vectors(const char *, int &, RecordSet<Vector> &, std::string &);
+  friend bool load_expected(const char *, int, RecordSet<Result> &, std::string &);
+  BinFile file_;
+  bool bin_ = false;
+  std::vector<T> text_;
+};
+typedef RecordSet<Vector> VectorSet;
+typedef RecordSet<Result> ResultSet;
+
+// ----------------------------------------------------------------------------
+// Carga de ficheros en cualquiera de los dos formatos
+// ----------------------------------------------------------------------------
+inline bool read_text_file(const char *path, std::string &text) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  return true;
+}
+
+// width vale 0 a la entrada y sale con el ancho del fichero
+inline bool load_vectors(const char *path, int &width, VectorSet &out, std::string &err) {
+  if (BinFile::is_bin(path)) {
+    out.bin_ = true;
+    if (!out.file_.open(path, BIN_VECTORS, err)) return false;
+    width = out.file_.width();
+    return true;
+  }
+  std::string text;
+  if (!read_text_file(path, text)) { err = std::string("no se puede abrir ") + path; return false; }
+  if (!parse_vectors(text, width, out.text_)) {
+    err = std::string(path) + " no contiene vectores de 16 o 32 bits";
+    return false;
+  }
+  return true;
+}
+
+inline bool load_expected(const char *path, int width, ResultSet &out, std::string &err) {
+  if (BinFile::is_bin(path)) {
+    out.bin_ = true;
+    if (!out.file_.open(path, BIN_EXPECTED, err)) return false;
+    if (out.file_.width() != width) {
+      err = std::string(path) + ": resultados de " + std::to_string(out.file_.width()) + " bits";
+      return false;
+    }
+    return true;
+  }
+  std::string text;
+  size_t line = 0;
+  if (!read_text_file(path, text)) { err = std::string("no se puede abrir ") + path; return false; }
+  if (!parse_expected(text, width, out.text_, line)) {
+    err = std::string(path) + ":" + std::to_string(line) + ": linea mal formada";
+    return false;
+  }
+  return true;
+}
+
+// Evalua los vectores [lo, hi) con el modelo del formato dado (Half o
+// Single); r[0] es el resultado del vector lo
+template <class Alu>
+inline void eval_vectors(const VectorSet &v, size_t lo, size_t hi, Result *r) {
+  for (size_t i = lo; i < hi; ++i) {
+    const Vector x = v[i];
+    r[i - lo] = Alu::eval(x.a, x.b, x.op);
+  }
+}
+
+}  // namespace fpmodel
+
+#endif  // FP_VECTORS_HPP
@@ -0,0 +1,174 @@
+`timescale 1ns / 1ps
+// =============================================================================
+// alu_formal
+// Formal top for alu_formal.sby: alu against ieee_ref, an IEEE-754
+// round-to-nearest-even reference for add, sub and mul written from the
+// standard, plus properties on the fp16_special_case_handler paths and on
+// the flags {invalid, div0, ovf, unf, inx}. a and b are free inputs; op is
+// fixed by OP (0..3) or free when OP = 4.
+//
+// Equivalence: y and ALUFlags must match ieee_ref except where a waiver
+// below covers the operands. Each waiver is one known deviation of the RTL
+// from IEEE-754, named w_<deviation>, and says what it excuses: the whole
+// result (waive_y) and/or some flags (waive_flags). Nothing outside them is
+// excused, so a new deviation shows up in the proof; a waiver that an RTL
+// fix makes unnecessary does not, and is removed by hand. div has no
+// reference; only the properties cover it.
+//
+// The properties are IEEE-754 facts, not the RTL's contract: the ones this
+// RTL breaks are listed in alu_formal.sby and fail in their tasks.
+// =============================================================================
+module alu_formal #(parameter SYSTEM = 16, parameter OP = 4) (
+  input wire [SYSTEM-1:0] a,
+  input wire [SYSTEM-1:0] b,
+  input wire [1:0]        op_in
+);
+  localparam integer EXP_BITS  = (SYSTEM == 16) ? 5  : 8;
+  localparam integer FRAC_BITS = (SYSTEM == 16) ? 10 : 23;
+  localparam integer MBS = FRAC_BITS - 1;
+  localparam integer EBS = EXP_BITS  - 1;
+  localparam integer BS  = SYSTEM - 1;
+  localparam [BS:0]  QNAN = (SYSTEM == 16) ? 16'h7E00 : 32'h7FC00000;
+  localparam [BS-1:0] MIN_NORMAL = {{EBS{1'b0}}, 1'b1, {MBS+1{1'b0}}};
+
+  wire [1:0] op = (OP < 4) ? OP : op_in;
+
+  wire [BS:0] y, ref_y;
+  wire [4:0]  ALUFlags, ref_flags;
+
+  alu #(.system(SYSTEM)) dut (
+    .a(a), .b(b), .op(op), .y(y), .ALUFlags(ALUFlags)
+  );
+
+  ieee_ref #(.SYSTEM(SYSTEM)) ref_model (
+    .a(a), .b(b), .op(op), .y(ref_y), .flags(ref_flags)
+  );
+
+  // Same handler as inside dut, to state properties on its outputs
+  wire        is_special, special_invalid, special_div0;
+  wire [BS:0] special_result;
+  fp16_special_case_handler #(.MBS(MBS), .EBS(EBS), .BS(BS)) handler (
+    .a(a), .b(b), .op(op),
+    .is_special_case(is_special),
+    .special_result(special_result),
+    .invalid_op(special_invalid),
+    .div_by_zero(special_div0)
+  );
+
+  // ---------- Operand and result classes ----------
+  function is_zero(input [BS:0] v);   is_zero = v[BS-1:0] == 0;                                endfunction
+  function is_sub(input [BS:0] v);    is_sub  = v[BS-1:MBS+1] == 0 && v[MBS:0] != 0;           endfunction
+  function is_inf(input [BS:0] v);    is_inf  = &v[BS-1:MBS+1] && v[MBS:0] == 0;               endfunction
+  function is_nan(input [BS:0] v);    is_nan  = &v[BS-1:MBS+1] && v[MBS:0] != 0;               endfunction
+  function is_norm(input [BS:0] v);   is_norm = |v[BS-1:MBS+1] && !(&v[BS-1:MBS+1]);           endfunction
+
+  wire invalid = ALUFlags[4];
+  wire div0    = ALUFlags[3];
+  wire ovf     = ALUFlags[2];
+  wire unf     = ALUFlags[1];
+  wire inx     = ALUFlags[0];
+
+  wire a_finite = !is_inf(a) && !is_nan(a);
+  wire b_finite = !is_inf(b) && !is_nan(b);
+
+  // ---------- Known deviations from IEEE-754 (waivers) ----------
+  wire both_norm = is_norm(a) && is_norm(b);
+  wire eff_sub   = a[BS] ^ b[BS] ^ (op == 2'b01);  // add/sub of opposite signs
+  wire [EBS:0] exp_a = a[BS-1:MBS+1], exp_b = b[BS-1:MBS+1];
+  wire [EBS:0] exp_diff = (exp_a > exp_b) ? exp_a - exp_b : exp_b - exp_a;
+  wire [2*MBS+3:0] sig_prod = {1'b1, a[MBS:0]} * {1'b1, b[MBS:0]};
+
+  // NaN operands: any NaN raises invalid, also a quiet one (IEEE: only sNaN)
+  wire w_qnan_invalid = is_nan(a) || is_nan(b);
+  // Inf op Inf: both_are_inf raises invalid even when the result is a valid
+  // Inf (Inf + Inf, Inf - -Inf, Inf * Inf)
+  wire w_inf_inf_invalid = is_inf(a) && is_inf(b);
+  // Inf op x with an Inf result raises inx, plus ovf for a +Inf operand and
+  // unf for a -Inf one; IEEE raises nothing (the result is exact)
+  wire w_inf_flags = (is_inf(a) || is_inf(b)) && !is_nan(a) && !is_nan(b);
+  // subnormal +/- zero: the handler returns the subnormal operand with unf
+  // set, without inx; IEEE raises nothing (the result is exact)
+  wire w_subnormal_zero_unf = !op[1] && ((is_sub(a) && is_zero(b)) || (is_zero(a) && is_sub(b)));
+  // -0 - 0 and -0 - -0: the handler takes the sign as sign(a) & sign(b) of
+  // the operands before b is negated, so they return +0 and -0 (IEEE: -0, +0)
+  wire w_zero_minus_zero = op == 2'b01 && is_zero(a) && is_zero(b) && a[BS];
+  // an operand with a zero exponent field that reaches the datapath (zero +
+  // normal, subnormal op non-zero): the units read it with a hidden 1, as
+  // 1.f * 2^-BIAS instead of 0.f * 2^(1-BIAS) (or 0)
+  wire w_exp0_operand = !is_special && (exp_a == 0 || exp_b == 0);
+  // tiny results of the datapath: the adder does not denormalize (the
+  // exponent wraps below zero) and the multiplier flushes to zero, at times
+  // with ovf
+  wire w_tiny_result = !is_special && (is_sub(ref_y) || ref_flags[1]);
+  // effective addition: inx only counts bits lost in an alignment shift of
+  // less than the full significand, not the bit dropped when the sum
+  // carries out nor an operand shifted out entirely
+  wire w_add_inexact = !op[1] && both_norm && !eff_sub;
+  // effective addition with exponents more than 10 apart: the alignment
+  // shifter keeps 10 bits below the significand ({1, m, 10'b0}), the rest
+  // are lost for sticky and ties round wrongly
+  wire w_add_far = !op[1] && both_norm && !eff_sub && exp_diff > 10;
+  // effective subtraction with different exponents: the aligned operand's
+  // guard and sticky bits are dropped and the difference is truncated and
+  // renormalized from FRAC_BITS bits (errors of several ulps, wrong inx)
+  wire w_sub_align = !op[1] && both_norm && eff_sub && exp_a != exp_b;
+  // mul: the product bits below the sticky window (sig_prod[MBS-5:0] with a
+  // carry-out, [MBS-6:0] without) are dropped: ties round to even wrongly
+  // and inx is missed
+  wire w_mul_low_bits = op == 2'b10 && both_norm &&
+                        (sig_prod[2*MBS+3] ? sig_prod[MBS-5:0] != 0 : sig_prod[MBS-6:0] != 0);
+
+  wire waive_y = w_zero_minus_zero || w_exp0_operand || w_tiny_result || w_add_far ||
+                 w_sub_align || w_mul_low_bits;
+  wire [4:0] waive_flags = {w_qnan_invalid || w_inf_inf_invalid, 1'b0, 3'b000} |
+                           {2'b00, {3{w_inf_flags}}} |
+                           {3'b000, w_subnormal_zero_unf, 1'b0} |
+                           {5{w_exp0_operand || w_tiny_result}} |
+                           {4'b0000, w_add_inexact || w_sub_align || w_mul_low_bits};
+
+  always @* begin
+    // ---------- Equivalence with ieee_ref (add, sub, mul) ----------
+    equiv_y:           assert (op == 2'b11 || waive_y || y == ref_y);
+    equiv_flags:       assert (op == 2'b11 || ((ALUFlags ^ ref_flags) & ~waive_flags) == 0);
+
+    // ---------- Flag invariants ----------
+    ovf_is_inf:        assert (!ovf || is_inf(y));
+    ovf_is_inexact:    assert (!ovf || inx);
+    ovf_not_unf:       assert (!(ovf && unf));
+    unf_is_inexact:    assert (!unf || inx);
+    unf_not_normal:    assert (!unf || y[BS-1:0] <= MIN_NORMAL);
+    nan_is_canonical:  assert (!is_nan(y) || y == QNAN);
+    div0_only_x_div_0: assert (!div0 || (op == 2'b11 && is_zero(b) && !is_zero(a) && !is_nan(a)));
+    div0_is_inf:       assert (!div0 || is_inf(y));
+    invalid_is_nan:    assert (!invalid || is_nan(y));
+
+    // ---------- fp16_special_case_handler ----------
+    special_drives_y:  assert (!is_special || y == special_result);
+    special_complete:  assert (is_special || (a_finite && b_finite &&
+                               (!op[1] || (!is_zero(a) && !is_zero(b)))));
+    nan_operand:       assert (!(is_nan(a) || is_nan(b)) || y == QNAN);
+    inf_plus_finite:   assert (!(!op[1] && is_inf(a) != is_inf(b) && !is_nan(a) && !is_nan(b)) ||
+                               y == (is_inf(a) ? a : (op == 2'b00) ? b : {~b[BS], b[BS-1:0]}));
+    // x - x = +0 exactly (zeros are covered by equiv_y)
+    x_minus_x:         assert (!(op == 2'b01 && a == b && a_finite && !is_zero(a)) || (y == 0 && ALUFlags == 0));
+    inf_times_zero:    assert (!(op == 2'b10 && ((is_inf(a) && is_zero(b)) || (is_zero(a) && is_inf(b)))) ||
+                               (y == QNAN && invalid));
+    x_div_zero:        assert (!(op == 2'b11 && is_zero(b) && !is_zero(a) && a_finite) ||
+                               (y == {a[BS] ^ b[BS], {EBS+1{1'b1}}, {MBS+1{1'b0}}} && div0));
+  end
+
+  // ADD is not commutative in this RTL (alignment and sign selection depend on
+  // the operand order); MUL is, including flags
+  generate
+    if (OP == 2) begin : g_mul_commutes
+      wire [BS:0] y_ba;
+      wire [4:0]  flags_ba;
+      alu #(.system(SYSTEM)) dut_ba (
+        .a(b), .b(a), .op(op), .y(y_ba), .ALUFlags(flags_ba)
+      );
+      always @* begin
+        mul_commutes: assert (y_ba == y && flags_ba == ALUFlags);
+      end
+    end
+  endgenerate
+endmodule
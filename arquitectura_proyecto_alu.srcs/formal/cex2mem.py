@@ -0,0 +1,103 @@
+"""
+Counterexamples of the formal flow (alu_formal.sby) as .mem vectors.
+
+Reads the VCD traces that SymbiYosys leaves in each task directory
+(alu_formal_<task>/engine_*/*.vcd), takes a, b, op and the outputs of the
+alu and of the IEEE-754 reference (ieee_ref) from the top scope of
+alu_formal, and writes them in the text format of gen_random (vecbin.py):
+
+  <prefix>_vectores.mem   a b op              (tb_alu_frandom16 +vectores=)
+  <prefix>_esperados.mem  y flags of ieee_ref (tb_alu_frandom16 +esperados=);
+                          not written if a counterexample is a div, which
+                          ieee_ref does not model
+  <prefix>_obtenidos.mem  y flags of alu
+
+so a counterexample can be replayed in simulation, or bucketed with
+  python ../gen_random/triage.py volcado --width 16 \
+      <prefix>_vectores.mem <prefix>_esperados.mem <prefix>_obtenidos.mem
+Which assertion failed is in the SymbiYosys log of the task.
+
+Usage:
+  python cex2mem.py alu_formal_add alu_formal_mul [-o cex]
+Exit code: 0 with no counterexamples, 1 otherwise.
+"""
+import argparse
+import glob
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "gen_random"))
+import vecbin  # noqa: E402
+
+SIGNALS = ("a", "b", "op", "y", "ALUFlags", "ref_y", "ref_flags")
+
+
+def read_vcd(path):
+    """Values of SIGNALS in the top scope at the first time step of a trace"""
+    ids, values, depth = {}, {}, 0
+    with open(path) as f:
+        tokens = iter(f.read().split())
+    for tok in tokens:
+        if tok in ("$date", "$version", "$comment"):
+            while next(tokens) != "$end":
+                pass
+        elif tok == "$scope":
+            depth += 1
+        elif tok == "$upscope":
+            depth -= 1
+        elif tok == "$var":
+            _, _, ident, name = next(tokens), next(tokens), next(tokens), next(tokens)
+            if depth == 1 and name in SIGNALS:
+                ids[ident] = name
+        elif tok.startswith("#") and tok != "#0":
+            break
+        elif tok[0] in "bB":
+            ident = next(tokens)
+            if ident in ids and ids[ident] not in values:
+                values[ids[ident]] = int(tok[1:].replace("x", "0").replace("z", "0"), 2)
+        elif tok[0] in "01" and tok[1:] in ids and ids[tok[1:]] not in values:
+            values[ids[tok[1:]]] = int(tok[0])
+    missing = [s for s in SIGNALS if s not in values]
+    if missing:
+        raise ValueError(f"{path}: missing {', '.join(missing)} in the top scope")
+    return values
+
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser(description="counterexamples of alu_formal.sby as .mem vectors")
+    ap.add_argument("dirs", nargs="+", help="SymbiYosys task directories (alu_formal_<task>)")
+    ap.add_argument("-o", "--prefix", default="cex", help="output prefix (default cex)")
+    ap.add_argument("--width", type=int, default=16, choices=(16, 32))
+    args = ap.parse_args()
+
+    cases = {}
+    for d in args.dirs:
+        if not os.path.isdir(d):
+            ap.error(f"{d}: no such SymbiYosys task directory")
+        for vcd in sorted(glob.glob(os.path.join(d, "engine_*", "*.vcd"))):
+            v = read_vcd(vcd)
+            key = (v["a"], v["b"], v["op"])
+            if key not in cases:
+                cases[key] = v
+                h = args.width // 4
+                ref = "" if v["op"] == 3 else f"ref y={v['ref_y']:0{h}x} flags={v['ref_flags']:05b}, "
+                print(f"❌ {vcd}: a={v['a']:0{h}x} b={v['b']:0{h}x} op={v['op']:02b} "
+                      f"{ref}alu y={v['y']:0{h}x} flags={v['ALUFlags']:05b}")
+    if not cases:
+        print("✅ No counterexamples")
+        sys.exit(0)
+
+    vs = list(cases.values())
+    vecbin.write_text(f"{args.prefix}_vectores.mem", vecbin.KIND_VECTORS, args.width,
+                      [(v["a"], v["b"], v["op"]) for v in vs])
+    vecbin.write_text(f"{args.prefix}_obtenidos.mem", vecbin.KIND_EXPECTED, args.width,
+                      [(v["y"], v["ALUFlags"]) for v in vs])
+    outs = [f"{args.prefix}_vectores.mem", f"{args.prefix}_obtenidos.mem"]
+    if all(v["op"] != 3 for v in vs):
+        vecbin.write_text(f"{args.prefix}_esperados.mem", vecbin.KIND_EXPECTED, args.width,
+                          [(v["ref_y"], v["ref_flags"]) for v in vs])
+        outs.insert(1, f"{args.prefix}_esperados.mem")
+    else:
+        print("⚠ div counterexamples have no IEEE reference: esperados not written")
+    print(f"{len(vs)} counterexamples -> {', '.join(outs)}")
+    sys.exit(1)
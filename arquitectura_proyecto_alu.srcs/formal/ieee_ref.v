@@ -0,0 +1,156 @@
+`timescale 1ns / 1ps
+// =============================================================================
+// ieee_ref
+// Synthesizable IEEE-754 reference for the formal flow (alu_formal.sv):
+// add, sub and mul in round-to-nearest-even with the five IEEE flags, written
+// from the standard, not from the RTL or from cpp_model/fp_model.hpp.
+//
+// Every finite operand is read as sig * 2^(exp - BIAS - FRAC), with the
+// hidden bit only for exp != 0 and exp = 1 for subnormals. The exact result
+// is formed as an integer M with the weight of its LSB (E, biased), then
+// rounded once:
+//   add/sub  both operands aligned to E = 1 (no bit is ever discarded) and
+//            added or subtracted as integers of FRAC + EMAX - 1 bits
+//   mul      the full (2*FRAC+2)-bit product, E = ea + eb - BIAS - FRAC
+// Rounding keeps FRAC+1 bits from the leading one, or fewer when the result
+// is below 2^EMIN (gradual underflow), ties to even; a rounded exponent of
+// EMAX is an overflow to Inf.
+//
+// Flags {invalid, div0, ovf, unf, inx} as in ALUFlags:
+//   invalid  sNaN operand, Inf - Inf, Inf * 0; the result is the canonical
+//            quiet NaN (also for quiet NaN operands, without invalid)
+//   ovf      rounded result too large: Inf, with inx
+//   unf      tiny and inexact; tininess is detected after rounding (as
+//            RISC-V's F extension does)
+//   inx      rounded result != exact result
+// div0 is never set: op 3 (div) is not modelled and its outputs are 0.
+// Exact zero sums are +0 unless both operands are -0.
+//
+// Same parameter as alu: ieee_ref #(.SYSTEM(16)) checks alu #(.system(16)).
+// The add datapath is FRAC + EMAX bits wide, 41 bits for half precision; it
+// is meant for SYSTEM = 16 (single precision would need 279 bits).
+// =============================================================================
+module ieee_ref #(parameter SYSTEM = 16) (
+  input  wire [SYSTEM-1:0] a,
+  input  wire [SYSTEM-1:0] b,
+  input  wire [1:0]        op,
+  output reg  [SYSTEM-1:0] y,
+  output reg  [4:0]        flags
+);
+  localparam integer EXP  = (SYSTEM == 16) ? 5 : 8;
+  localparam integer FRAC = (SYSTEM == 16) ? 10 : 23;
+  localparam integer EMAX = (1 << EXP) - 1;
+  localparam integer BIAS = (1 << (EXP - 1)) - 1;
+  localparam integer AW   = FRAC + EMAX - 1;         // aligned add operand
+  localparam integer MW   = AW + 1;                  // exact result (AW+1 >= 2*FRAC+2)
+  localparam integer K    = FRAC + 2;                // pre-shift: right shifts only
+  localparam [SYSTEM-1:0] QNAN = {1'b0, {EXP{1'b1}}, 1'b1, {FRAC-1{1'b0}}};
+
+  // position of the leading one (v != 0)
+  function integer msb(input [MW-1:0] v);
+    integer i;
+    begin
+      msb = 0;
+      for (i = 0; i < MW; i = i + 1)
+        if (v[i]) msb = i;
+    end
+  endfunction
+
+  reg             sa, sb, sr;
+  reg [EXP-1:0]   ea, eb;
+  reg [FRAC-1:0]  fa, fb;
+  reg             a_nan, b_nan, a_inf, b_inf, a_zero, b_zero, a_snan, b_snan;
+  reg [FRAC:0]    siga, sigb;                        // with the hidden bit
+  integer         xa, xb;                            // exponent, 1 for subnormals
+  reg [AW-1:0]    alga, algb;                        // sig << (x - 1)
+  reg [MW-1:0]    m;                                 // exact result = m * 2^(e - BIAS - FRAC)
+  integer         e, l, sh, t, ef;
+  reg [MW+K-1:0]  mx, low;
+  reg [FRAC+1:0]  kept, kr;
+  reg [FRAC:0]    kept_n;
+  reg             guard, sticky, guard_n, tiny, ovf, inx;
+
+  always @* begin
+    sa = a[SYSTEM-1];  ea = a[SYSTEM-2:FRAC];  fa = a[FRAC-1:0];
+    sb = b[SYSTEM-1];  eb = b[SYSTEM-2:FRAC];  fb = b[FRAC-1:0];
+    if (op == 2'b01) sb = !sb;                       // a - b = a + (-b)
+
+    a_nan  = ea == EMAX && fa != 0;   b_nan  = eb == EMAX && fb != 0;
+    a_inf  = ea == EMAX && fa == 0;   b_inf  = eb == EMAX && fb == 0;
+    a_zero = ea == 0 && fa == 0;      b_zero = eb == 0 && fb == 0;
+    a_snan = a_nan && !fa[FRAC-1];    b_snan = b_nan && !fb[FRAC-1];
+
+    siga = {ea != 0, fa};             sigb = {eb != 0, fb};
+    xa   = (ea == 0) ? 1 : ea;        xb   = (eb == 0) ? 1 : eb;
+
+    // ---------- Exact result ----------
+    sr = sa;
+    m  = 0;
+    e  = 1;
+    if (!op[1]) begin
+      alga = siga << (xa - 1);
+      algb = sigb << (xb - 1);
+      if (sa == sb)
+        m = alga + algb;
+      else if (alga >= algb) begin
+        m = alga - algb;
+        sr = (m == 0) ? 1'b0 : sa;                   // x - x = +0
+      end else begin
+        m = algb - alga;
+        sr = sb;
+      end
+    end else begin
+      m  = siga * sigb;
+      e  = xa + xb - BIAS - FRAC;
+      sr = sa ^ sb;
+    end
+
+    // ---------- Rounding ----------
+    // keep bits from l - FRAC up (normal) or from 1 - e up (subnormal);
+    // mx = m << K so that t = sh + K >= 2 is always a right shift
+    l  = msb(m);
+    sh = (l - FRAC > 1 - e) ? l - FRAC : 1 - e;
+    t  = sh + K;
+    mx = {{K{1'b0}}, m} << K;
+    low = ({{MW+K-1{1'b0}}, 1'b1} << (t - 1)) - 1;
+    kept   = mx >> t;
+    guard  = mx[t - 1];
+    sticky = (mx & low) != 0;
+    kr = kept + (guard && (sticky || kept[0]));
+    ef = kr[FRAC+1] ? e + sh + 1 : kr[FRAC] ? e + sh : 0;
+
+    // tiny after rounding: below 2^EMIN unless the exponent before rounding
+    // is EMIN-1 and FRAC+1 bits at that exponent round up to 2^EMIN
+    kept_n  = mx >> (t - 1);
+    guard_n = mx[t - 2];
+    tiny = (l + e - FRAC < 0) || (l + e - FRAC == 0 && !(&kept_n && guard_n));
+
+    inx = guard || sticky;
+    ovf = ef >= EMAX;
+
+    // ---------- Result ----------
+    flags = 5'b0;
+    if (op == 2'b11) begin
+      y = 0;
+    end else if (a_nan || b_nan) begin
+      y = QNAN;
+      flags[4] = a_snan || b_snan;
+    end else if ((!op[1] && a_inf && b_inf && sa != sb) ||
+                 (op[1] && ((a_inf && b_zero) || (a_zero && b_inf)))) begin
+      y = QNAN;
+      flags[4] = 1'b1;
+    end else if (a_inf || b_inf) begin
+      y = {op[1] ? sa ^ sb : a_inf ? sa : sb, {EXP{1'b1}}, {FRAC{1'b0}}};
+    end else if (m == 0) begin
+      y = {op[1] ? sa ^ sb : sa && sb, {SYSTEM-1{1'b0}}};
+    end else if (ovf) begin
+      y = {sr, {EXP{1'b1}}, {FRAC{1'b0}}};
+      flags[2] = 1'b1;
+      flags[0] = 1'b1;
+    end else begin
+      y = {sr, ef[EXP-1:0], kr[FRAC-1:0]};
+      flags[1] = tiny && inx;
+      flags[0] = inx;
+    end
+  end
+endmodule
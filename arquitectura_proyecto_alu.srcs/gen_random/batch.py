@@ -0,0 +1,397 @@
+"""
+Generacion de vectores y calculo de resultados esperados por lotes (numpy).
+
+Version vectorizada de gec_vector.py y compute.py para conjuntos grandes
+(millones de vectores):
+  - los operandos se generan con la misma mezcla de casos que gen_operand,
+    directamente como arrays uint16/uint32 de bits;
+  - los resultados y flags siguen la semantica de calc_flags_ieee, pero la
+    exactitud, el overflow/underflow y los bits tras la mantisa se calculan
+    con enteros y float64 exactos en lugar de Decimal; solo los casos que
+    quedan a menos de 2^-28 de un umbral se resuelven con fractions.Fraction;
+  - el trabajo se reparte en bloques de BLOQUE vectores entre procesos; el
+    bloque k usa la semilla (seed, k), asi que la salida depende solo de la
+    semilla y de n, no del numero de procesos;
+  - los bloques se escriben en orden segun terminan, sin tener el fichero
+    entero en memoria.
+
+La salida de 'esperados' es identica byte a byte a la de compute.py (incluido
+el campo y de bits+1 caracteres que escribe en los underflow con resultado no
+nulo). Los vectores siguen la misma distribucion que gec_vector.py, pero con
+el generador de numpy: no son la misma secuencia.
+
+Uso:
+  python batch.py vectores 16 10000000 data/tb_vectors_16_10000000.mem
+      [--esperados output/tb_expected_output16_10000000.mem] [--seed 1] [-j N]
+  python batch.py esperados data/tb_vectors_16_100000.mem output/tb_expected_output16_100000.mem
+      [--width 16|32] [-j N]
+Las rutas terminadas en .bin usan el formato binario de vecbin.py.
+"""
+import argparse
+import multiprocessing as mp
+import os
+from fractions import Fraction
+
+import numpy as np
+
+import vecbin
+
+BLOQUE = 1 << 18
+
+MANT = {16: 10, 32: 23}
+BIAS = {16: 15, 32: 127}
+UINT = {16: np.uint16, 32: np.uint32}
+FLOAT = {16: np.float16, 32: np.float32}
+
+INVALID, DIV0, OVF, UNF, INX = 16, 8, 4, 2, 1
+
+# cerca de los umbrales la aproximacion float64 no basta (la division tiene
+# un error relativo < 2^-31): esos casos se comprueban con Fraction
+TOLERANCIA = 2.0 ** -28
+
+
+# --- Generacion ---
+def generar_operandos(rng, n, bits=16):
+    """Version vectorizada de gec_vector.gen_operand: n operandos como bits"""
+    m, ut = MANT[bits], UINT[bits]
+    p = rng.random(n) * 100
+    val = rng.uniform(-10, 10, n)  # 87.5% valores normales entre -10 y 10
+
+    tiny = (p >= 2.5) & (p < 7.5)  # 5% underflow / denormales
+    val[tiny] = rng.uniform(-1e-6, 1e-6, int(tiny.sum()))
+
+    big = (p >= 7.5) & (p < 12.5)  # 5% overflow / ±Inf o cercanos
+    k = int(big.sum())
+    lo, hi = (3e38, 3.4e38) if bits == 32 else (6e4, 6.55e4)
+    v = np.where(rng.random(k) < 0.5, np.inf, rng.uniform(lo, hi, k))
+    val[big] = np.where(rng.random(k) < 0.5, -v, v)
+
+    with np.errstate(over='ignore'):
+        out = val.astype(FLOAT[bits]).view(ut)
+
+    nan = p < 1.25  # 1.25% NaN con signo y mantisa aleatorios
+    k = int(nan.sum())
+    exp = ((1 << (bits - 1 - m)) - 1) << m
+    out[nan] = (rng.integers(0, 2, k) << (bits - 1)) | exp | rng.integers(1, 1 << m, k)
+
+    out[(p >= 1.25) & (p < 2.5)] = 0  # 1.25% exactos 0
+    return out
+
+
+def _bloque_vectores(args):
+    seed, k, n, bits, con_esperados = args
+    rng = np.random.default_rng([seed, k])
+    op = rng.integers(0, 4, n).astype(UINT[bits])
+    a = generar_operandos(rng, n, bits)
+    b = generar_operandos(rng, n, bits)
+    return a, b, op, calcular_esperados(a, b, op, bits) if con_esperados else None
+
+
+# --- Resultados esperados ---
+def _descomponer(u, bits):
+    """bits -> (M, e) enteros con valor = M * 2^e (solo finitos)"""
+    m = MANT[bits]
+    u = u.astype(np.int64)
+    ex = (u >> m) & ((1 << (bits - 1 - m)) - 1)
+    fr = u & ((1 << m) - 1)
+    mant = np.where(ex == 0, fr, fr | (1 << m))
+    return mant, np.maximum(ex, 1) - BIAS[bits] - m
+
+
+def _bitlen(v):
+    # exacto mientras v < 2^53
+    return np.frexp(v.astype(np.float64))[1].astype(np.int64)
+
+
+def _valor_exacto(u, bits):
+    mant, e = _descomponer(np.array([u]), bits)
+    sign = -1 if (int(u) >> (bits - 1)) & 1 else 1
+    return sign * Fraction(int(mant[0])) * Fraction(2) ** int(e[0])
+
+
+def _exacto(a, b, op, bits):
+    x, y = _valor_exacto(a, bits), _valor_exacto(b, bits)
+    return (x + y, x - y, x * y, x / y)[int(op)]
+
+
+def _umbrales(bits):
+    # los mismos que compute.py: Decimal(str(np.finfo(ftype).max/.tiny))
+    info = np.finfo(FLOAT[bits])
+    return Fraction(str(info.max)), Fraction(str(info.tiny))
+
+
+def calcular_esperados(a, b, op, bits=16):
+    """
+    Version vectorizada de compute.calc_flags_ieee.
+
+    a, b: arrays de bits (uint16/uint32); op: array de 0..3
+    Devuelve (y, flags, signo): arrays de enteros. flags en orden
+    invalid, div0, ovf, unf, inx (bit 4..0). signo vale -1 salvo en las filas
+    en que calc_flags_ieee escribe f"{sign_bit}" + "0"*bits (underflow con
+    resultado no nulo); ahi es ese sign_bit e y = 0, que es lo que leen los
+    testbenches al quedarse con los 'bits' bits bajos.
+    """
+    m, ut, ft = MANT[bits], UINT[bits], FLOAT[bits]
+    p = m + 1
+    a = np.asarray(a).astype(ut)
+    b = np.asarray(b).astype(ut)
+    op = np.asarray(op).astype(np.int64)
+    n = len(a)
+    fa, fb = a.view(ft), b.view(ft)
+
+    # resultado redondeado de numpy (el r_np de calc_flags_ieee)
+    with np.errstate(all='ignore'):
+        da, db = fa.astype(np.float64), fb.astype(np.float64)
+        r = np.select([op == 0, op == 1, op == 2], [fa + fb, fa - fb, fa * fb], fa / fb)
+    rbits = r.view(ut).astype(np.int64)
+    r64 = r.astype(np.float64)
+
+    y = rbits.copy()
+    flags = np.zeros(n, np.int64)
+    signo = np.full(n, -1, np.int64)
+    hecho = np.zeros(n, bool)
+
+    def fijar(mask, valor, fl):
+        # primera regla que se cumple, como los return de calc_flags_ieee
+        mask = mask & ~hecho
+        y[mask] = valor[mask] if isinstance(valor, np.ndarray) else valor
+        flags[mask] = fl
+        hecho[mask] = True
+
+    qnan = int(np.array(np.nan, ft).view(ut))
+    inf = ((1 << (bits - 1 - m)) - 1) << m
+    sa, sb = np.signbit(fa), np.signbit(fb)
+    nan_a, nan_b = np.isnan(fa), np.isnan(fb)
+    inf_a, inf_b = np.isinf(fa), np.isinf(fb)
+    cero_a, cero_b = da == 0, db == 0
+    add, sub, mul, div = op == 0, op == 1, op == 2, op == 3
+
+    # --- casos especiales por operandos ---
+    fijar(nan_a | nan_b, qnan, INVALID)
+    fijar(div & cero_b & cero_a, qnan, INVALID)
+    fijar(div & cero_b, np.where(sa ^ sb, inf | 1 << (bits - 1), inf), DIV0 | INX)
+    fijar(div & inf_a & inf_b, qnan, INVALID)
+    fijar(add & inf_a & inf_b & (sa != sb), qnan, INVALID)
+    fijar(sub & inf_a & inf_b & (sa == sb), qnan, INVALID)
+    fijar(mul & ((cero_a & inf_b) | (cero_b & inf_a)), qnan, INVALID)
+    # con un infinito el resultado exacto es infinito (overflow), salvo x/inf = 0
+    fijar((inf_a | inf_b) & ~(div & inf_b), rbits, OVF | INX)
+    finito = ~(hecho | inf_b)
+
+    # --- resultado exacto: aproximacion x = |exacto| en float64 ---
+    # suma/resta: TwoSum, s + t es exacto; producto: exacto en float64;
+    # division: Q = floor(Ma * 2^32 / Mb) con mantisas normalizadas, resto R
+    with np.errstate(all='ignore'):
+        db_s = np.where(sub, -db, db)
+        s = da + db_s
+        bb = s - da
+        t = (da - (s - bb)) + (db_s - bb)
+
+    ma, ea = _descomponer(a, bits)
+    mb, eb = _descomponer(b, bits)
+    prod = ma * mb
+
+    na = np.where(ma > 0, p - _bitlen(ma), 0)
+    nb = np.where(mb > 0, p - _bitlen(mb), 0)
+    den = np.where(div & finito & (mb > 0), mb << nb, 1)
+    q, rem = np.divmod((ma << na) << 32, den)
+    e_div = (ea - na) - (eb - nb) - 32
+
+    with np.errstate(all='ignore'):
+        x = np.where(mul, np.ldexp(prod.astype(np.float64), ea + eb),
+                     np.where(div, np.ldexp(q.astype(np.float64), e_div), np.abs(s)))
+    x = np.where(finito, x, 0.0)
+    exacto_es_r = np.where(mul | div, (x == np.abs(r64)) & (rem == 0), (t == 0) & (s == r64))
+    cero = x == 0
+
+    # --- overflow / underflow respecto a los umbrales de compute.py ---
+    tmax, ttiny = _umbrales(bits)
+    over = x > float(tmax)
+    under = ~cero & (x < float(ttiny))
+    dudoso = finito & ((np.abs(x - float(tmax)) <= float(tmax) * TOLERANCIA) |
+                       (np.abs(x - float(ttiny)) <= float(ttiny) * TOLERANCIA))
+    for i in np.flatnonzero(dudoso):
+        ex = abs(_exacto(a[i], b[i], op[i], bits))
+        over[i] = ex > tmax
+        under[i] = ex != 0 and ex < ttiny
+
+    fijar(finito & over, rbits, OVF | INX)
+    fijar(finito & under & (r64 == 0), rbits, UNF | INX)
+
+    # --- inexacto: el redondeo pierde bits, o en mul/div alguno de los 5 bits
+    # siguientes a la mantisa del resultado exacto es 1 ---
+    v = np.where(div, q, prod)
+    sh = _bitlen(v) - p - 5
+    extra = np.where(sh >= 0, v >> np.maximum(sh, 0), v << np.maximum(-sh, 0)) & 31
+    inx = ~exacto_es_r | ((mul | div) & ~cero & (extra != 0))
+
+    resto = ~hecho
+    flags[resto] = np.where(under, UNF, 0)[resto] | inx[resto]
+
+    # bit de signo que calc_flags_ieee antepone a los ceros de underflow
+    sga, sgb = a.astype(np.int64) >> (bits - 1), b.astype(np.int64) >> (bits - 1)
+    mag = (1 << (bits - 1)) - 1
+    mayor = (a & mag) >= (b & mag)
+    sign_bit = np.select([add, sub], [np.where((sga == sgb) | mayor, sga, sgb),
+                                      np.where(mayor, sga, 1 - sga)], sga ^ sgb)
+    unf = resto & under
+    y[unf] = 0
+    signo[unf] = sign_bit[unf]
+    return y, flags, signo
+
+
+# --- Lectura de vectores ---
+def _abrir_vectores(path, validar=True):
+    """
+    (width, filas) con las filas mapeadas en memoria: registros de vecbin o
+    lineas de un .mem de ancho fijo. None si el texto no es de ancho fijo.
+    """
+    if vecbin.is_bin(path):
+        kind, width, recs = vecbin.read_bin(path)
+        if kind != vecbin.KIND_VECTORS:
+            raise ValueError(f"{path}: no contiene vectores")
+        return width, recs
+    if os.path.getsize(path) == 0:
+        return None
+    raw = np.memmap(path, np.uint8, mode='r')
+    campos = bytes(raw[:80]).split(b'\n', 1)[0].split()
+    width = len(campos[0])
+    ancho = 2 * width + 5
+    if len(campos) != 3 or width not in (16, 32) or raw.size % ancho:
+        return None
+    filas = raw.reshape(-1, ancho)
+    if validar and ((filas[:, -1] != ord('\n')).any() or (filas[:, width] != ord(' ')).any()
+            or (filas[:, 2 * width + 1] != ord(' ')).any()):
+        return None
+    return width, filas
+
+
+def _campos(filas, width):
+    if filas.dtype.names:
+        return filas['a'], filas['b'], filas['op']
+    d = np.asarray(filas) - np.uint8(ord('0'))
+    if (d[:, :width] > 1).any() or (d[:, width + 1:2 * width + 1] > 1).any() or (d[:, -3:-1] > 1).any():
+        raise ValueError("caracter distinto de 0/1 en un vector")
+
+    def valor(cols):
+        return (cols.astype(np.int64) << np.arange(cols.shape[1] - 1, -1, -1)).sum(axis=1)
+
+    return valor(d[:, :width]), valor(d[:, width + 1:2 * width + 1]), valor(d[:, -3:-1])
+
+
+def _bloque_esperados(args):
+    path, lo, hi, width = args[:4]
+    if path is None:  # texto sin ancho fijo: el bloque ya viene parseado
+        a, b, op = args[4:]
+    else:
+        a, b, op = _campos(_abrir_vectores(path, validar=False)[1][lo:hi], width)
+    return calcular_esperados(a, b, op, width)
+
+
+# --- Escritura ---
+def _texto(columnas, signo=None):
+    """columnas: [(valores, nbits)] -> lineas '0101 11\\n' como bytes"""
+    partes = []
+    if signo is not None:
+        # caracter extra delante de y en las filas de underflow; 0 = ninguno
+        partes.append(np.where(signo < 0, 0, signo + ord('0')).astype(np.uint8)[:, None])
+    for i, (vals, nb) in enumerate(columnas):
+        sh = np.arange(nb - 1, -1, -1, dtype=np.uint64)
+        partes.append((((np.asarray(vals).astype(np.uint64)[:, None] >> sh) & 1) + ord('0')).astype(np.uint8))
+        sep = ord('\n') if i == len(columnas) - 1 else ord(' ')
+        partes.append(np.full((len(vals), 1), sep, np.uint8))
+    out = np.hstack(partes).ravel()
+    return (out[out != 0] if signo is not None else out).tobytes()
+
+
+class _Salida:
+    def __init__(self, path, kind, width, count):
+        self.kind, self.width = kind, width
+        self.bin = path.endswith('.bin')
+        self.f = open(path, 'wb')
+        if self.bin:
+            vecbin.write_header(self.f, kind, width, count)
+
+    def escribir(self, valores, signo=None):
+        if self.bin:
+            rec = np.empty(len(valores[0]), dtype=vecbin.record_dtype(self.kind, self.width))
+            for campo, v in zip(vecbin.FIELDS[self.kind], valores):
+                rec[campo] = v
+            rec.tofile(self.f)
+        else:
+            bits = vecbin.TEXT_BITS[self.kind](self.width)
+            self.f.write(_texto(list(zip(valores, bits)), signo))
+
+    def close(self):
+        self.f.close()
+
+
+def _mapa(fn, tareas, procesos):
+    # imap conserva el orden: cada bloque se escribe en cuanto estan los anteriores
+    if procesos == 1:
+        yield from map(fn, tareas)
+        return
+    with mp.Pool(procesos) as pool:
+        yield from pool.imap(fn, tareas)
+
+
+# Vectores (y opcionalmente sus esperados) en bloques con semilla (seed, k)
+def generar_vectores_lote(n, bits=16, archivo='vectors.mem', esperados=None, seed=1, procesos=None):
+    procesos = procesos or os.cpu_count()
+    tareas = [(seed, k, min(BLOQUE, n - k * BLOQUE), bits, esperados is not None)
+              for k in range((n + BLOQUE - 1) // BLOQUE)]
+    fv = _Salida(archivo, vecbin.KIND_VECTORS, bits, n)
+    fe = _Salida(esperados, vecbin.KIND_EXPECTED, bits, n) if esperados else None
+    for a, b, op, esp in _mapa(_bloque_vectores, tareas, procesos):
+        fv.escribir((a, b, op))
+        if fe:
+            fe.escribir(esp[:2], esp[2])
+    fv.close()
+    if fe:
+        fe.close()
+    print(f"✅ Archivo {archivo} generado con {n} vectores de {bits} bits (seed {seed})"
+          + (f" y {esperados} con sus resultados" if esperados else ""))
+
+
+# Resultados esperados de un fichero de vectores (texto o .bin)
+# width: ancho de un .mem que no es de ancho fijo (por defecto, el de su nombre)
+def generar_output_lote(input_file, output_file, procesos=None, width=None):
+    procesos = procesos or os.cpu_count()
+    abierto = _abrir_vectores(input_file)
+    if abierto is None:
+        _, width, recs = vecbin.read_text(input_file, width)
+        n = len(recs)
+        tareas = [(None, lo, lo + BLOQUE, width, recs['a'][lo:lo + BLOQUE],
+                   recs['b'][lo:lo + BLOQUE], recs['op'][lo:lo + BLOQUE]) for lo in range(0, n, BLOQUE)]
+    else:
+        width, filas = abierto
+        n = len(filas)
+        tareas = [(input_file, lo, min(lo + BLOQUE, n), width) for lo in range(0, n, BLOQUE)]
+    fe = _Salida(output_file, vecbin.KIND_EXPECTED, width, n)
+    for y, flags, signo in _mapa(_bloque_esperados, tareas, procesos):
+        fe.escribir((y, flags), signo)
+    fe.close()
+    print(f"✅ Archivo {output_file} generado con resultado y flags ({width} bits)")
+
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser(description="vectores y esperados de la ALU por lotes")
+    sub = ap.add_subparsers(dest='modo', required=True)
+    v = sub.add_parser('vectores', help="genera n vectores")
+    v.add_argument('bits', type=int, choices=(16, 32))
+    v.add_argument('n', type=int)
+    v.add_argument('archivo')
+    v.add_argument('--esperados', help="escribe tambien los resultados esperados")
+    v.add_argument('--seed', type=int, default=1)
+    e = sub.add_parser('esperados', help="resultados esperados de un fichero de vectores")
+    e.add_argument('vectores')
+    e.add_argument('archivo')
+    e.add_argument('--width', type=int, choices=(16, 32),
+                   help="ancho de los vectores si el .mem no es de ancho fijo (por defecto, el de su nombre)")
+    for p in (v, e):
+        p.add_argument('-j', type=int, default=None, help="procesos (por defecto, todos los nucleos)")
+    args = ap.parse_args()
+    if args.modo == 'vectores':
+        generar_vectores_lote(args.n, args.bits, args.archivo, args.esperados, args.seed, args.j)
+    else:
+        generar_output_lote(args.vectores, args.archivo, args.j, args.width)
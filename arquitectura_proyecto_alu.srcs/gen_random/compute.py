@@ -1,6 +1,8 @@
 import numpy as np
 from decimal import Decimal, getcontext, InvalidOperation
 
+import vecbin
+
 
 # --- Conversión binario ↔ float ---
 def bits_to_float(bits, bitsz=16):
@@ -324,15 +326,15 @@ def calc_flags_ieee(a_bits, b_bits, op, bits=16, ext_bits=5):
     elif ovf:
         # ±Infinity
         if bits == 16:
-            bits_result = f"{sign_bit}1111100000000000"
+            bits_result = f"{sign_bit}111110000000000"
         else:
-            bits_result = f"{sign_bit}11111111000000000000000000000000"
+            bits_result = f"{sign_bit}1111111100000000000000000000000"
     elif unf:
         # ±Zero
         if bits == 16:
-            bits_result = f"{sign_bit}0000000000000000"
+            bits_result = f"{sign_bit}000000000000000"
         else:
-            bits_result = f"{sign_bit}00000000000000000000000000000000"
+            bits_result = f"{sign_bit}0000000000000000000000000000000"
     else:
         # Valor normal, solo convertir a bits IEEE
         bits_result = float_to_bits(final_typed, bits)
@@ -342,16 +344,26 @@ def calc_flags_ieee(a_bits, b_bits, op, bits=16, ext_bits=5):
 
 
 # --- Generador de archivo de salida ---
+# input_file/output_file pueden ser .mem de texto o .bin (formato de vecbin.py)
 def generar_output(input_file='tb_vectors_input.mem', output_file='tb_expected.mem', bits=16):
-    with open(input_file, 'r') as fin, open(output_file, 'w') as fout:
-        for i, line in enumerate(fin):
-            parts = line.strip().split()
-            if len(parts) != 3:
-                continue
-
-            a_bin, b_bin, op = parts
-            r, flags = calc_flags_ieee(a_bin, b_bin, op, bits=len(a_bin))
-            fout.write(f"{r} {flags}\n")
+    if vecbin.is_bin(input_file):
+        _, w, recs = vecbin.read_bin(input_file)
+        vectores = ((format(int(a), f'0{w}b'), format(int(b), f'0{w}b'), format(int(op), '02b'))
+                    for a, b, op in recs)
+    else:
+        with open(input_file, 'r') as fin:
+            vectores = [tuple(l.split()) for l in fin if len(l.split()) == 3]
+
+    resultados = [calc_flags_ieee(a_bin, b_bin, op, bits=len(a_bin)) for a_bin, b_bin, op in vectores]
+
+    if output_file.endswith('.bin'):
+        vecbin.write_bin(output_file, vecbin.KIND_EXPECTED, bits,
+                         {'y': [int(r, 2) for r, _ in resultados],
+                          'flags': [int(f, 2) for _, f in resultados]})
+    else:
+        with open(output_file, 'w') as fout:
+            for r, flags in resultados:
+                fout.write(f"{r} {flags}\n")
 
     print(f"✅ Archivo {output_file} generado con resultado y flags ({bits} bits)")
 
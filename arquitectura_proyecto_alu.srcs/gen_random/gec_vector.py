@@ -2,6 +2,8 @@ import struct
 import random
 import numpy as np
 
+import vecbin
+
 # Conversión float → binario IEEE (16 o 32 bits)
 def float_to_bin(f, bits=16):
     if bits == 32:
@@ -83,12 +85,17 @@ def gen_vector(bits=16):
 
     return a_bin, b_bin, op_code
 
-# Generar archivo de vectores
+# Generar archivo de vectores (.bin: formato binario de vecbin.py)
 def generar_vectores(n=1000, bits=16, archivo='vectors.mem'):
-    with open(archivo, 'w') as f:
-        for _ in range(n):
-            a, b, op = gen_vector(bits)
-            f.write(f"{a} {b} {op}\n")
+    if archivo.endswith('.bin'):
+        vs = [gen_vector(bits) for _ in range(n)]
+        vecbin.write_bin(archivo, vecbin.KIND_VECTORS, bits,
+                         {campo: [int(v[i], 2) for v in vs] for i, campo in enumerate(('a', 'b', 'op'))})
+    else:
+        with open(archivo, 'w') as f:
+            for _ in range(n):
+                a, b, op = gen_vector(bits)
+                f.write(f"{a} {b} {op}\n")
     print(f"✅ Archivo {archivo} generado con {n} vectores de {bits} bits (sin resultado)")
 
 
@@ -0,0 +1,244 @@
+"""
+Triage de discrepancias de la ALU: agrupa los casos que fallan por causa.
+
+Lee las discrepancias de una o varias ejecuciones y las agrupa por:
+  - formato (16/32) y operacion;
+  - clase de cada operando, como fp16_classifier (zero, denorm, normal,
+    inf, nan);
+  - diferencia de exponentes |ea - eb| (0, 1, 2-3, 4-7, 8-15, 16+; '-' si
+    algun operando no es finito y distinto de cero);
+  - como difiere y: signo, distancia en ulps (1, 2-3, 4-15, 16-1023,
+    1024+), infinito o NaN frente a un numero, payload del NaN;
+  - que flags difieren: +bit si el RTL lo activa de mas, -bit si le falta.
+Cada grupo se resume con un caso representativo minimo (el que tiene menos
+bits distintos en y y flags y, a igualdad, los operandos con menos bits a
+uno), y el informe lista los grupos de mayor a menor con histogramas por
+operacion, clases, diferencia de y y flag.
+
+Entradas:
+  log       salidas de tb_alu_frandom16/32 (Vivado, Icarus o sim_1/regresion.py),
+            de verilator/sim_alu, de tb_alu_dpi y las primeras discrepancias
+            de verilator/sim_alu_sweep; se pueden mezclar varios ficheros
+  volcado   vectores, esperados y obtenidos (resultados del RTL, p. ej.
+            sim_alu --dump), en texto .mem o binario (vecbin.py)
+
+Uso:
+  python triage.py log sim_alu.log tb_alu_frandom16.log [--top 20] [--json informe.json]
+  python triage.py volcado data/tb_vectors_16_100000.mem output/tb_expected_output16_100000.mem obtenidos.bin
+      [--width 16|32]
+Los .mem de texto no guardan el ancho: se toma de --width, del nombre del
+fichero de vectores (vecbin.width_from_name) o de su cabecera si es .bin.
+"""
+import argparse
+import json
+import re
+import sys
+from collections import Counter
+
+import numpy as np
+
+import vecbin
+
+MANT = {16: 10, 32: 23}
+OPS = ("add", "sub", "mul", "div")
+FLAGS = ("invalid", "div0", "ovf", "unf", "inx")  # ALUFlags[4:0]
+
+CASO = re.compile(r"Caso (\d+): a_str=\s*([01]+), b_str=\s*([01]+), op_str=\s*([01]+)")
+MISMATCH = re.compile(r"Mismatch en caso (\d+):(?:\s*a=([01]+) b=([01]+) op=([01]+))?")
+MISMATCH_DPI = re.compile(r"Mismatch seed=(\d+) index=(\d+): a=(\w+) b=(\w+) op=([01]+)")
+ESPERADO = re.compile(r"Esperado: y=(\w+), flags=([01]+)")
+OBTENIDO = re.compile(r"Obtenido: y=(\w+), flags=([01]+)")
+SWEEP = re.compile(r"^\s*(add|sub|mul|div) ([0-9a-f]{4}) ([0-9a-f]{4}) ([0-9a-f]{6}) ([0-9a-f]{6})\s*$")
+
+
+# --- Lectura ---
+def leer_log(ruta, casos):
+    """Anade a 'casos' las discrepancias de un log: (origen, w, a, b, op, ey, ef, gy, gf)"""
+    operandos = {}  # caso -> (a, b, op) de tb_alu_frandom, que los imprime antes
+    actual = None   # [origen, base, a, b, op, ey, ef, w]
+    ilegibles = 0
+    with open(ruta, encoding="utf-8", errors="replace") as f:
+        for linea in f:
+            if m := CASO.search(linea):
+                operandos[m.group(1)] = (m.group(2), m.group(3), m.group(4))
+            elif m := MISMATCH_DPI.search(linea):
+                actual = [f"seed={m.group(1)} index={m.group(2)}", 16, m.group(3), m.group(4), m.group(5)]
+            elif m := MISMATCH.search(linea):
+                ops = m.group(2, 3, 4) if m.group(2) else operandos.get(m.group(1))
+                actual = [f"{ruta}:caso {m.group(1)}", 2] + list(ops) if ops else None
+                ilegibles += ops is None
+            elif (m := ESPERADO.search(linea)) and actual:
+                actual[5:] = [m.group(1), m.group(2)]
+            elif (m := OBTENIDO.search(linea)) and actual and len(actual) == 7:
+                origen, base, a, b, op, ey, ef = actual
+                actual = None
+                try:
+                    w = len(ey) * (4 if base == 16 else 1)
+                    casos.append((origen, w, int(a, base), int(b, base), int(op, 2), int(ey, base),
+                                  int(ef, 2), int(m.group(1), base), int(m.group(2), 2)))
+                except ValueError:  # x/z en la salida del simulador
+                    ilegibles += 1
+            elif m := SWEEP.match(linea):
+                got, exp = int(m.group(4), 16), int(m.group(5), 16)
+                casos.append((f"{ruta}:sweep", 16, int(m.group(2), 16), int(m.group(3), 16),
+                              OPS.index(m.group(1)), exp >> 5, exp & 31, got >> 5, got & 31))
+    return ilegibles
+
+
+def leer_volcado(ruta_v, ruta_e, ruta_o, width=None):
+    """Discrepancias entre esperados y obtenidos de un mismo fichero de vectores"""
+    kv, w, vec = vecbin.read_any(ruta_v, width)
+    ke, we, esp = vecbin.read_any(ruta_e, w)
+    ko, wo, obt = vecbin.read_any(ruta_o, w)
+    if (kv, ke, ko) != (vecbin.KIND_VECTORS, vecbin.KIND_EXPECTED, vecbin.KIND_EXPECTED) or not w == we == wo:
+        raise ValueError("se esperan vectores, esperados y obtenidos del mismo ancho")
+    if not len(vec) == len(esp) == len(obt):
+        raise ValueError(f"{len(vec)} vectores, {len(esp)} esperados y {len(obt)} obtenidos")
+    malos = np.nonzero((esp['y'] != obt['y']) | (esp['flags'] != obt['flags']))[0]
+    return [(f"{ruta_v}:caso {i + 1}", w, int(vec['a'][i]), int(vec['b'][i]), int(vec['op'][i]),
+             int(esp['y'][i]), int(esp['flags'][i]), int(obt['y'][i]), int(obt['flags'][i]))
+            for i in malos]
+
+
+# --- Clasificacion ---
+def clase(v, w):
+    m = MANT[w]
+    e, man, emax = (v >> m) & ((1 << (w - 1 - m)) - 1), v & ((1 << m) - 1), (1 << (w - 1 - m)) - 1
+    if e == 0:
+        return "zero" if man == 0 else "denorm"
+    if e == emax:
+        return "inf" if man == 0 else "nan"
+    return "normal"
+
+
+def dif_exponentes(a, b, w):
+    ca, cb = clase(a, w), clase(b, w)
+    if ca not in ("normal", "denorm") or cb not in ("normal", "denorm"):
+        return "-"
+    m = MANT[w]
+    emask = (1 << (w - 1 - m)) - 1
+    d = abs(max((a >> m) & emask, 1) - max((b >> m) & emask, 1))
+    for limite, nombre in ((0, "0"), (1, "1"), (3, "2-3"), (7, "4-7"), (15, "8-15")):
+        if d <= limite:
+            return nombre
+    return "16+"
+
+
+def dif_y(ey, gy, w):
+    if ey == gy:
+        return "y igual"
+    signo = 1 << (w - 1)
+    ce, cg = clase(ey, w), clase(gy, w)
+    if ce == "nan" and cg == "nan":
+        return "payload NaN"
+    if "nan" in (ce, cg):
+        return "NaN vs numero"
+    if (ey ^ gy) == signo:
+        return "signo"
+    if (ey ^ gy) & signo:
+        return "signo y magnitud"
+    if "inf" in (ce, cg):
+        return "inf vs finito"
+    d = abs((ey & ~signo) - (gy & ~signo))  # |y| crece con su codificacion
+    for limite, nombre in ((1, "1 ulp"), (3, "2-3 ulp"), (15, "4-15 ulp"), (1023, "16-1023 ulp")):
+        if d <= limite:
+            return nombre
+    return "1024+ ulp"
+
+
+def dif_flags(ef, gf):
+    partes = [("+" if (gf >> i) & 1 else "-") + FLAGS[4 - i] for i in range(4, -1, -1) if ((ef ^ gf) >> i) & 1]
+    return " ".join(partes) or "-"
+
+
+def agrupar(casos):
+    grupos = {}
+    for c in casos:
+        origen, w, a, b, op, ey, ef, gy, gf = c
+        clave = (w, OPS[op & 3], clase(a, w), clase(b, w), dif_exponentes(a, b, w),
+                 dif_y(ey, gy, w), dif_flags(ef, gf))
+        # representante: menos bits distintos, luego operandos mas simples
+        peso = (bin(ey ^ gy).count("1") + bin(ef ^ gf).count("1"), bin(a).count("1") + bin(b).count("1"))
+        g = grupos.setdefault(clave, {"n": 0, "peso": None, "caso": None})
+        g["n"] += 1
+        if g["peso"] is None or peso < g["peso"]:
+            g["peso"], g["caso"] = peso, c
+    return sorted(grupos.items(), key=lambda kv: (-kv[1]["n"], kv[0]))
+
+
+# --- Informe ---
+def describir(c):
+    origen, w, a, b, op, ey, ef, gy, gf = c
+    h = w // 4
+    return (f"{origen}: a={a:0{h}x} b={b:0{h}x} op={op:02b} esperado y={ey:0{h}x} flags={ef:05b}, "
+            f"obtenido y={gy:0{h}x} flags={gf:05b}")
+
+
+def histograma(titulo, cuenta, total, ancho=40):
+    print(f"\n{titulo}")
+    for k, n in cuenta.most_common():
+        barra = "#" * max(1, round(ancho * n / total))
+        print(f"  {k:<22} {n:>8} {100.0 * n / total:6.2f} %  {barra}")
+
+
+def informe(casos, top):
+    grupos = agrupar(casos)
+    total = len(casos)
+    print(f"🔸 {total} discrepancias en {len(grupos)} grupos\n")
+    print(f"  {'#':>3} {'casos':>8} {'%':>7}  {'fmt':<3} {'op':<4} {'a':<6} {'b':<6} {'|dexp|':<6} "
+          f"{'y':<16} flags")
+    for i, (k, g) in enumerate(grupos[:top], 1):
+        w, op, ca, cb, de, dy, df = k
+        print(f"  {i:>3} {g['n']:>8} {100.0 * g['n'] / total:6.2f}%  {w:<3} {op:<4} {ca:<6} {cb:<6} "
+              f"{de:<6} {dy:<16} {df}")
+        print(f"      {describir(g['caso'])}")
+    if len(grupos) > top:
+        print(f"  ... {len(grupos) - top} grupos mas")
+
+    histograma("Por operacion", Counter(f"{c[1]} {OPS[c[4] & 3]}" for c in casos), total)
+    histograma("Por clases de operandos", Counter(f"{clase(c[2], c[1])} x {clase(c[3], c[1])}" for c in casos), total)
+    histograma("Por diferencia en y", Counter(dif_y(c[5], c[7], c[1]) for c in casos), total)
+    bits = Counter()
+    for c in casos:
+        bits.update(p for p in dif_flags(c[6], c[8]).split() if p != "-")
+    if bits:
+        histograma("Por flag (+ de mas, - de menos)", bits, total)
+    return grupos
+
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser(description="triage de discrepancias de la ALU")
+    sub = ap.add_subparsers(dest="modo", required=True)
+    p = sub.add_parser("log", help="logs de los testbenches o de verilator/sim_alu*")
+    p.add_argument("logs", nargs="+")
+    p = sub.add_parser("volcado", help="vectores, esperados y resultados del RTL")
+    p.add_argument("vectores")
+    p.add_argument("esperados")
+    p.add_argument("obtenidos")
+    p.add_argument("--width", type=int, choices=(16, 32),
+                   help="ancho de los .mem de texto (por defecto, el del nombre de los vectores)")
+    for p in sub.choices.values():
+        p.add_argument("--top", type=int, default=20, help="grupos listados (por defecto 20)")
+        p.add_argument("--json", help="grupos y representantes en JSON")
+    args = ap.parse_args()
+
+    casos = []
+    if args.modo == "log":
+        for ruta in args.logs:
+            ilegibles = leer_log(ruta, casos)
+            if ilegibles:
+                print(f"⚠ {ruta}: {ilegibles} discrepancias sin operandos o con x/z, ignoradas")
+    else:
+        casos = leer_volcado(args.vectores, args.esperados, args.obtenidos, args.width)
+    if not casos:
+        print("✅ Sin discrepancias")
+        sys.exit(0)
+
+    grupos = informe(casos, args.top)
+    if args.json:
+        campos = ("width", "op", "class_a", "class_b", "exp_diff", "y_diff", "flags_diff")
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump({"total": len(casos),
+                       "groups": [dict(zip(campos, k), count=g["n"], representative=describir(g["caso"]))
+                                  for k, g in grupos]}, f, indent=2, ensure_ascii=False)
+    sys.exit(1)
@@ -0,0 +1,174 @@
+"""
+Formato binario empaquetado para vectores y resultados esperados.
+
+Los .mem de texto guardan cada bit como un caracter '0'/'1' (37 bytes por
+vector de 16 bits). El formato binario guarda los mismos campos como enteros
+little-endian, con registros de tamaño fijo que se pueden mapear en memoria:
+
+  cabecera (16 bytes)
+    0  magic    b'FPVB'
+    4  version  u8 = 1
+    5  kind     u8 = ord('V') vectores {a, b, op} | ord('E') esperados {y, flags}
+    6  width    u8 = 16 | 32
+    7  reserved u8 = 0
+    8  count    u64, numero de registros
+  registros (desde el byte 16)
+    cada campo ocupa una palabra de 'width' bits (u16 o u32):
+    V: a, b, op        -> 6 bytes (16) / 12 bytes (32)
+    E: y, flags        -> 4 bytes (16) /  8 bytes (32)
+
+El mismo formato lo leen y escriben cpp_model/vectors.hpp (fp_golden,
+verilator/sim_alu*) y este modulo.
+
+Uso como conversor (sin perdidas en ambos sentidos):
+  python vecbin.py to-bin  data/tb_vectors_16_1000.mem data/tb_vectors_16_1000.bin
+  python vecbin.py to-text data/tb_vectors_16_1000.bin data/tb_vectors_16_1000.mem
+  python vecbin.py to-bin  --width 16 cex_esperados.mem cex_esperados.bin
+El tipo (vectores o esperados) se deduce del numero de columnas. Un .mem de
+texto no guarda el ancho: se toma de --width o del nombre del fichero (16 o
+32 como numero aislado: tb_vectors_16_1000.mem, tb_expected_output32_10.mem).
+Un campo con mas bits que su ancho o con caracteres que no son 0/1 es un
+error con su numero de linea: los testbenches se quedarian con los bits bajos
+($sscanf) y el conversor no debe ocultarlo.
+"""
+import argparse
+import os
+import re
+import struct
+import sys
+
+import numpy as np
+
+MAGIC = b'FPVB'
+VERSION = 1
+HEADER = struct.Struct('<4sBBBBQ')
+KIND_VECTORS = ord('V')
+KIND_EXPECTED = ord('E')
+
+FIELDS = {KIND_VECTORS: ('a', 'b', 'op'), KIND_EXPECTED: ('y', 'flags')}
+TEXT_BITS = {KIND_VECTORS: lambda w: (w, w, 2), KIND_EXPECTED: lambda w: (w, 5)}
+
+
+def record_dtype(kind, width):
+    """dtype numpy de un registro (campos de 'width' bits, little-endian)"""
+    t = '<u2' if width == 16 else '<u4'
+    return np.dtype([(f, t) for f in FIELDS[kind]])
+
+
+def is_bin(path):
+    with open(path, 'rb') as f:
+        return f.read(4) == MAGIC
+
+
+def write_bin(path, kind, width, records):
+    """records: array estructurado de record_dtype(kind, width) o dict campo -> array"""
+    if width not in (16, 32):
+        raise ValueError("width debe ser 16 o 32")
+    dt = record_dtype(kind, width)
+    if isinstance(records, dict):
+        n = len(records[FIELDS[kind][0]])
+        arr = np.empty(n, dtype=dt)
+        for f in FIELDS[kind]:
+            arr[f] = records[f]
+    else:
+        arr = np.asarray(records, dtype=dt)
+    with open(path, 'wb') as f:
+        write_header(f, kind, width, len(arr))
+        arr.tofile(f)
+
+
+def write_header(f, kind, width, count):
+    """Cabecera para escribir los registros por partes (arr.tofile(f) a continuacion)"""
+    f.write(HEADER.pack(MAGIC, VERSION, kind, width, 0, count))
+
+
+def read_bin(path):
+    """Devuelve (kind, width, registros) con los registros mapeados en memoria"""
+    with open(path, 'rb') as f:
+        magic, version, kind, width, _, count = HEADER.unpack(f.read(HEADER.size))
+    if magic != MAGIC or version != VERSION or kind not in FIELDS or width not in (16, 32):
+        raise ValueError(f"{path}: no es un fichero FPVB valido")
+    if count == 0:
+        return kind, width, np.empty(0, dtype=record_dtype(kind, width))
+    return kind, width, np.memmap(path, dtype=record_dtype(kind, width), mode='r',
+                                  offset=HEADER.size, shape=(count,))
+
+
+def width_from_name(path):
+    """16 o 32 si aparece como numero aislado en el nombre del fichero, si no None"""
+    found = set(re.findall(r'(?<!\d)(16|32)(?!\d)', os.path.basename(path)))
+    return int(found.pop()) if len(found) == 1 else None
+
+
+def read_text(path, width=None):
+    """Parsea un .mem de texto; devuelve (kind, width, registros)
+
+    width: 16 o 32; por defecto, el del nombre del fichero (width_from_name)
+    """
+    if width is None:
+        width = width_from_name(path)
+        if width is None:
+            raise ValueError(f"{path}: ancho desconocido: indica --width 16|32")
+    if width not in (16, 32):
+        raise ValueError("width debe ser 16 o 32")
+    rows = []
+    kind = None
+    with open(path, 'r') as f:
+        for n, line in enumerate(f, 1):
+            parts = line.split()
+            if not parts:
+                continue
+            if kind is None:
+                kind = KIND_VECTORS if len(parts) == 3 else KIND_EXPECTED
+            bits = TEXT_BITS[kind](width)
+            if len(parts) != len(bits):
+                raise ValueError(f"{path}:{n}: linea mal formada: {line.strip()}")
+            for campo, t, b in zip(FIELDS[kind], parts, bits):
+                if len(t) > b or t.strip('01'):
+                    raise ValueError(f"{path}:{n}: campo {campo} '{t}' no es un binario de {b} bits")
+            rows.append(tuple(int(t, 2) for t in parts))
+    if kind is None:
+        raise ValueError(f"{path}: fichero vacio")
+    return kind, width, np.array(rows, dtype=record_dtype(kind, width))
+
+
+def write_text(path, kind, width, records):
+    bits = TEXT_BITS[kind](width)
+    fmts = [f"{{:0{b}b}}" for b in bits]
+    with open(path, 'w') as f:
+        for r in records:
+            f.write(' '.join(fmt.format(int(v)) for fmt, v in zip(fmts, r)) + "\n")
+
+
+def read_any(path, width=None):
+    """Lee un fichero de vectores o esperados en cualquiera de los dos formatos
+
+    width solo hace falta para el texto (ver read_text); en un .bin manda la
+    cabecera y un width distinto es un error
+    """
+    if not is_bin(path):
+        return read_text(path, width)
+    kind, w, recs = read_bin(path)
+    if width is not None and width != w:
+        raise ValueError(f"{path}: registros de {w} bits, se esperaban {width}")
+    return kind, w, recs
+
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser(description="conversor entre .mem de texto y .bin (FPVB)")
+    ap.add_argument('modo', choices=('to-bin', 'to-text'))
+    ap.add_argument('entrada')
+    ap.add_argument('salida')
+    ap.add_argument('--width', type=int, choices=(16, 32),
+                    help="ancho de un .mem de entrada (por defecto, el de su nombre)")
+    args = ap.parse_args()
+    try:
+        kind, width, recs = read_any(args.entrada, args.width)
+    except ValueError as e:
+        print(f"❌ ERROR: {e}", file=sys.stderr)
+        sys.exit(1)
+    if args.modo == 'to-bin':
+        write_bin(args.salida, kind, width, recs)
+    else:
+        write_text(args.salida, kind, width, recs)
+    print(f"✅ {len(recs)} registros de {width} bits ({chr(kind)}) -> {args.salida}")
@@ -1,27 +1,44 @@
 module aludec(input  opb5,
               input  [2:0] funct3,
-              input  funct7b5, 
+              input  funct7b5, funct7b0,
               input  [1:0] ALUOp,
-              output [2:0] ALUControl);
+              output [3:0] ALUControl,
+              output MulDiv);
   
   wire  RtypeSub; 
-  reg [2:0] ALUControl_reg; 
+  reg [3:0] ALUControl_reg; 
 
   assign RtypeSub = funct7b5 & opb5;  // TRUE for R-type subtract instruction
+
+  // TRUE for RV32M (R-type with funct7 = 0000001), executed by the mdu
+  assign MulDiv = (ALUOp == 2'b10) & opb5 & funct7b0;
   assign ALUControl = ALUControl_reg;
 
   always @* case(ALUOp)
-      2'b00:                ALUControl_reg = 3'b000; // addition
-      2'b01:                ALUControl_reg = 3'b001; // subtraction
+      2'b00:                ALUControl_reg = 4'b0000; // addition
+      2'b01: case(funct3[2:1]) // branches: the controller tests Zero
+               2'b00:   ALUControl_reg = 4'b0001; // beq, bne: subtraction
+               2'b10:   ALUControl_reg = 4'b0101; // blt, bge: slt
+               2'b11:   ALUControl_reg = 4'b1010; // bltu, bgeu: sltu
+               default: ALUControl_reg = 4'bxxxx; // ???
+             endcase
+      2'b11:                ALUControl_reg = 4'b1001; // pass b (lui)
       default: case(funct3) // R-type or I-type ALU
                  3'b000:  if (RtypeSub) 
-                            ALUControl_reg = 3'b001; // sub
+                            ALUControl_reg = 4'b0001; // sub
                           else          
-                            ALUControl_reg = 3'b000; // add, addi
-                 3'b010:    ALUControl_reg = 3'b101; // slt, slti
-                 3'b110:    ALUControl_reg = 3'b011; // or, ori
-                 3'b111:    ALUControl_reg = 3'b010; // and, andi
-                 default:   ALUControl_reg = 3'bxxx; // ???
+                            ALUControl_reg = 4'b0000; // add, addi
+                 3'b001:    ALUControl_reg = 4'b0110; // sll, slli
+                 3'b010:    ALUControl_reg = 4'b0101; // slt, slti
+                 3'b011:    ALUControl_reg = 4'b1010; // sltu, sltiu
+                 3'b100:    ALUControl_reg = 4'b0100; // xor, xori
+                 3'b101:  if (funct7b5)               // funct7b5 is imm[10] for srai
+                            ALUControl_reg = 4'b1000; // sra, srai
+                          else
+                            ALUControl_reg = 4'b0111; // srl, srli
+                 3'b110:    ALUControl_reg = 4'b0011; // or, ori
+                 3'b111:    ALUControl_reg = 4'b0010; // and, andi
+                 default:   ALUControl_reg = 4'bxxxx; // ???
                endcase
     endcase
 endmodule
\ No newline at end of file
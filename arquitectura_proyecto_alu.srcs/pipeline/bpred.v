@@ -0,0 +1,127 @@
+module bpred(input  clk, reset,
+             // fetch side: predict the next PC of the instruction at PCF
+             input  [31:0] PCF,
+             input  CompressedF,
+             output PredTakenF,
+             output [31:0] PredPCF,
+             // resolve side: train with the outcome of the instruction at PCE
+             input  [31:0] PCE, PCNextE, PredPCE,
+             input  CompressedE,
+             input  BranchE, JumpE, JumpRegE,
+             input  [4:0] RdE, Rs1E,
+             output MispredictE,
+             // statistics
+             output [31:0] BranchCount, BranchMiss,
+             output [31:0] JumpCount, JumpMiss);
+
+  // BHT: 2-bit saturating counters, indexed by PC (bimodal) or PC ^ GHR (gshare)
+  // BTB: direct-mapped, full tag, stores the target and the kind of control transfer
+  // RAS: circular return-address stack, pushed by calls and popped by returns
+  //      call   = jal/jalr with rd = x1/x5
+  //      return = jalr with rs1 = x1/x5 and rd != x1/x5
+  // the single-cycle core fetches and resolves in the same cycle (PCF = PCE),
+  // a pipelined core feeds PCE/PredPCE from the execute stage
+  // Compressed*: RV32C instruction, its fall-through is PC+2; the BTB tag
+  // includes PC[1] so the two halves of a word never share an entry
+  parameter GSHARE   = 0; // 0 = bimodal, 1 = gshare
+  parameter BHT_BITS = 6; // 64 counters, also the global history length
+  parameter BTB_BITS = 4; // 16 entries
+  parameter RAS_BITS = 2; // 4 entries
+
+  localparam BHT_SIZE = 1 << BHT_BITS;
+  localparam BTB_SIZE = 1 << BTB_BITS;
+  localparam RAS_SIZE = 1 << RAS_BITS;
+  localparam TAG_BITS = 31 - BTB_BITS;
+
+  // BTB entry kinds
+  localparam BR  = 2'b00; // conditional branch
+  localparam JMP = 2'b01; // jal/jalr, target from the BTB
+  localparam RET = 2'b10; // return, target from the RAS
+
+  reg [1:0]          bht[BHT_SIZE-1:0];
+  reg [BHT_BITS-1:0] ghr;
+
+  reg [BTB_SIZE-1:0] btb_valid;
+  reg [TAG_BITS-1:0] btb_tag[BTB_SIZE-1:0];
+  reg [31:0]         btb_target[BTB_SIZE-1:0];
+  reg [1:0]          btb_kind[BTB_SIZE-1:0];
+
+  reg [31:0]         ras[RAS_SIZE-1:0];
+  reg [RAS_BITS-1:0] ras_top;
+  reg [RAS_BITS:0]   ras_count;
+
+  reg [31:0] BranchCount, BranchMiss, JumpCount, JumpMiss;
+
+  integer i;
+
+  initial begin
+    for (i = 0; i < BHT_SIZE; i = i + 1) bht[i] = 2'b01; // weakly not taken
+  end
+
+  // fetch side
+  wire [BHT_BITS-1:0] bhtidxF = GSHARE ? (PCF[BHT_BITS+1:2] ^ ghr) : PCF[BHT_BITS+1:2];
+  wire [BTB_BITS-1:0] btbidxF = PCF[BTB_BITS+1:2];
+  wire [TAG_BITS-1:0] btbtagF = {PCF[31:BTB_BITS+2], PCF[1]};
+  wire                btbhitF = btb_valid[btbidxF] & (btb_tag[btbidxF] == btbtagF);
+  wire [1:0]          kindF   = btb_kind[btbidxF];
+  wire [31:0]         targetF = (kindF == RET & ras_count != 0) ? ras[ras_top]
+                                                                 : btb_target[btbidxF];
+
+  assign PredTakenF = btbhitF & (kindF != BR | bht[bhtidxF][1]);
+  assign PredPCF    = PredTakenF ? targetF : PCF + (CompressedF ? 2 : 4);
+
+  // resolve side
+  wire [BHT_BITS-1:0] bhtidxE = GSHARE ? (PCE[BHT_BITS+1:2] ^ ghr) : PCE[BHT_BITS+1:2];
+  wire [BTB_BITS-1:0] btbidxE = PCE[BTB_BITS+1:2];
+  wire [TAG_BITS-1:0] btbtagE = {PCE[31:BTB_BITS+2], PCE[1]};
+  wire [31:0]         PCSeqE  = PCE + (CompressedE ? 2 : 4);
+  wire                TakenE  = PCNextE != PCSeqE;
+  wire                RdLink  = (RdE  == 5'd1) | (RdE  == 5'd5);
+  wire                Rs1Link = (Rs1E == 5'd1) | (Rs1E == 5'd5);
+  wire                CallE   = JumpE & RdLink;
+  wire                RetE    = JumpRegE & Rs1Link & ~RdLink;
+
+  assign MispredictE = PredPCE != PCNextE;
+
+  always @(posedge clk or posedge reset) begin
+    if (reset) begin
+      ghr         <= 0;
+      btb_valid   <= 0;
+      ras_top     <= 0;
+      ras_count   <= 0;
+      BranchCount <= 0;
+      BranchMiss  <= 0;
+      JumpCount   <= 0;
+      JumpMiss    <= 0;
+    end else begin
+      if (BranchE) begin
+        BranchCount <= BranchCount + 1;
+        if (MispredictE) BranchMiss <= BranchMiss + 1;
+        ghr <= {ghr[BHT_BITS-2:0], TakenE};
+        if (TakenE & bht[bhtidxE] != 2'b11)       bht[bhtidxE] <= bht[bhtidxE] + 1;
+        else if (~TakenE & bht[bhtidxE] != 2'b00) bht[bhtidxE] <= bht[bhtidxE] - 1;
+      end
+      if (JumpE) begin
+        JumpCount <= JumpCount + 1;
+        if (MispredictE) JumpMiss <= JumpMiss + 1;
+      end
+
+      // allocate taken branches and all jumps
+      if (BranchE & TakenE | JumpE) begin
+        btb_valid[btbidxE]  <= 1'b1;
+        btb_tag[btbidxE]    <= btbtagE;
+        btb_target[btbidxE] <= PCNextE;
+        btb_kind[btbidxE]   <= BranchE ? BR : (RetE ? RET : JMP);
+      end
+
+      if (CallE) begin
+        ras[ras_top + 1'b1] <= PCSeqE;
+        ras_top <= ras_top + 1'b1;
+        if (ras_count != RAS_SIZE) ras_count <= ras_count + 1'b1;
+      end else if (RetE & ras_count != 0) begin
+        ras_top   <= ras_top - 1'b1;
+        ras_count <= ras_count - 1'b1;
+      end
+    end
+  end
+endmodule
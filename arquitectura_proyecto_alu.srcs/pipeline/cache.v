@@ -0,0 +1,119 @@
+module cache(input  clk, reset,
+             // core side: single-cycle on a hit
+             input  re, we,
+             input  [3:0] be,
+             input  [31:0] a, wd,
+             output [31:0] rd, rdn,
+             output hit, miss,
+             // backing memory side (mainmem)
+             output mreq, mwe,
+             output [31:0] ma,
+             output [(32<<LINE_BITS)-1:0] mwline,
+             input  [(32<<LINE_BITS)-1:0] mrline,
+             input  mready,
+             // statistics
+             output [31:0] Hits, Misses, Writebacks);
+
+  // write-back, write-allocate cache with WAYS-way sets and round-robin replacement
+  //   a miss writes the victim line back if it is dirty, refills it from
+  //   the backing memory and then replays the access, which hits
+  //   the core must hold re/we/a/wd stable while hit is low
+  //   be: byte enables of a store (sb/sh/fsh write only some lanes of wd)
+  //   rdn: the word after rd in the same line (instruction fetch across a
+  //   word boundary), undefined for the last word of a line
+  //   LINE_BITS must be at least 1
+  parameter SET_BITS  = 4; // 16 sets
+  parameter WAYS      = 1; // 1 = direct-mapped
+  parameter LINE_BITS = 2; // 4 words per line
+
+  localparam SETS     = 1 << SET_BITS;
+  localparam TAG_BITS = 30 - SET_BITS - LINE_BITS;
+
+  localparam IDLE = 2'b00;
+  localparam WB   = 2'b01; // writing the dirty victim back
+  localparam FILL = 2'b10; // reading the missing line
+
+  // way w of set s lives at index w*SETS + s
+  reg [(32<<LINE_BITS)-1:0] data[WAYS*SETS-1:0];
+  reg [TAG_BITS-1:0]        tags[WAYS*SETS-1:0];
+  reg [WAYS*SETS-1:0]       valid, dirty;
+  reg [7:0]                 victim[SETS-1:0];
+
+  reg [1:0]  state;
+  reg [15:0] vidx;     // line being replaced
+  reg        refilled; // the next hit is the replay of a miss
+  reg [31:0] Hits, Misses, Writebacks;
+
+  wire [TAG_BITS-1:0] tag  = a[31:SET_BITS+LINE_BITS+2];
+  wire [SET_BITS-1:0] set  = a[SET_BITS+LINE_BITS+1:LINE_BITS+2];
+  wire [7:0]          word = a[LINE_BITS+1:2];
+
+  integer w, s, b;
+  reg        hit_reg;
+  reg [15:0] hidx;
+
+  always @* begin
+    hit_reg = 1'b0;
+    hidx    = set;
+    for (w = 0; w < WAYS; w = w + 1)
+      if (valid[w*SETS + set] & tags[w*SETS + set] == tag) begin
+        hit_reg = 1'b1;
+        hidx    = w*SETS + set;
+      end
+  end
+
+  assign hit  = hit_reg;
+  assign miss = (state == IDLE) & (re | we) & ~hit; // first cycle of a miss
+  assign rd   = data[hidx][32*word +: 32];
+  assign rdn  = data[hidx][32*(word + 1) +: 32];
+
+  assign mreq   = state != IDLE;
+  assign mwe    = state == WB;
+  assign ma     = (state == WB) ? {tags[vidx], set, {LINE_BITS+2{1'b0}}}
+                                : {tag, set, {LINE_BITS+2{1'b0}}};
+  assign mwline = data[vidx];
+
+  always @(posedge clk or posedge reset) begin
+    if (reset) begin
+      state      <= IDLE;
+      valid      <= 0;
+      dirty      <= 0;
+      refilled   <= 1'b0;
+      Hits       <= 0;
+      Misses     <= 0;
+      Writebacks <= 0;
+      for (s = 0; s < SETS; s = s + 1) victim[s] <= 0;
+    end else case(state)
+      IDLE: if (re | we) begin
+              if (hit) begin
+                if (!refilled) Hits <= Hits + 1;
+                refilled <= 1'b0;
+                if (we) begin
+                  dirty[hidx] <= 1'b1;
+                  for (b = 0; b < 4; b = b + 1)
+                    if (be[b]) data[hidx][32*word + 8*b +: 8] <= wd[8*b +: 8];
+                end
+              end else begin
+                Misses <= Misses + 1;
+                vidx   <= victim[set]*SETS + set;
+                if (valid[victim[set]*SETS + set] & dirty[victim[set]*SETS + set]) begin
+                  Writebacks <= Writebacks + 1;
+                  state      <= WB;
+                end else
+                  state      <= FILL;
+              end
+            end
+      WB:   if (mready) state <= FILL;
+      FILL: if (mready) begin
+              data[vidx]  <= mrline;
+              tags[vidx]  <= tag;
+              valid[vidx] <= 1'b1;
+              dirty[vidx] <= 1'b0;
+              victim[set] <= (victim[set] == WAYS-1) ? 0 : victim[set] + 1;
+              refilled    <= 1'b1;
+              state       <= IDLE;
+            end
+      default: state <= IDLE;
+    endcase
+  end
+endmodule
@@ -0,0 +1,107 @@
+module cdec(input  [31:0] instr,
+            output [31:0] instrx,
+            output compressed);
+
+  // RV32C expander: a 16-bit instruction (instr[1:0] != 11) in instr[15:0]
+  // is rewritten as its 32-bit equivalent, 32-bit instructions pass through
+  //   the rest of the core only sees the expansion; compressed tells the
+  //   datapath to advance the PC (and link c.jal/c.jalr) by 2 instead of 4
+  //   RV32FC c.flw/c.fsw/c.flwsp/c.fswsp are expanded, c.fld/c.fsd (D) are not
+  //   reserved and unsupported encodings expand to 0 (illegal instruction)
+
+  localparam LOAD    = 7'b0000011;
+  localparam LOADFP  = 7'b0000111;
+  localparam OPIMM   = 7'b0010011;
+  localparam STORE   = 7'b0100011;
+  localparam STOREFP = 7'b0100111;
+  localparam OP      = 7'b0110011;
+  localparam LUI     = 7'b0110111;
+  localparam BRANCH  = 7'b1100011;
+  localparam JALR    = 7'b1100111;
+  localparam JAL     = 7'b1101111;
+
+  wire [15:0] c = instr[15:0];
+
+  // registers: full 5-bit fields and the x8-x15 (rd', rs1', rs2') fields
+  wire [4:0] rd   = c[11:7];
+  wire [4:0] rs2  = c[6:2];
+  wire [4:0] rdp  = {2'b01, c[4:2]};
+  wire [4:0] rs1p = {2'b01, c[9:7]};
+
+  // immediates, already scaled and extended to the 32-bit instruction fields
+  wire [11:0] immci   = {{7{c[12]}}, c[6:2]};                              // c.addi, c.li, c.andi
+  wire [11:0] imm4spn = {2'b0, c[10:7], c[12:11], c[5], c[6], 2'b0};        // c.addi4spn
+  wire [11:0] imm16sp = {{3{c[12]}}, c[4:3], c[5], c[2], c[6], 4'b0};       // c.addi16sp
+  wire [11:0] immlw   = {5'b0, c[5], c[12:10], c[6], 2'b0};                 // c.lw, c.sw
+  wire [11:0] immlwsp = {4'b0, c[3:2], c[12], c[6:4], 2'b0};                // c.lwsp
+  wire [11:0] immswsp = {4'b0, c[8:7], c[12:9], 2'b0};                      // c.swsp
+  wire [19:0] immlui  = {{15{c[12]}}, c[6:2]};                              // c.lui
+  wire [20:0] immj    = {{10{c[12]}}, c[8], c[10:9], c[6], c[7], c[2], c[11], c[5:3], 1'b0};
+  wire [12:0] immb    = {{5{c[12]}}, c[6:5], c[2], c[11:10], c[4:3], 1'b0};
+
+  // jal and branches share their immediate layout
+  wire [31:0] jal  = {immj[20], immj[10:1], immj[11], immj[19:12], 5'd0, JAL};
+  wire [31:0] bz   = {immb[12], immb[10:5], 5'd0, rs1p, 3'b000, immb[4:1], immb[11], BRANCH};
+
+  reg [31:0] x;
+
+  always @* begin
+    x = 32'b0;
+    case({c[15:13], c[1:0]})
+      5'b000_00: if (imm4spn != 0)
+                   x = {imm4spn, 5'd2, 3'b000, rdp, OPIMM};                   // c.addi4spn
+      5'b010_00:   x = {immlw, rs1p, 3'b010, rdp, LOAD};                      // c.lw
+      5'b011_00:   x = {immlw, rs1p, 3'b010, rdp, LOADFP};                    // c.flw
+      5'b110_00:   x = {immlw[11:5], rdp, rs1p, 3'b010, immlw[4:0], STORE};   // c.sw
+      5'b111_00:   x = {immlw[11:5], rdp, rs1p, 3'b010, immlw[4:0], STOREFP}; // c.fsw
+
+      5'b000_01:   x = {immci, rd, 3'b000, rd, OPIMM};                        // c.addi, c.nop
+      5'b001_01:   x = {jal[31:12], 5'd1, JAL};                               // c.jal
+      5'b010_01:   x = {immci, 5'd0, 3'b000, rd, OPIMM};                      // c.li
+      5'b011_01: if (rd == 5'd2) begin
+                   if (imm16sp != 0)
+                     x = {imm16sp, 5'd2, 3'b000, 5'd2, OPIMM};                // c.addi16sp
+                 end else if (immci != 0)
+                   x = {immlui, rd, LUI};                                     // c.lui
+      5'b100_01: case(c[11:10])
+                   2'b00: if (~c[12]) x = {7'b0000000, rs2, rs1p, 3'b101, rs1p, OPIMM}; // c.srli
+                   2'b01: if (~c[12]) x = {7'b0100000, rs2, rs1p, 3'b101, rs1p, OPIMM}; // c.srai
+                   2'b10: x = {immci, rs1p, 3'b111, rs1p, OPIMM};                        // c.andi
+                   2'b11: if (~c[12]) case(c[6:5])
+                            2'b00: x = {7'b0100000, rdp, rs1p, 3'b000, rs1p, OP};        // c.sub
+                            2'b01: x = {7'b0000000, rdp, rs1p, 3'b100, rs1p, OP};        // c.xor
+                            2'b10: x = {7'b0000000, rdp, rs1p, 3'b110, rs1p, OP};        // c.or
+                            2'b11: x = {7'b0000000, rdp, rs1p, 3'b111, rs1p, OP};        // c.and
+                          endcase
+                 endcase
+      5'b101_01:   x = jal;                                                   // c.j
+      5'b110_01:   x = bz;                                                    // c.beqz
+      5'b111_01:   x = {bz[31:15], 3'b001, bz[11:0]};                         // c.bnez
+
+      5'b000_10: if (~c[12])
+                   x = {7'b0000000, rs2, rd, 3'b001, rd, OPIMM};              // c.slli
+      5'b010_10: if (rd != 0)
+                   x = {immlwsp, 5'd2, 3'b010, rd, LOAD};                     // c.lwsp
+      5'b011_10:   x = {immlwsp, 5'd2, 3'b010, rd, LOADFP};                   // c.flwsp
+      5'b100_10: if (~c[12]) begin
+                   if (rs2 != 0)
+                     x = {7'b0000000, rs2, 5'd0, 3'b000, rd, OP};             // c.mv
+                   else if (rd != 0)
+                     x = {12'b0, rd, 3'b000, 5'd0, JALR};                     // c.jr
+                 end else begin
+                   if (rs2 != 0)
+                     x = {7'b0000000, rs2, rd, 3'b000, rd, OP};               // c.add
+                   else if (rd != 0)
+                     x = {12'b0, rd, 3'b000, 5'd1, JALR};                     // c.jalr
+                   else
+                     x = 32'h00100073;                                        // c.ebreak
+                 end
+      5'b110_10:   x = {immswsp[11:5], rs2, 5'd2, 3'b010, immswsp[4:0], STORE};   // c.swsp
+      5'b111_10:   x = {immswsp[11:5], rs2, 5'd2, 3'b010, immswsp[4:0], STOREFP}; // c.fswsp
+      default:     x = 32'b0;
+    endcase
+  end
+
+  assign compressed = instr[1:0] != 2'b11;
+  assign instrx     = compressed ? x : instr;
+endmodule
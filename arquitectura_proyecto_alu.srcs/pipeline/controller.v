@@ -1,36 +1,81 @@
 module controller(input  [6:0] op,
                   input  [2:0] funct3,
-                  input        funct7b5,
+                  input  [6:0] funct7,
                   input        Zero,
                   output [1:0] ResultSrc, 
-                  output MemWrite,
-                  output PCSrc, ALUSrc,
-                  output RegWrite, Jump,
-                  output [1:0] ImmSrc, 
-                  output [2:0] ALUControl);
+                  output MemWrite, MemRead,
+                  output [1:0] PCSrc,
+                  output ALUSrc, ALUSrcA,
+                  output RegWrite,
+                  output Branch, Jump, JumpReg,
+                  output [2:0] ImmSrc,
+                  output [3:0] ALUControl,
+                  output MulDiv,
+                  output CSRAccess,
+                  output FPRegWrite,
+                  output [1:0] FPResultSrc,
+                  output FPStore, FFlagsWrite,
+                  output FPFmt,
+                  output [1:0] FPUControl,
+                  output FPDiv, FPReadA, FPReadB);
   
   wire [1:0] ALUOp; 
-  wire       Branch; 
+  wire       IntRegWrite, FPToInt;
   
   maindec md(
     .op(op), 
+    .funct3(funct3),
     .ResultSrc(ResultSrc), 
     .MemWrite(MemWrite), 
     .Branch(Branch),
     .ALUSrc(ALUSrc), 
-    .RegWrite(RegWrite), 
+    .RegWrite(IntRegWrite),
     .Jump(Jump), 
     .ImmSrc(ImmSrc), 
-    .ALUOp(ALUOp)
+    .ALUOp(ALUOp),
+    .CSRAccess(CSRAccess)
   ); 
 
   aludec  ad(
     .opb5(op[5]), 
     .funct3(funct3), 
-    .funct7b5(funct7b5), 
+    .funct7b5(funct7[5]),
+    .funct7b0(funct7[0]),
     .ALUOp(ALUOp), 
-    .ALUControl(ALUControl)
+    .ALUControl(ALUControl),
+    .MulDiv(MulDiv)
   ); 
 
-  assign PCSrc = Branch & Zero | Jump; 
+  fpdec   fd(
+    .op(op),
+    .funct3(funct3),
+    .funct7(funct7),
+    .FPRegWrite(FPRegWrite),
+    .FPResultSrc(FPResultSrc),
+    .FPStore(FPStore),
+    .FPToInt(FPToInt),
+    .FFlagsWrite(FFlagsWrite),
+    .FPFmt(FPFmt),
+    .FPUControl(FPUControl),
+    .FPDiv(FPDiv),
+    .FPReadA(FPReadA),
+    .FPReadB(FPReadB)
+  );
+
+  // fmv.x.w/fmv.x.h write the integer register file through ResultSrc = 11
+  assign RegWrite = IntRegWrite | FPToInt;
+
+  // loads (lb ... lhu, flw, flh): the data cache only sees real accesses
+  assign MemRead = (op == 7'b0000011) | (op == 7'b0000111);
+
+  // auipc adds the U immediate to the PC instead of rs1
+  assign ALUSrcA = (op == 7'b0010111);
+
+  // jalr (1100111) is the only jump with op[3] = 0
+  assign JumpReg = Jump & ~op[3];
+
+  // PCSrc: 00 = PC+4 (PC+2 for compressed), 01 = PC+imm (branches, jal), 1x = rs1+imm (jalr)
+  // beq takes the branch on Zero; blt/bltu compute slt/sltu (see aludec), so
+  // Zero means "not less than"; funct3[0] negates the condition (bne, bge, bgeu)
+  assign PCSrc = {JumpReg, Branch & (Zero ^ funct3[0] ^ funct3[2]) | Jump};
 endmodule
\ No newline at end of file
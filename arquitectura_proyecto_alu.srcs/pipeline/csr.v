@@ -0,0 +1,152 @@
+module csr(input  clk, reset,
+           input  we,
+           input  [1:0]  op,
+           input  [11:0] a,
+           input  [31:0] wd,
+           input  FFlagsWrite,
+           input  [4:0]  FFlags,
+           input  Retire, Retire1,
+           input  [8:0]  Events,
+           output [31:0] rd);
+
+  // control and status registers (Zicsr, Zicntr, Zihpm)
+  //   op = funct3[1:0] of the csr instruction: 01 = csrrw, 10 = csrrs, 11 = csrrc
+  //   wd is rs1 or the 5-bit zimm, already selected by the datapath
+  //   unknown addresses read as 0 and ignore writes
+  //   the core only has machine mode, so the m* counters are writable and the
+  //   user-level aliases (cycle, time, instret, hpmcounterN) are read-only
+  //
+  //   address      name            contents
+  //   0x001        fflags          accrued FP exceptions {NV, DZ, OF, UF, NX}
+  //   0x002        frm             dynamic rounding mode (stored only, the FPU rounds to nearest even)
+  //   0x003        fcsr            {frm, fflags}
+  //   0x320        mcountinhibit   bit 0 stops mcycle, bit 2 minstret, bit N mhpmcounterN
+  //   0x323-0x326  mhpmevent3-6    event counted by mhpmcounter3-6 (0 and 10-15 = none, see below)
+  //   0xB00/0xB80  mcycle(h)       clock cycles
+  //   0xB02/0xB82  minstret(h)     retired instructions
+  //   0xB03-0xB06  mhpmcounter3-6  (and 0xB83-0xB86 for the high halves)
+  //   0xC00-0xC06  cycle, time, instret, hpmcounter3-6 (and 0xC80-0xC86)
+  //
+  //   time ticks once every TIME_DIV cycles (100 = 1 us with the 100 MHz Basys3 clock)
+  //
+  //   mhpmevent   Events bit   event
+  //   1           0            branch or jump mispredicted by bpred
+  //   2           1            load-use (an instruction reading the register just loaded)
+  //   3           2            I-cache miss
+  //   4           3            D-cache miss
+  //   5           4            fdiv busy cycle
+  //   6           5            FP scoreboard stall cycle
+  //   7           6            mul/div stall cycle
+  //   8           7            cache stall cycle
+  //   9           8            dual-issued bundle (two instructions retired)
+  //
+  //   Retire1 is the second instruction of a dual-issued bundle, minstret counts both
+  parameter TIME_DIV = 100;
+  parameter NUM_HPM  = 4;   // mhpmcounter3 .. mhpmcounter(3+NUM_HPM-1), at most 29
+
+  reg [4:0]  fflags;
+  reg [2:0]  frm;
+  reg [31:0] rd_reg, wval;
+
+  reg [63:0] mcycle, minstret, mtime;
+  reg [31:0] mcountinhibit;
+  reg [15:0] tdiv;
+  reg [63:0] hpm[NUM_HPM-1:0];
+  reg [3:0]  hpmevent[NUM_HPM-1:0];
+  reg [63:0] counter;
+
+  integer k;
+
+  // event selected by an mhpmevent value: bit 0 and bits 10-15 are never set
+  wire [15:0] EventSel = {6'b0, Events, 1'b0};
+
+  wire [4:0] idx = a[4:0];
+
+  // 64-bit counter selected by the low 5 address bits
+  always @* begin
+    case(idx)
+      5'd0:    counter = mcycle;
+      5'd1:    counter = mtime;
+      5'd2:    counter = minstret;
+      default: counter = (idx < 3 + NUM_HPM) ? hpm[idx - 3] : 64'b0;
+    endcase
+  end
+
+  always @* casez(a)
+      12'h001: rd_reg = {27'b0, fflags};
+      12'h002: rd_reg = {29'b0, frm};
+      12'h003: rd_reg = {24'b0, frm, fflags};
+      12'h320: rd_reg = mcountinhibit;
+      12'b0011_001?_????: rd_reg = (idx >= 3 & idx < 3 + NUM_HPM) ? {28'b0, hpmevent[idx - 3]} : 32'b0; // mhpmevent
+      12'b1011_000?_????,                                                                      // mcycle, minstret, mhpmcounter
+      12'b1100_000?_????: rd_reg = counter[31:0];                                              // cycle, time, instret, hpmcounter
+      12'b1011_100?_????,
+      12'b1100_100?_????: rd_reg = counter[63:32];                                             // high halves
+      default: rd_reg = 32'b0;
+    endcase
+
+  assign rd = rd_reg;
+
+  // value written back by csrrw/csrrs/csrrc
+  always @* case(op)
+      2'b01:   wval = wd;           // csrrw
+      2'b10:   wval = rd_reg | wd;  // csrrs
+      2'b11:   wval = rd_reg & ~wd; // csrrc
+      default: wval = rd_reg;
+    endcase
+
+  // FP instructions OR their exception flags into fflags as they retire
+  always @(posedge clk or posedge reset) begin
+    if (reset) begin
+      fflags <= 5'b0;
+      frm    <= 3'b0;
+    end else if (we) begin
+      case(a)
+        12'h001: fflags <= wval[4:0];
+        12'h002: frm    <= wval[2:0];
+        12'h003: {frm, fflags} <= wval[7:0];
+        default: ;
+      endcase
+    end else if (FFlagsWrite) begin
+      fflags <= fflags | FFlags;
+    end
+  end
+
+  // counters: a csr write in the same cycle wins over the increment
+  always @(posedge clk or posedge reset) begin
+    if (reset) begin
+      mcycle        <= 64'b0;
+      minstret      <= 64'b0;
+      mtime         <= 64'b0;
+      tdiv          <= 16'b0;
+      mcountinhibit <= 32'b0;
+      for (k = 0; k < NUM_HPM; k = k + 1) begin
+        hpm[k]      <= 64'b0;
+        hpmevent[k] <= 4'b0;
+      end
+    end else begin
+      if (tdiv == TIME_DIV - 1) begin
+        tdiv  <= 16'b0;
+        mtime <= mtime + 1;
+      end else tdiv <= tdiv + 1;
+
+      if (we & a == 12'hB00)      mcycle[31:0]  <= wval;
+      else if (we & a == 12'hB80) mcycle[63:32] <= wval;
+      else if (~mcountinhibit[0]) mcycle        <= mcycle + 1;
+
+      if (we & a == 12'hB02)      minstret[31:0]  <= wval;
+      else if (we & a == 12'hB82) minstret[63:32] <= wval;
+      else if (Retire & ~mcountinhibit[2]) minstret <= minstret + (Retire1 ? 64'd2 : 64'd1);
+
+      if (we & a == 12'h320) mcountinhibit <= wval;
+
+      for (k = 0; k < NUM_HPM; k = k + 1) begin
+        if (we & a == 12'h323 + k[11:0])      hpmevent[k]   <= wval[3:0];
+        if (we & a == 12'hB03 + k[11:0])      hpm[k][31:0]  <= wval;
+        else if (we & a == 12'hB83 + k[11:0]) hpm[k][63:32] <= wval;
+        else if (~mcountinhibit[3 + k] & EventSel[hpmevent[k]])
+          hpm[k] <= hpm[k] + 1;
+      end
+    end
+  end
+endmodule
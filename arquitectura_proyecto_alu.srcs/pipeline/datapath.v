@@ -1,34 +1,77 @@
 module datapath(input  clk, reset,
+                input  Stall,
+                input  [1:0]  CacheMiss,
                 input  [1:0]  ResultSrc, 
-                input  PCSrc, ALUSrc,
+                input  [1:0]  PCSrc,
+                input  ALUSrc, ALUSrcA,
                 input  RegWrite,
-                input  [1:0]  ImmSrc, 
-                input  [2:0]  ALUControl,
+                input  Branch, Jump, JumpReg,
+                input  [2:0]  ImmSrc,
+                input  [3:0]  ALUControl,
+                input  MulDiv,
+                input  CSRAccess,
+                input  FPRegWrite,
+                input  [1:0]  FPResultSrc,
+                input  FPStore, FFlagsWrite,
+                input  FPFmt,
+                input  [1:0]  FPUControl,
+                input  FPDiv, FPReadA, FPReadB,
+                output FPStall,
                 output Zero,
                 output [31:0] PC,
                 input  [31:0] Instr,
+                input  Compressed,
+                input  [31:0] Instr1,
+                input  Valid1, Compressed1,
+                output Issue1,
                 output [31:0] ALUResult, WriteData, 
+                output [3:0]  ByteEn,
                 input  [31:0] ReadData);
+
+  parameter DUAL_ISSUE = 0; // 1 = second issue slot for integer ALU instructions (dualslot)
   
   localparam WIDTH = 32; // Define a local parameter for bus width
 
-  wire [31:0] PCNext, PCPlus4, PCTarget; 
+  wire [31:0] PCNext, PCNext0, PCPlusLen, PCPlus1, PCTarget, PCJalr;
+  wire [31:0] SrcA1, RD21, Result1;
+  wire [31:0] PredPC;
+  wire        PredTaken, Mispredict;
+  wire [31:0] BranchCount, BranchMiss, JumpCount, JumpMiss;
   wire [31:0] ImmExt; 
-  wire [31:0] SrcA, SrcB; 
+  wire [31:0] SrcA, SrcB, RD2, ALUSrcAData;
   wire [31:0] Result; 
+  wire [31:0] FPSrcA, FPSrcB, FPUResult, FPResult;
+  wire [31:0] StoreData, LoadData;
+  wire [31:0] FPLoadData, FPMoveData, FPToIntData;
+  wire [31:0] CSRWriteData, CSRReadData;
+  wire        CSRWrite;
+  wire [4:0]  FPUFlags;
+  wire        Hold, MStall, MDValid;
+  wire [31:0] MDResult, ExResult;
+  wire        DivStart, DivBusy, DivDone, DivPending, FPHazard, FPUWrite;
+  wire [4:0]  DivRd, DivFlags, FFlags;
+  wire [31:0] DivResult;
+  wire        LoadUse;
+  wire [8:0]  Events;
+
+  // a cache miss (Stall), an FP hazard (FPStall) or a busy mul/div (MStall)
+  // holds the PC and blocks every state update until the instruction can complete
+  assign Hold = Stall | FPStall | MStall;
 
   // next PC logic
-  flopr #(WIDTH) pcreg(
+  flopenr #(WIDTH) pcreg(
     .clk(clk), 
     .reset(reset), 
+    .en(~Hold),
     .d(PCNext), 
     .q(PC)
   ); 
 
-  adder       pcadd4(
+  // sequential PC: +2 after a compressed (RV32C) instruction, +4 otherwise
+  adder       pcaddlen(
     .a(PC), 
-    .b({WIDTH{1'b0}} + 4), // Using WIDTH parameter for constant 4
-    .y(PCPlus4)
+    .b(Compressed ? 32'd2 : 32'd4),
+    .y(PCPlusLen)
   ); 
 
   adder       pcaddbranch(
@@ -37,24 +80,96 @@ module datapath(input  clk, reset,
     .y(PCTarget)
   ); 
 
-  mux2 #(WIDTH)  pcmux(
-    .d0(PCPlus4), 
+  // jalr clears bit 0 of rs1+imm
+  assign PCJalr = {ALUResult[31:1], 1'b0};
+
+  mux3 #(WIDTH)  pcmux(
+    .d0(PCPlusLen),
     .d1(PCTarget), 
+    .d2(PCJalr),
     .s(PCSrc), 
-    .y(PCNext)
+    .y(PCNext0)
+  );
+
+  // a dual-issued bundle also steps over the slot 1 instruction at PCPlusLen
+  assign PCPlus1 = PCPlusLen + (Compressed1 ? 32'd2 : 32'd4);
+  assign PCNext  = Issue1 ? PCPlus1 : PCNext0;
+
+  // branch prediction: fetch and resolve happen in the same cycle here, so
+  // the predictor runs in shadow mode (PCNext always wins) and only counts
+  // the redirects a pipelined core would have paid for
+  bpred       bp(
+    .clk(clk),
+    .reset(reset),
+    .PCF(PC),
+    .CompressedF(Compressed),
+    .PredTakenF(PredTaken),
+    .PredPCF(PredPC),
+    .PCE(PC),
+    .CompressedE(Compressed),
+    .PCNextE(PCNext0),
+    .PredPCE(PredPC),
+    .BranchE(Branch & ~Hold),
+    .JumpE(Jump & ~Hold),
+    .JumpRegE(JumpReg),
+    .RdE(Instr[11:7]),
+    .Rs1E(Instr[19:15]),
+    .MispredictE(Mispredict),
+    .BranchCount(BranchCount),
+    .BranchMiss(BranchMiss),
+    .JumpCount(JumpCount),
+    .JumpMiss(JumpMiss)
   ); 
  
   // register file logic
-  regfile     rf(
-    .clk(clk), 
-    .we3(RegWrite), 
-    .a1(Instr[19:15]), 
-    .a2(Instr[24:20]), 
-    .a3(Instr[11:7]), 
-    .wd3(Result), 
-    .rd1(SrcA), 
-    .rd2(WriteData)
-  ); 
+  generate
+    if (DUAL_ISSUE) begin : regs
+      regfile2w   rf(
+        .clk(clk),
+        .we3(RegWrite & ~Hold),
+        .we6(Issue1 & ~Hold),
+        .a1(Instr[19:15]),
+        .a2(Instr[24:20]),
+        .a3(Instr[11:7]),
+        .a4(Instr1[19:15]),
+        .a5(Instr1[24:20]),
+        .a6(Instr1[11:7]),
+        .wd3(Result),
+        .wd6(Result1),
+        .rd1(SrcA),
+        .rd2(RD2),
+        .rd4(SrcA1),
+        .rd5(RD21)
+      );
+
+      dualslot    ds(
+        .Instr1(Instr1),
+        .Valid1(Valid1),
+        .RegWrite0(RegWrite),
+        .Branch0(Branch),
+        .Jump0(Jump),
+        .Rd0(Instr[11:7]),
+        .SrcA1(SrcA1),
+        .RD21(RD21),
+        .Issue1(Issue1),
+        .Result1(Result1)
+      );
+    end else begin : regs
+      regfile     rf(
+        .clk(clk),
+        .we3(RegWrite & ~Hold),
+        .a1(Instr[19:15]),
+        .a2(Instr[24:20]),
+        .a3(Instr[11:7]),
+        .wd3(Result),
+        .rd1(SrcA),
+        .rd2(RD2)
+      );
+
+      assign Issue1  = 1'b0;
+      assign Result1 = 32'b0;
+    end
+  endgenerate
 
   extend      ext(
     .instr(Instr[31:7]), 
@@ -63,26 +178,198 @@ module datapath(input  clk, reset,
   ); 
 
   // ALU logic
+  mux2 #(WIDTH)  srcamux(
+    .d0(SrcA),
+    .d1(PC), 
+    .s(ALUSrcA), 
+    .y(ALUSrcAData)
+  ); 
+
   mux2 #(WIDTH)  srcbmux(
-    .d0(WriteData), 
+    .d0(RD2),
     .d1(ImmExt), 
     .s(ALUSrc), 
     .y(SrcB)
   ); 
 
-  alu         alu(
-    .a(SrcA), 
+  intalu      alu(
+    .a(ALUSrcAData), 
     .b(SrcB), 
     .alucontrol(ALUControl), 
     .result(ALUResult), 
     .zero(Zero)
   ); 
 
-  mux3 #(WIDTH)  resultmux(
+  // RV32M: the instruction waits until the mdu has its result
+  assign MStall = MulDiv & ~MDValid;
+
+  mdu         mdu(
+    .clk(clk),
+    .reset(reset),
+    .req(MulDiv),
+    .ack(MulDiv & ~Stall & ~FPStall),
+    .funct3(Instr[14:12]),
+    .a(SrcA),
+    .b(SrcB),
+    .valid(MDValid),
+    .result(MDResult)
+  );
+
+  mux2 #(WIDTH)  exmux(
     .d0(ALUResult), 
-    .d1(ReadData), 
-    .d2(PCPlus4), 
+    .d1(MDResult),
+    .s(MulDiv),
+    .y(ExResult)
+  );
+
+  mux4 #(WIDTH)  resultmux(
+    .d0(ExResult),
+    .d1(LoadData),
+    .d2(PCPlusLen),
+    .d3(FPToIntData),
     .s(ResultSrc), 
     .y(Result)
   ); 
+
+  // FP register file logic
+  fpregfile   fprf(
+    .clk(clk),
+    .we3(DivDone | FPRegWrite & ~FPDiv & ~Hold),
+    .a1(Instr[19:15]),
+    .a2(Instr[24:20]),
+    .a3(DivDone ? DivRd : Instr[11:7]),
+    .wd3(DivDone ? DivResult : FPResult),
+    .rd1(FPSrcA),
+    .rd2(FPSrcB)
+  );
+
+  // FP unit (IEEE-754 alu, half and single) for fadd, fsub, fmul
+  // fdiv (11) is mapped to fmul (10) so its combinational divider is dropped
+  fpu         fpu(
+    .a(FPSrcA),
+    .b(FPSrcB),
+    .fpucontrol({FPUControl[1], FPUControl[0] & ~FPUControl[1]}),
+    .fmt(FPFmt),
+    .result(FPUResult),
+    .flags(FPUFlags)
+  );
+
+  // fdiv runs in the background; the scoreboard stalls only the
+  // instructions that touch its destination register
+  assign DivStart = FPDiv & ~Hold;
+
+  fpdiv       fpdiv(
+    .clk(clk),
+    .reset(reset),
+    .start(DivStart),
+    .fmt(FPFmt),
+    .rdin(Instr[11:7]),
+    .a(FPSrcA),
+    .b(FPSrcB),
+    .busy(DivBusy),
+    .done(DivDone),
+    .rd(DivRd),
+    .result(DivResult),
+    .flags(DivFlags)
+  );
+
+  scoreboard  sb(
+    .clk(clk),
+    .reset(reset),
+    .issue(DivStart),
+    .issuerd(Instr[11:7]),
+    .complete(DivDone),
+    .completerd(DivRd),
+    .reada(FPReadA),
+    .readb(FPReadB),
+    .write(FPRegWrite),
+    .ra(Instr[19:15]),
+    .rb(Instr[24:20]),
+    .rw(Instr[11:7]),
+    .hazard(FPHazard),
+    .pending(DivPending)
+  );
+
+  // FPStall: RAW/WAW on an fdiv destination, a second fdiv while the
+  // divider is busy, an FP write-back in the cycle the divider owns the
+  // write port, or a CSR access while an fdiv can still update fflags
+  assign FPStall = FPHazard | FPDiv & DivBusy | FPRegWrite & ~FPDiv & DivDone |
+                   CSRAccess & DivPending;
+
+  // halves are NaN-boxed on the way into the FP register file
+  assign FPLoadData = FPFmt ? {16'hFFFF, LoadData[15:0]} : LoadData;
+  assign FPMoveData = FPFmt ? {16'hFFFF, SrcA[15:0]} : SrcA;
+
+  mux3 #(WIDTH)  fpresultmux(
+    .d0(FPUResult),
+    .d1(FPLoadData),
+    .d2(FPMoveData),
+    .s(FPResultSrc),
+    .y(FPResult)
+  );
+
+  // fsw/fsh store the FP rs2 register
+  mux2 #(WIDTH)  wdmux(
+    .d0(RD2),
+    .d1(FPSrcB),
+    .s(FPStore),
+    .y(StoreData)
+  );
+
+  // byte/halfword lanes of loads and stores, sized by funct3
+  lsu         lsu(
+    .funct3(Instr[14:12]),
+    .a(ALUResult[1:0]),
+    .wd(StoreData),
+    .rd(ReadData),
+    .be(ByteEn),
+    .wdata(WriteData),
+    .rdata(LoadData)
+  );
+
+  // fflags accumulate the flags of the FPU op retiring now and of the
+  // fdiv completing now (an OR, so their order does not matter)
+  assign FPUWrite = FFlagsWrite & ~FPDiv & ~Hold;
+  assign FFlags   = (FPUWrite ? FPUFlags : 5'b0) | (DivDone ? DivFlags : 5'b0);
+
+  // performance events for the hpm counters (see csr.v)
+  loaduse     lu(
+    .clk(clk),
+    .reset(reset),
+    .en(~Hold),
+    .Instr(Instr),
+    .IntLoad(RegWrite & ResultSrc == 2'b01),
+    .FPLoad(FPRegWrite & FPResultSrc == 2'b01),
+    .FPReadA(FPReadA),
+    .FPReadB(FPReadB),
+    .LoadUse(LoadUse)
+  );
+
+  assign Events = {Issue1 & ~Hold, Stall, MStall, FPStall, DivBusy, CacheMiss[1], CacheMiss[0],
+                   LoadUse & ~Hold, Mispredict & ~Hold};
+
+  // CSR logic: csrrw/csrrs/csrrc take rs1, the immediate forms take zimm = Instr[19:15]
+  // csrrs/csrrc with rs1 = x0 (csrr) and csrrsi/csrrci with zimm = 0 do not write,
+  // so reading a counter does not stop it for a cycle
+  assign CSRWriteData = Instr[14] ? {27'b0, Instr[19:15]} : SrcA;
+  assign CSRWrite     = CSRAccess & (Instr[13:12] == 2'b01 | Instr[19:15] != 5'b0);
+
+  csr         csrs(
+    .clk(clk),
+    .reset(reset),
+    .we(CSRWrite & ~Hold),
+    .op(Instr[13:12]),
+    .a(Instr[31:20]),
+    .wd(CSRWriteData),
+    .FFlagsWrite(FPUWrite | DivDone),
+    .FFlags(FFlags),
+    .Retire(~Hold),
+    .Retire1(Issue1 & ~Hold),
+    .Events(Events),
+    .rd(CSRReadData)
+  );
+
+  // fmv.x.h sign-extends the half, fmv.x.w moves the raw bits
+  assign FPToIntData = CSRAccess ? CSRReadData
+                                 : (FPFmt ? {{16{FPSrcA[15]}}, FPSrcA[15:0]} : FPSrcA);
 endmodule
\ No newline at end of file
@@ -1,12 +1,20 @@
 module dmem(input  clk, we,
+            input  [3:0]  be,
             input  [31:0] a, wd,
             output [31:0] rd);
   
   reg [31:0] RAM[63:0]; 
 
-  assign rd = RAM[a[31:2]]; // word aligned
+  integer i;
 
+  wire [5:0] wa = a[7:2];
+
+  assign rd = RAM[wa]; // word aligned
+
+  // be: byte enables, sb/sh write only the addressed lanes of wd (see lsu.v)
   always @(posedge clk) begin 
-    if (we) RAM[a[31:2]] <= wd; 
+    if (we)
+      for (i = 0; i < 4; i = i + 1)
+        if (be[i]) RAM[wa][8*i +: 8] <= wd[8*i +: 8];
   end
 endmodule
\ No newline at end of file
@@ -0,0 +1,69 @@
+module dualslot(input  [31:0] Instr1,
+                input  Valid1,
+                input  RegWrite0, Branch0, Jump0,
+                input  [4:0]  Rd0,
+                input  [31:0] SrcA1, RD21,
+                output Issue1,
+                output [31:0] Result1);
+
+  // second issue slot of the dual-issue core
+  //   Instr1 is the (expanded) instruction after the one in slot 0;
+  //   it issues in the same cycle when
+  //     - it is an integer ALU instruction: R-type without RV32M, I-type ALU, lui
+  //     - slot 0 is not a branch or jump (Instr1 would be on the wrong path)
+  //     - it does not read the register slot 0 writes (no bypass inside
+  //       a bundle); a common destination is fine, regfile2w keeps slot 1's write
+  //   memory, FP, CSR and control instructions only issue in slot 0
+  //   SrcA1/RD21 come from read ports 4/5 of regfile2w
+
+  wire [6:0] op     = Instr1[6:0];
+  wire [2:0] funct3 = Instr1[14:12];
+  wire [6:0] funct7 = Instr1[31:25];
+  wire [4:0] rs1    = Instr1[19:15];
+  wire [4:0] rs2    = Instr1[24:20];
+
+  wire       RType  = (op == 7'b0110011) & (funct7 == 7'b0000000 | funct7 == 7'b0100000);
+  wire       IType  = (op == 7'b0010011);
+  wire       Lui    = (op == 7'b0110111);
+  wire       IntALU = RType | IType | Lui;
+
+  wire       Dep    = RegWrite0 & (Rd0 != 0) & ((Rd0 == rs1) & ~Lui | (Rd0 == rs2) & RType);
+
+  wire [3:0]  ALUControl1;
+  wire [31:0] ImmExt1, SrcB1;
+  wire        Zero1, MulDiv1;
+
+  assign Issue1 = Valid1 & IntALU & ~Branch0 & ~Jump0 & ~Dep;
+
+  aludec  ad1(
+    .opb5(op[5]),
+    .funct3(funct3),
+    .funct7b5(funct7[5]),
+    .funct7b0(1'b0),
+    .ALUOp(Lui ? 2'b11 : 2'b10),
+    .ALUControl(ALUControl1),
+    .MulDiv(MulDiv1)
+  );
+
+  extend  ext1(
+    .instr(Instr1[31:7]),
+    .immsrc(Lui ? 3'b100 : 3'b000),
+    .immext(ImmExt1)
+  );
+
+  mux2 #(32)  srcbmux1(
+    .d0(ImmExt1),
+    .d1(RD21),
+    .s(RType),
+    .y(SrcB1)
+  );
+
+  // second copy of the integer ALU
+  intalu  alu1(
+    .a(SrcA1),
+    .b(SrcB1),
+    .alucontrol(ALUControl1),
+    .result(Result1),
+    .zero(Zero1)
+  );
+endmodule
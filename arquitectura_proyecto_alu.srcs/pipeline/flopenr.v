@@ -0,0 +1,13 @@
+module flopenr (input  clk, reset, en,
+                input  [WIDTH-1:0] d, 
+                output [WIDTH-1:0] q);
+
+  parameter WIDTH = 8;
+
+  reg [WIDTH-1:0] q; 
+
+  always @(posedge clk or posedge reset) begin 
+    if (reset)   q <= 0; 
+    else if (en) q <= d; 
+  end
+endmodule
\ No newline at end of file
@@ -0,0 +1,57 @@
+module fpdec(input  [6:0] op,
+             input  [2:0] funct3,
+             input  [6:0] funct7,
+             output FPRegWrite,
+             output [1:0] FPResultSrc,
+             output FPStore, FPToInt,
+             output FFlagsWrite,
+             output FPFmt,
+             output [1:0] FPUControl,
+             output FPDiv, FPReadA, FPReadB);
+
+  // F/Zfh subset: flw, flh, fsw, fsh, fadd/fsub/fmul/fdiv.{s,h},
+  //               fmv.x.w, fmv.x.h, fmv.w.x, fmv.h.x
+  // FPResultSrc: 00 = FPU, 01 = memory, 10 = integer rs1 (fmv.*.x)
+  // FPFmt:       0 = single, 1 = half (fmt field 10, or width 001 for flh/fsh)
+  // the rounding mode field (funct3) of arithmetic ops is ignored: always RNE
+
+  reg [5:0] controls;
+  reg       fmt_reg;
+
+  assign {FPRegWrite, FPResultSrc, FPStore, FPToInt, FFlagsWrite} = controls;
+  assign FPFmt = fmt_reg;
+
+  // funct7[6:2]: 00000 fadd, 00001 fsub, 00010 fmul, 00011 fdiv
+  assign FPUControl = funct7[3:2];
+
+  always @* case(op)
+    // FPRegWrite_FPResultSrc_FPStore_FPToInt_FFlagsWrite
+      7'b0000111: controls = 6'b1_01_0_0_0; // flw, flh
+      7'b0100111: controls = 6'b0_00_1_0_0; // fsw, fsh
+      7'b1010011: case(funct7[6:2])          // OP-FP
+                    5'b00000, 5'b00001,
+                    5'b00010, 5'b00011: controls = 6'b1_00_0_0_1; // fadd, fsub, fmul, fdiv
+                    // funct3 = 000 only: fclass (11100 with funct3 = 001) is not implemented
+                    5'b11100:           controls = (funct3 == 3'b000) ? 6'b0_00_0_1_0  // fmv.x.w, fmv.x.h
+                                                                      : 6'b0_00_0_0_0;
+                    5'b11110:           controls = (funct3 == 3'b000) ? 6'b1_10_0_0_0  // fmv.w.x, fmv.h.x
+                                                                      : 6'b0_00_0_0_0;
+                    default:            controls = 6'b0_00_0_0_0; // non-implemented FP instruction
+                  endcase
+      default:    controls = 6'b0_00_0_0_0; // not an FP instruction
+    endcase
+
+  // fdiv goes to the multi-cycle divider, tracked by the scoreboard
+  assign FPDiv = (op == 7'b1010011) & (funct7[6:2] == 5'b00011);
+
+  // FP source registers: rs1 for arithmetic and fmv.x.*, rs2 for arithmetic and stores
+  assign FPReadA = (op == 7'b1010011) & (funct7[6:2] != 5'b11110);
+  assign FPReadB = (op == 7'b1010011) & ~funct7[6] | (op == 7'b0100111);
+
+  always @* case(op)
+      7'b0000111,
+      7'b0100111: fmt_reg = (funct3 == 3'b001); // flh, fsh
+      7'b1010011: fmt_reg = funct7[1];          // fmt = 10 (H)
+      default:    fmt_reg = 1'b0;
+    endcase
+endmodule
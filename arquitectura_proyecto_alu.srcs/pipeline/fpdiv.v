@@ -0,0 +1,56 @@
+module fpdiv(input  clk, reset,
+             input  start,
+             input  fmt,
+             input  [4:0]  rdin,
+             input  [31:0] a, b,
+             output busy, done,
+             output [4:0]  rd,
+             output [31:0] result,
+             output [4:0]  flags);
+
+  // multi-cycle fdiv.s/fdiv.h
+  //   start latches the operands and the destination register;
+  //   done is high for one cycle, LATENCY cycles after start, with the
+  //   quotient and its flags; busy stays high until then
+  //   the divider is the IEEE-754 alu behind registered operands, so the
+  //   path from the operand registers to the FP register file can be
+  //   constrained as a LATENCY-cycle multicycle path
+  parameter LATENCY = 8;
+
+  reg [31:0] a_q, b_q;
+  reg        fmt_q;
+  reg [4:0]  rd_q;
+  reg        busy_q;
+  reg [7:0]  count;
+
+  assign busy = busy_q;
+  assign done = busy_q & (count == 0);
+  assign rd   = rd_q;
+
+  always @(posedge clk or posedge reset) begin
+    if (reset) begin
+      busy_q <= 1'b0;
+      count  <= 0;
+    end else if (start) begin
+      a_q    <= a;
+      b_q    <= b;
+      fmt_q  <= fmt;
+      rd_q   <= rdin;
+      busy_q <= 1'b1;
+      count  <= LATENCY-1;
+    end else if (done) begin
+      busy_q <= 1'b0;
+    end else if (busy_q) begin
+      count  <= count - 1;
+    end
+  end
+
+  fpu         div(
+    .a(a_q),
+    .b(b_q),
+    .fpucontrol(2'b11),
+    .fmt(fmt_q),
+    .result(result),
+    .flags(flags)
+  );
+endmodule
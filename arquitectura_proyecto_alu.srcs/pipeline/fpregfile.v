@@ -0,0 +1,18 @@
+module fpregfile(input  clk, 
+                 input  we3, 
+                 input  [ 4:0] a1, a2, a3, 
+                 input  [31:0] wd3, 
+                 output [31:0] rd1, rd2); 
+
+  reg [31:0] rf[31:0]; 
+
+  // write third port on rising edge of clock (A3/WD3/WE3)
+  always @(posedge clk) begin 
+    if (we3) rf[a3] <= wd3; 
+  end
+  
+  // read two ports combinationally (A1/RD1, A2/RD2)
+  // unlike the integer file, f0 is a regular register
+  assign rd1 = rf[a1]; 
+  assign rd2 = rf[a2]; 
+endmodule
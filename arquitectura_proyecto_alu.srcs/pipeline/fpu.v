@@ -0,0 +1,39 @@
+module fpu(input  [31:0] a, b,
+           input  [1:0]  fpucontrol,
+           input  fmt,
+           output [31:0] result,
+           output [4:0]  flags);
+
+  // fpucontrol uses the encoding of the IEEE-754 alu (sources_1/new/alu.v):
+  //   00 = fadd, 01 = fsub, 10 = fmul, 11 = fdiv
+  // fmt selects the format: 0 = single (.s), 1 = half (.h)
+  // flags = {invalid, div0, ovf, unf, inx}, same order as fflags {NV, DZ, OF, UF, NX}
+
+  wire [15:0] a16, b16, y16; 
+  wire [31:0] y32; 
+  wire [4:0]  flags16, flags32; 
+
+  // half values live NaN-boxed in the 32-bit registers;
+  // a value that is not properly boxed reads as the canonical NaN
+  assign a16 = (&a[31:16]) ? a[15:0] : 16'h7E00;
+  assign b16 = (&b[31:16]) ? b[15:0] : 16'h7E00;
+
+  alu #(.system(16)) alu16(
+    .a(a16), 
+    .b(b16), 
+    .op(fpucontrol), 
+    .y(y16), 
+    .ALUFlags(flags16)
+  ); 
+
+  alu #(.system(32)) alu32(
+    .a(a), 
+    .b(b), 
+    .op(fpucontrol), 
+    .y(y32), 
+    .ALUFlags(flags32)
+  ); 
+
+  assign result = fmt ? {16'hFFFF, y16} : y32; 
+  assign flags  = fmt ? flags16 : flags32; 
+endmodule
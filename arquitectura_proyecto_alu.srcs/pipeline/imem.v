@@ -1,11 +1,21 @@
-module imem(input  [31:0] a,
-            output [31:0] rd);
+module imem(input  [31:0] a, a1,
+            output [31:0] rd, rd1);
+
+  parameter MEMFILE = "riscvtest.txt";
   
   reg [31:0] RAM[63:0]; 
 
+  wire [5:0] wa  = a[7:2];
+  wire [5:0] wa1 = a1[7:2];
+
   initial begin
-      $readmemh("riscvtest.txt",RAM); 
+      $readmemh(MEMFILE,RAM);
   end
 
-  assign rd = RAM[a[31:2]]; // word aligned
+  // halfword aligned (RV32C): at a[1] = 1 the upper half of the word and
+  // the lower half of the next one form the 32 bits starting at a
+  assign rd  = a[1]  ? {RAM[wa + 6'd1][15:0], RAM[wa][31:16]}   : RAM[wa];
+
+  // second read port for the dual-issue fetch (a1 = address of the next instruction)
+  assign rd1 = a1[1] ? {RAM[wa1 + 6'd1][15:0], RAM[wa1][31:16]} : RAM[wa1];
 endmodule
\ No newline at end of file
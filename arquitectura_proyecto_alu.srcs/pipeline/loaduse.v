@@ -0,0 +1,48 @@
+module loaduse(input  clk, reset, en,
+               input  [31:0] Instr,
+               input  IntLoad, FPLoad,
+               input  FPReadA, FPReadB,
+               output LoadUse);
+
+  // load-use monitor: flags an instruction that reads the register loaded
+  // by the instruction retired just before it, i.e. the one-cycle bubble a
+  // five-stage pipeline would insert; the single-cycle core does not stall
+  //   en: the current instruction retires this cycle
+
+  wire [6:0] op  = Instr[6:0];
+  wire [4:0] rs1 = Instr[19:15];
+  wire [4:0] rs2 = Instr[24:20];
+
+  reg        UsesRs1, UsesRs2;
+  reg        lastint, lastfp;
+  reg [4:0]  lastrd;
+
+  // integer source registers by opcode
+  always @* case(op)
+      7'b0110011,                                        // R-type
+      7'b0100011,                                        // sw
+      7'b1100011: {UsesRs1, UsesRs2} = 2'b11;            // beq
+      7'b0010011,                                        // I-type ALU
+      7'b0000011,                                        // lw
+      7'b1100111,                                        // jalr
+      7'b0000111,                                        // flw, flh (address)
+      7'b0100111: {UsesRs1, UsesRs2} = 2'b10;            // fsw, fsh (address)
+      7'b1010011: {UsesRs1, UsesRs2} = {Instr[31:27] == 5'b11110, 1'b0}; // fmv.w.x, fmv.h.x
+      7'b1110011: {UsesRs1, UsesRs2} = {~Instr[14], 1'b0};              // csr, register forms
+      default:    {UsesRs1, UsesRs2} = 2'b00;
+    endcase
+
+  assign LoadUse = lastint & (lastrd != 0) & (UsesRs1 & rs1 == lastrd | UsesRs2 & rs2 == lastrd) |
+                   lastfp & (FPReadA & rs1 == lastrd | FPReadB & rs2 == lastrd);
+
+  always @(posedge clk or posedge reset) begin
+    if (reset) begin
+      lastint <= 1'b0;
+      lastfp  <= 1'b0;
+    end else if (en) begin
+      lastint <= IntLoad;
+      lastfp  <= FPLoad;
+      lastrd  <= Instr[11:7];
+    end
+  end
+endmodule
@@ -0,0 +1,43 @@
+module lsu(input  [2:0]  funct3,
+           input  [1:0]  a,
+           input  [31:0] wd, rd,
+           output [3:0]  be,
+           output [31:0] wdata, rdata);
+
+  // load/store alignment for lb/lh/lw/lbu/lhu, sb/sh/sw and flh/fsh/flw/fsw
+  //   funct3[1:0] is the size (00 byte, 01 half, 10 word), funct3[2] = 1
+  //   zero-extends a load; a is the low bits of the byte address
+  //   stores replicate the byte/half in every lane and enable only the
+  //   addressed one(s), so the low bits of wdata are still the stored value
+  //   (MMIO devices and the testbenches look at WriteData[7:0] or [15:0])
+  //   accesses must be naturally aligned
+
+  reg [3:0]  be_reg;
+  reg [31:0] wdata_reg;
+  reg [31:0] rdata_reg;
+
+  wire [7:0]  ldbyte = rd[8*a +: 8];
+  wire [15:0] ldhalf = a[1] ? rd[31:16] : rd[15:0];
+
+  always @* case(funct3[1:0])
+      2'b00: begin // byte
+               be_reg    = 4'b0001 << a;
+               wdata_reg = {4{wd[7:0]}};
+               rdata_reg = {{24{ldbyte[7] & ~funct3[2]}}, ldbyte};
+             end
+      2'b01: begin // half
+               be_reg    = a[1] ? 4'b1100 : 4'b0011;
+               wdata_reg = {2{wd[15:0]}};
+               rdata_reg = {{16{ldhalf[15] & ~funct3[2]}}, ldhalf};
+             end
+      default: begin // word
+               be_reg    = 4'b1111;
+               wdata_reg = wd;
+               rdata_reg = rd;
+             end
+    endcase
+
+  assign be    = be_reg;
+  assign wdata = wdata_reg;
+  assign rdata = rdata_reg;
+endmodule
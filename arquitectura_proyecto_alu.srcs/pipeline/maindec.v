@@ -1,24 +1,37 @@
 module maindec(input  [6:0] op,
+               input  [2:0] funct3,
                output [1:0] ResultSrc,
                output MemWrite,
                output Branch, ALUSrc,
                output RegWrite, Jump,
-               output [1:0] ImmSrc, 
-               output [1:0] ALUOp); 
+               output [2:0] ImmSrc,
+               output [1:0] ALUOp,
+               output CSRAccess);
   
-  reg [10:0] controls; 
+  reg [12:0] controls;
 
   assign {RegWrite, ImmSrc, ALUSrc, MemWrite,
-          ResultSrc, Branch, ALUOp, Jump} = controls; 
+          ResultSrc, Branch, ALUOp, Jump, CSRAccess} = controls;
 
   always @* case(op)
-    // RegWrite_ImmSrc_ALUSrc_MemWrite_ResultSrc_Branch_ALUOp_Jump
-      7'b0000011: controls = 11'b1_00_1_0_01_0_00_0; // lw
-      7'b0100011: controls = 11'b0_01_1_1_00_0_00_0; // sw
-      7'b0110011: controls = 11'b1_xx_0_0_00_0_10_0; // R-type
-      7'b1100011: controls = 11'b0_10_0_0_00_1_01_0; // beq
-      7'b0010011: controls = 11'b1_00_1_0_00_0_10_0; // I-type ALU
-      7'b1101111: controls = 11'b1_11_0_0_10_0_00_1; // jal
-      default:    controls = 11'bx_xx_x_x_xx_x_xx_x; // non-implemented instruction
+    // RegWrite_ImmSrc_ALUSrc_MemWrite_ResultSrc_Branch_ALUOp_Jump_CSRAccess
+      7'b0000011: controls = 13'b1_000_1_0_01_0_00_0_0; // lb, lh, lw, lbu, lhu
+      7'b0100011: controls = 13'b0_001_1_1_00_0_00_0_0; // sb, sh, sw
+      7'b0110011: controls = 13'b1_xxx_0_0_00_0_10_0_0; // R-type
+      7'b1100011: controls = 13'b0_010_0_0_00_1_01_0_0; // beq, bne, blt, bge, bltu, bgeu
+      7'b0010011: controls = 13'b1_000_1_0_00_0_10_0_0; // I-type ALU
+      7'b0110111: controls = 13'b1_100_1_0_00_0_11_0_0; // lui
+      7'b0010111: controls = 13'b1_100_1_0_00_0_00_0_0; // auipc (PC + imm, SrcA = PC in the controller)
+      7'b1101111: controls = 13'b1_011_0_0_10_0_00_1_0; // jal
+      7'b1100111: controls = 13'b1_000_1_0_10_0_00_1_0; // jalr
+      7'b0000111: controls = 13'b0_000_1_0_00_0_00_0_0; // flw, flh (FP side in fpdec)
+      7'b0100111: controls = 13'b0_001_1_1_00_0_00_0_0; // fsw, fsh
+      7'b0001111: controls = 13'b0_000_0_0_00_0_00_0_0; // fence, fence.i: nops (one hart, in-order memory; the I-cache is not flushed)
+      7'b1010011: controls = 13'b0_xxx_x_0_11_0_xx_0_0; // OP-FP (fmv.x.* write enabled by fpdec)
+      7'b1110011: if (funct3[1:0] == 2'b00)
+                    controls = 13'b0_000_0_0_00_0_00_0_0; // ecall, ebreak: executed as nops
+                  else
+                    controls = 13'b1_xxx_x_0_11_0_xx_0_1; // csrrw, csrrs, csrrc (+ immediate forms)
+      default:    controls = 13'bx_xxx_x_x_xx_x_xx_x_x; // non-implemented instruction
     endcase
 endmodule
\ No newline at end of file
@@ -0,0 +1,71 @@
+module mainmem(input  clk, reset,
+               input  req, we,
+               input  [31:0] a,
+               input  [(32<<LINE_BITS)-1:0] wline,
+               output [(32<<LINE_BITS)-1:0] rline,
+               output ready);
+
+  // backing memory behind a cache: whole-line transfers with a fixed latency
+  //   the cache holds req (and a/we/wline) until ready is pulsed,
+  //   LATENCY cycles after the request started
+  //   a is a byte address, the offset inside the line is ignored
+  parameter MEMFILE   = "";  // optional $readmemh image
+  parameter ADDR_BITS = 14;  // 16K words = 64 KiB
+  parameter LINE_BITS = 2;   // 4 words per line
+  parameter LATENCY   = 10;  // cycles per line transfer
+
+  localparam LINE_WORDS = 1 << LINE_BITS;
+
+  reg [31:0] RAM[(1<<ADDR_BITS)-1:0];
+  reg [7:0]  count;
+
+  wire [ADDR_BITS-LINE_BITS-1:0] line = a[ADDR_BITS+1:LINE_BITS+2];
+
+  integer i;
+
+  initial begin
+    if (MEMFILE != "") $readmemh(MEMFILE,RAM);
+  end
+
+  assign ready = req & (count == LATENCY-1);
+
+  genvar g;
+  generate
+    for (g = 0; g < LINE_WORDS; g = g + 1) begin : rdword
+      assign rline[32*g+31:32*g] = RAM[line*LINE_WORDS + g];
+    end
+  endgenerate
+
+  always @(posedge clk or posedge reset) begin
+    if (reset)      count <= 0;
+    else if (ready) count <= 0;
+    else if (req)   count <= count + 1;
+  end
+
+`ifdef VERILATOR
+  // backdoor for the C++ harnesses (verilator/): load programs, read results
+  // addr is a word index
+  export "DPI-C" function mainmem_poke;
+  export "DPI-C" function mainmem_peek;
+  export "DPI-C" function mainmem_addr_bits;
+
+  function void mainmem_poke(input int addr, input int data);
+    RAM[addr[ADDR_BITS-1:0]] = data;
+  endfunction
+
+  function int mainmem_peek(input int addr);
+    return RAM[addr[ADDR_BITS-1:0]];
+  endfunction
+
+  // ADDR_BITS as built, so that a harness can reject an image that would wrap
+  function int mainmem_addr_bits();
+    return ADDR_BITS;
+  endfunction
+`endif
+
+  always @(posedge clk) begin
+    if (ready & we)
+      for (i = 0; i < LINE_WORDS; i = i + 1)
+        RAM[line*LINE_WORDS + i] <= wline[32*i +: 32];
+  end
+endmodule
@@ -0,0 +1,114 @@
+module mdu(input  clk, reset,
+           input  req, ack,
+           input  [2:0]  funct3,
+           input  [31:0] a, b,
+           output valid,
+           output [31:0] result);
+
+  // RV32M multiply/divide unit
+  //   funct3: 000 mul, 001 mulh, 010 mulhsu, 011 mulhu,
+  //           100 div, 101 divu, 110 rem,   111 remu
+  //   req is held while an M instruction waits; the unit latches a, b and
+  //   funct3 on the first cycle, raises valid with the result and keeps it
+  //   until ack (the instruction retires), then returns to idle
+  //
+  //   multiplier: 33x33 signed product in three register stages
+  //               (operands, product, output) so it maps on pipelined DSP blocks
+  //   divider:    restoring, one quotient bit per cycle on the magnitudes;
+  //               early-out skips the leading zeros of the dividend,
+  //               division by zero finishes in one cycle
+
+  localparam IDLE = 2'b00;
+  localparam MUL  = 2'b01;
+  localparam DIV  = 2'b10;
+  localparam DONE = 2'b11;
+
+  reg [1:0]  state;
+  reg [2:0]  op;
+  reg [5:0]  count;
+  reg [31:0] result_q;
+
+  // multiplier pipeline
+  reg signed [32:0] ma, mb;
+  reg signed [65:0] mp, mp_q;
+
+  // divider state
+  reg [31:0] rem_q, quo_q, ub_q;
+  reg        negq, negr;
+
+  wire asigned = (funct3 == 3'b001) | (funct3 == 3'b010) | (funct3 == 3'b100) | (funct3 == 3'b110);
+  wire bsigned = (funct3 == 3'b001) | (funct3 == 3'b100) | (funct3 == 3'b110);
+
+  wire        aneg = asigned & a[31];
+  wire        bneg = bsigned & b[31];
+  wire [31:0] ua   = aneg ? -a : a;
+  wire [31:0] ub   = bneg ? -b : b;
+
+  // leading zeros of the dividend magnitude (early-out)
+  integer    i;
+  reg [5:0]  lz;
+  always @* begin
+    lz = 32;
+    for (i = 0; i < 32; i = i + 1)
+      if (ua[i]) lz = 6'd31 - i[5:0];
+  end
+
+  // restoring step: shift in the next dividend bit and try to subtract
+  wire [32:0] rshift = {rem_q, quo_q[31]};
+  wire [32:0] diff   = rshift - {1'b0, ub_q};
+
+  wire [31:0] quo = negq ? -quo_q : quo_q;
+  wire [31:0] rem = negr ? -rem_q : rem_q;
+
+  assign valid  = state == DONE;
+  assign result = result_q;
+
+  // multiplier product and output stages run every cycle
+  always @(posedge clk) begin
+    mp   <= ma * mb;
+    mp_q <= mp;
+  end
+
+  always @(posedge clk or posedge reset) begin
+    if (reset) begin
+      state <= IDLE;
+    end else begin
+      case(state)
+        IDLE: if (req) begin
+                op <= funct3;
+                if (~funct3[2]) begin
+                  ma    <= {asigned & a[31], a};
+                  mb    <= {bsigned & b[31], b};
+                  count <= 2;
+                  state <= MUL;
+                end else if (b == 0) begin
+                  // x/0 = -1 (all ones), x%0 = x
+                  result_q <= funct3[1] ? a : 32'hFFFFFFFF;
+                  state    <= DONE;
+                end else begin
+                  rem_q <= 0;
+                  quo_q <= ua << lz;
+                  ub_q  <= ub;
+                  negq  <= aneg ^ bneg;
+                  negr  <= aneg;
+                  count <= 32 - lz;
+                  state <= DIV;
+                end
+              end
+        MUL:  if (count == 0) begin
+                result_q <= (op[1:0] == 2'b00) ? mp_q[31:0] : mp_q[63:32];
+                state    <= DONE;
+              end else count <= count - 1;
+        DIV:  if (count == 0) begin
+                result_q <= op[1] ? rem : quo;
+                state    <= DONE;
+              end else begin
+                rem_q <= diff[32] ? rshift[31:0] : diff[31:0];
+                quo_q <= {quo_q[30:0], ~diff[32]};
+                count <= count - 1;
+              end
+        DONE: if (ack) state <= IDLE;
+      endcase
+    end
+  end
+endmodule
@@ -0,0 +1,25 @@
+module regfile2w(input  clk, 
+                 input  we3, we6, 
+                 input  [ 4:0] a1, a2, a3, a4, a5, a6, 
+                 input  [31:0] wd3, wd6, 
+                 output [31:0] rd1, rd2, rd4, rd5); 
+
+  // integer register file of the dual-issue core: four read and two write ports
+  //   slot 0 reads A1/A2 and writes A3, slot 1 reads A4/A5 and writes A6
+  //   slot 1 is later in program order, so it wins if both write the same register
+
+  reg [31:0] rf[31:0]; 
+
+  // write ports on rising edge of clock (A3/WD3/WE3, A6/WD6/WE6)
+  always @(posedge clk) begin 
+    if (we3 & ~(we6 & a6 == a3)) rf[a3] <= wd3; 
+    if (we6)                     rf[a6] <= wd6; 
+  end
+  
+  // read four ports combinationally (A1/RD1, A2/RD2, A4/RD4, A5/RD5)
+  // register 0 hardwired to 0
+  assign rd1 = (a1 != 0) ? rf[a1] : 0; 
+  assign rd2 = (a2 != 0) ? rf[a2] : 0; 
+  assign rd4 = (a4 != 0) ? rf[a4] : 0; 
+  assign rd5 = (a5 != 0) ? rf[a5] : 0; 
+endmodule
@@ -1,50 +1,191 @@
 module riscvsingle(input  clk, reset,
+                   input  Stall,
+                   output FPStall,
+                   input  [1:0] CacheMiss,
                    output [31:0] PC,
                    input  [31:0] Instr,
-                   output MemWrite,
+                   input  [31:0] Instr1,
+                   input  Valid1,
+                   output MemWrite, MemRead,
+                   output [3:0] ByteEn,
                    output [31:0] DataAdr, 
                    output [31:0] WriteData,
                    input  [31:0] ReadData);
   
+  parameter DUAL_ISSUE = 0; // see dualslot.v
+
   wire [31:0] ALUResult; 
   
-  wire       ALUSrc, RegWrite, Jump, Zero; 
-  wire [1:0] ResultSrc, ImmSrc; 
-  wire [2:0] ALUControl; 
-  wire       PCSrc; 
+  wire       ALUSrc, ALUSrcA, RegWrite, Branch, Jump, JumpReg, Zero;
+  wire [1:0] ResultSrc;
+  wire [2:0] ImmSrc;
+  wire [3:0] ALUControl;
+  wire       MulDiv;
+  wire [1:0] PCSrc;
+  wire       CSRAccess;
+  wire       FPRegWrite, FPStore, FFlagsWrite, FPFmt;
+  wire [1:0] FPResultSrc, FPUControl;
+  wire       FPDiv, FPReadA, FPReadB;
+
+  wire [31:0] InstrX, Instr1X;
+  wire        Compressed, Compressed1, Issue1;
 
   // DataAdr is connected to ALUResult
   assign DataAdr = ALUResult;
 
+  // Instr holds the 32 bits fetched at PC (PC may be halfword aligned);
+  // a compressed instruction in its low half is expanded before decode
+  cdec cd(
+    .instr(Instr),
+    .instrx(InstrX),
+    .compressed(Compressed)
+  );
+
+  // dual issue: Instr1 holds the 32 bits after the slot 0 instruction,
+  // valid when the fetch could supply them
+  cdec cd1(
+    .instr(Instr1),
+    .instrx(Instr1X),
+    .compressed(Compressed1)
+  );
+
   controller c(
-    .op(Instr[6:0]), 
-    .funct3(Instr[14:12]), 
-    .funct7b5(Instr[30]), 
+    .op(InstrX[6:0]),
+    .funct3(InstrX[14:12]),
+    .funct7(InstrX[31:25]),
     .Zero(Zero),
     .ResultSrc(ResultSrc), 
     .MemWrite(MemWrite), 
+    .MemRead(MemRead),
     .PCSrc(PCSrc),
     .ALUSrc(ALUSrc), 
+    .ALUSrcA(ALUSrcA),
     .RegWrite(RegWrite), 
+    .Branch(Branch),
     .Jump(Jump),
+    .JumpReg(JumpReg),
     .ImmSrc(ImmSrc), 
-    .ALUControl(ALUControl)
+    .ALUControl(ALUControl),
+    .MulDiv(MulDiv),
+    .CSRAccess(CSRAccess),
+    .FPRegWrite(FPRegWrite),
+    .FPResultSrc(FPResultSrc),
+    .FPStore(FPStore),
+    .FFlagsWrite(FFlagsWrite),
+    .FPFmt(FPFmt),
+    .FPUControl(FPUControl),
+    .FPDiv(FPDiv),
+    .FPReadA(FPReadA),
+    .FPReadB(FPReadB)
   ); 
   
-  datapath dp(
+  datapath #(.DUAL_ISSUE(DUAL_ISSUE)) dp(
     .clk(clk), 
     .reset(reset), 
+    .Stall(Stall),
+    .CacheMiss(CacheMiss),
     .ResultSrc(ResultSrc), 
     .PCSrc(PCSrc),
     .ALUSrc(ALUSrc), 
+    .ALUSrcA(ALUSrcA),
     .RegWrite(RegWrite),
+    .Branch(Branch),
+    .Jump(Jump),
+    .JumpReg(JumpReg),
     .ImmSrc(ImmSrc), 
     .ALUControl(ALUControl),
+    .MulDiv(MulDiv),
+    .CSRAccess(CSRAccess),
+    .FPRegWrite(FPRegWrite),
+    .FPResultSrc(FPResultSrc),
+    .FPStore(FPStore),
+    .FFlagsWrite(FFlagsWrite),
+    .FPFmt(FPFmt),
+    .FPUControl(FPUControl),
+    .FPDiv(FPDiv),
+    .FPReadA(FPReadA),
+    .FPReadB(FPReadB),
+    .FPStall(FPStall),
     .Zero(Zero), 
     .PC(PC), 
-    .Instr(Instr),
+    .Instr(InstrX),
+    .Compressed(Compressed),
+    .Instr1(Instr1X),
+    .Valid1(Valid1),
+    .Compressed1(Compressed1),
+    .Issue1(Issue1),
     .ALUResult(ALUResult), 
     .WriteData(WriteData), 
+    .ByteEn(ByteEn),
     .ReadData(ReadData)
   ); 
+
+`ifdef VERILATOR
+  // hooks for the C++ harnesses (verilator/)
+  //   sim_retire:     once per instruction (twice, in order, for a dual-issued
+  //                   bundle), on the clock edge that commits it,
+  //                   with its encoding (the 16 bits of a compressed one),
+  //                   its integer/FP register write and its store
+  //                   (size in bytes, WriteData has the value in its low bits)
+  //                   (fdiv writes its register later, see sim_fpdiv_done)
+  //   sim_fpdiv_done: the multi-cycle divider writing the FP register file
+  //   sim_set_*:      architectural state backdoor, used to start the RTL
+  //                   from a state reached by the ISS (fast-forward)
+  import "DPI-C" function void sim_retire(input int pc, input int instr,
+                                          input bit we, input int rd, input int wd,
+                                          input bit fwe, input int frd, input int fwd,
+                                          input bit mwe, input int msize, input int madr, input int mwd);
+  import "DPI-C" function void sim_fpdiv_done(input int frd, input int fwd);
+
+  export "DPI-C" function sim_set_pc;
+  export "DPI-C" function sim_set_x;
+  export "DPI-C" function sim_set_f;
+  export "DPI-C" function sim_set_fcsr;
+  export "DPI-C" function sim_set_mcountinhibit;
+  export "DPI-C" function sim_set_mhpmevent;
+
+  function void sim_set_pc(input int pc);
+    dp.pcreg.q = pc;
+  endfunction
+
+  function void sim_set_x(input int r, input int v);
+    dp.regs.rf.rf[r[4:0]] = v;
+  endfunction
+
+  function void sim_set_f(input int r, input int v);
+    dp.fprf.rf[r[4:0]] = v;
+  endfunction
+
+  function void sim_set_fcsr(input int v);
+    dp.csrs.fflags = v[4:0];
+    dp.csrs.frm    = v[7:5];
+  endfunction
+
+  function void sim_set_mcountinhibit(input int v);
+    dp.csrs.mcountinhibit = v;
+  endfunction
+
+  // n is the counter number (mhpmevent3 = 3); an index past the NUM_HPM
+  // counters of csr.v is out of range and the write is ignored, as csr.v
+  // ignores a csrw to those mhpmevents
+  function void sim_set_mhpmevent(input int n, input int v);
+    if (n >= 3 && n < 32)
+      dp.csrs.hpmevent[n - 3] = v[3:0];
+  endfunction
+
+  always @(posedge clk) begin
+    if (~reset & ~dp.Hold)
+      sim_retire(PC, Compressed ? {16'b0, Instr[15:0]} : Instr,
+                 RegWrite, {27'b0, InstrX[11:7]}, dp.Result,
+                 FPRegWrite & ~FPDiv, {27'b0, InstrX[11:7]}, dp.FPResult,
+                 MemWrite, 32'd1 << InstrX[13:12], DataAdr, WriteData);
+    if (~reset & ~dp.Hold & Issue1)
+      sim_retire(dp.PCPlusLen, Compressed1 ? {16'b0, Instr1[15:0]} : Instr1,
+                 1'b1, {27'b0, Instr1X[11:7]}, dp.Result1,
+                 1'b0, 0, 0,
+                 1'b0, 0, 0, 0);
+    if (~reset & dp.DivDone)
+      sim_fpdiv_done({27'b0, dp.DivRd}, dp.DivResult);
+  end
+`endif
 endmodule
\ No newline at end of file
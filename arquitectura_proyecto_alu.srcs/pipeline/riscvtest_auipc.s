@@ -0,0 +1,36 @@
+# riscvtest_auipc.s
+#
+# Test auipc (zero, positive and negative immediates, and the la and call
+# pseudo-instructions the assembler expands to auipc + addi / auipc + jalr)
+# and fence, which must execute as a nop.
+# If successful, it should write the value 25 to address 100
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   addi  x2, x0, 0         # x2 = 0                   0         00000113
+        auipc x5, 0             # x5 = PC = 4              4         00000297
+        addi  x6, x0, 4         # x6 = 4                   8         00400313
+        bne   x5, x6, bad       # not taken                C         04629463
+        auipc x7, 1             # x7 = 0x1000 + 0x10       10        00001397
+        lui   x8, 1             # x8 = 0x1000              14        00001437
+        addi  x8, x8, 16        # x8 = 0x1010              18        01040413
+        bne   x7, x8, bad       # not taken                1C        02839C63
+        fence                   # nop                      20        0FF0000F
+        auipc x9, 0xFFFFF       # x9 = 0x24 - 0x1000       24        FFFFF497
+        lui   x10, 1            # x10 = 0x1000             28        00001537
+        add   x9, x9, x10       # x9 = 0x24                2C        00A484B3
+        addi  x10, x0, 36       # x10 = 0x24               30        02400513
+        bne   x9, x10, bad      # not taken                34        02A49063
+        auipc x11, 0            # la x11, f1               38        00000597
+        addi  x11, x11, 40      # x11 = 0x60               3C        02858593
+        jalr  x1, 0(x11)        # x2 = 12                  40        000580E7
+        auipc x1, 0             # call f2                  44        00000097
+        jalr  x1, 36(x1)        # x2 = 25                  48        024080E7
+        sw    x2, 100(x0)       # [100] = 25               4C        06202223
+done:   beq   x2, x2, done      # infinite loop            50        00210063
+bad:    addi  x12, x0, 1        # x12 = 1                  54        00100613
+        sw    x12, 100(x0)      # [100] = 1: failure       58        06C02223
+        beq   x0, x0, bad       # infinite loop            5C        FE000CE3
+f1:     addi  x2, x2, 12        # x2 += 12                 60        00C10113
+        jalr  x0, 0(x1)         # return                   64        00008067
+f2:     addi  x2, x2, 13        # x2 += 13                 68        00D10113
+        jalr  x0, 0(x1)         # return                   6C        00008067
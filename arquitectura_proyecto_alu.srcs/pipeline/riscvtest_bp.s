@@ -0,0 +1,20 @@
+# riscvtest_bp.s
+#
+# Test jalr and the branch predictor.
+#  a loop with a backward beq and a jal/jalr call per iteration
+# If successful, it should write the value 45 to address 100
+# after 10 branches (2 mispredicted) and 20 jumps (2 mispredicted)
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   addi x2, x0, 0          # x2 = sum = 0             0         00000113
+        addi x6, x0, 0          # x6 = i = 0               4         00000313
+        addi x7, x0, 10         # x7 = n = 10              8         00A00393
+        addi x9, x0, 1          # x9 = 1                   C         00100493
+loop:   jal  x1, step           # call step                10        018000EF
+        addi x6, x6, 1          # i = i + 1                14        00130313
+        slt  x8, x6, x7         # x8 = (i < n)             18        00732433
+        beq  x8, x9, loop       # backward, taken 9 times  1C        FE940AE3
+        sw   x2, 100(x0)        # [100] = 45               20        06202223
+done:   beq  x2, x2, done       # infinite loop            24        00210063
+step:   add  x2, x2, x6         # sum = sum + i            28        00610133
+        jalr x0, 0(x1)          # return                   2C        00008067
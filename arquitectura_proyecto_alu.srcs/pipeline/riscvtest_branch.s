@@ -0,0 +1,35 @@
+# riscvtest_branch.s
+#
+# Test blt, bge, bltu, bgeu (taken and not taken, with operands whose
+# signed and unsigned order differ) and sltu, sltiu.
+# If successful, it should write the value 25 to address 100
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   addi x4, x0, -1         # x4 = -1 (0xFFFFFFFF)     0         FFF00213
+        addi x5, x0, 1          # x5 = 1                   4         00100293
+        addi x2, x0, 0          # x2 = 0                   8         00000113
+        blt  x4, x5, t1         # -1 < 1: taken            C         00524463
+        addi x2, x2, 1          # skipped                  10        00110113
+t1:     bltu x4, x5, bad        # unsigned: not taken      14        04526A63
+        bge  x5, x4, t2         # 1 >= -1: taken           18        0042D463
+        addi x2, x2, 1          # skipped                  1C        00110113
+t2:     bgeu x5, x4, bad        # unsigned: not taken      20        0442F463
+        bgeu x4, x5, t3         # taken                    24        00527463
+        addi x2, x2, 1          # skipped                  28        00110113
+t3:     bge  x4, x5, bad        # -1 >= 1: not taken       2C        02525E63
+        bge  x5, x5, t4         # equal: taken             30        0052D463
+        addi x2, x2, 1          # skipped                  34        00110113
+t4:     blt  x5, x5, bad        # equal: not taken         38        0252C863
+        bltu x5, x4, t5         # unsigned: taken          3C        0042E463
+        addi x2, x2, 1          # skipped                  40        00110113
+t5:     sltu x6, x5, x4         # x6 = 1                   44        0042B333
+        sltiu x7, x4, 1         # x7 = 0                   48        00123393
+        sltiu x8, x0, 1         # x8 = 1 (seqz)            4C        00103413
+        add  x9, x6, x7         # x9 = 1                   50        007304B3
+        add  x9, x9, x8         # x9 = 2                   54        008484B3
+        addi x2, x2, 23         # x2 = 23                  58        01710113
+        add  x2, x2, x9         # x2 = 25                  5C        00910133
+        sw   x2, 100(x0)        # [100] = 25               60        06202223
+done:   beq  x2, x2, done       # infinite loop            64        00210063
+bad:    sw   x5, 100(x0)        # [100] = 1: failure       68        06502223
+        beq  x0, x0, bad        # infinite loop            6C        FE000EE3
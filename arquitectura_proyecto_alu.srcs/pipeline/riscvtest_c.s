@@ -0,0 +1,52 @@
+# riscvtest_c.s
+#
+# Test the RV32C extension (compressed instructions) and halfword-aligned fetch.
+#  c.li, c.lui, c.addi, c.addi16sp, c.addi4spn, c.mv, c.add, c.sub, c.xor,
+#  c.or, c.and, c.andi, c.slli, c.srli, c.srai, c.lw, c.sw, c.lwsp, c.swsp,
+#  c.j, c.jal, c.jr, c.beqz, c.bnez, c.nop
+# The 32-bit instructions at 0xA and 0x1A start in the middle of a word, the
+# ones at 0x3E and 0x4E also cross a 16-byte I-cache line. c.jal links PC+2.
+# If successful, it should write 670 to address 260, 0x10 to address 264
+# and then the value 112 (0x70) to address 100.
+# riscvtest_c.txt packs the code into little-endian words (two halves per word)
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   c.li x8, 5              # x8 = 5                   0         4415
+        c.li x9, -3             # x9 = -3                  2         54F5
+        c.add x8, x9            # x8 = 2                   4         9426
+        c.slli x8, 4            # x8 = 32                  6         0412
+        c.nop                   #                          8         0001
+        addi x11, x0, 700       # x11 = 700 (misaligned)   A         2BC00593
+        c.mv x10, x8            # x10 = 32                 E         8522
+        c.srai x9, 1            # x9 = -2                  10        8485
+        c.sub x8, x9            # x8 = 34                  12        8C05
+        c.xor x8, x11           # x8 = 34 ^ 700 = 670      14        8C2D
+        c.lui x12, 1            # x12 = 0x1000             16        6605
+        c.srli x12, 8           # x12 = 0x10               18        8221
+        addi x2, x0, 512        # x2 = 512 (misaligned)    1A        20000113
+        c.addi16sp x2, -256     # x2 = 256                 1E        7111
+        c.addi4spn x13, x2, 8   # x13 = 264                20        0034
+        c.swsp x8, 4(x2)        # [260] = 670              22        C222
+        c.lwsp x14, 4(x2)       # x14 = 670                24        4712
+        c.sw x12, 0(x13)        # [264] = 0x10             26        C290
+        c.lw x15, 0(x13)        # x15 = 0x10               28        429C
+        c.jal func              # x1 = 0x2C, x10 = 33      2A        202D
+        c.li x13, 10            # x13 = 10                 2C        46A9
+        c.li x14, 0             # x14 = 0                  2E        4701
+loop:   c.add x14, x13          # x14 = x14 + x13          30        9736
+        c.addi x13, -1          # x13 = x13 - 1            32        16FD
+        c.bnez x13, loop        # loop 10 times, x14 = 55  34        FEF5
+        c.beqz x13, skip        # taken                    36        C291
+        c.li x14, 0             # shouldn't execute        38        4701
+skip:   c.nop                   #                          3A        0001
+        c.nop                   #                          3C        0001
+        sub  x5, x14, x9        # x5 = 57 (crosses a line) 3E        409702B3
+        c.andi x14, 15          # x14 = 7                  42        8B3D
+        c.or x14, x15           # x14 = 23                 44        8F5D
+        c.and x9, x14           # x9 = 22                  46        8CF9
+        add  x14, x5, x10       # x14 = 90                 48        00A28733
+        c.add x14, x9           # x14 = 112                4C        9726
+        sw   x14, 100(x0)       # [100] = 112 (cross-line) 4E        06E02223
+done:   c.j  done               # infinite loop            52        A001
+func:   c.addi x10, 1           # x10 = 33                 54        0505
+        c.jr x1                 # return to 0x2C           56        8082
@@ -0,0 +1,29 @@
+# riscvtest_cache.s
+#
+# Test the caches with a 512-byte array, twice the D-cache size.
+#  fills a[i] = i for i = 0..127 at 0x400, then sums it back
+# If successful, it should write the value 8128 to address 100
+# With the default D-cache (8 sets x 2 ways x 16 B) every set sees
+# 4 lines per pass: 64 misses and 32 dirty writebacks in total
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   addi x3, x0, 1024       # x3 = p = 0x400           0         40000193
+        addi x4, x0, 0          # x4 = i = 0               4         00000213
+        addi x5, x0, 128        # x5 = n = 128             8         08000293
+        addi x9, x0, 1          # x9 = 1                   C         00100493
+fill:   sw   x4, 0(x3)          # a[i] = i                 10        0041A023
+        addi x3, x3, 4          # p = p + 4                14        00418193
+        addi x4, x4, 1          # i = i + 1                18        00120213
+        slt  x8, x4, x5         # x8 = (i < n)             1C        00522433
+        beq  x8, x9, fill       # loop 128 times           20        FE9408E3
+        addi x3, x0, 1024       # p = 0x400                24        40000193
+        addi x4, x0, 0          # i = 0                    28        00000213
+        addi x2, x0, 0          # x2 = sum = 0             2C        00000113
+sum:    lw   x6, 0(x3)          # x6 = a[i]                30        0001A303
+        add  x2, x2, x6         # sum = sum + a[i]         34        00610133
+        addi x3, x3, 4          # p = p + 4                38        00418193
+        addi x4, x4, 1          # i = i + 1                3C        00120213
+        slt  x8, x4, x5         # x8 = (i < n)             40        00522433
+        beq  x8, x9, sum        # loop 128 times           44        FE9406E3
+        sw   x2, 100(x0)        # [100] = 8128             48        06202223
+done:   beq  x2, x2, done       # infinite loop            4C        00210063
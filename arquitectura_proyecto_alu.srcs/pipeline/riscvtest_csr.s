@@ -0,0 +1,37 @@
+# riscvtest_csr.s
+#
+# Test the Zicntr/Zihpm counters.
+#  minstret around a loop, hpmcounter3 on mispredicts,
+#  hpmcounter4 on load-use, cycle around one instruction
+# If successful, it should write 35, 2 and 5 to addresses 104, 108
+# and 112, the cycle delta to 116 and then the value 10 to address 100
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   addi x1, x0, 1          # x1 = 1                   0         00100093
+        csrrw x0, mhpmevent3, x1 # hpm3: mispredicts        4         32309073
+        addi x1, x0, 2          # x1 = 2                   8         00200093
+        csrrw x0, mhpmevent4, x1 # hpm4: load-use           C         32409073
+        csrrs x10, minstret, x0 # x10 = instret at start   10        B0202573
+        addi x6, x0, 0          # x6 = i = 0               14        00000313
+        addi x7, x0, 5          # x7 = n = 5               18        00500393
+        addi x9, x0, 1          # x9 = 1                   1C        00100493
+        addi x2, x0, 0          # x2 = sum = 0             20        00000113
+loop:   sw   x6, 96(x0)         # [96] = i                 24        06602023
+        lw   x5, 96(x0)         # x5 = i                   28        06002283
+        add  x2, x2, x5         # load-use on x5           2C        00510133
+        addi x6, x6, 1          # i = i + 1                30        00130313
+        slt  x8, x6, x7         # x8 = (i < n)             34        00732433
+        beq  x8, x9, loop       # taken 4 times            38        FE9406E3
+        csrrs x11, minstret, x0 # x11 = instret at end     3C        B02025F3
+        csrrs x13, hpmcounter3, x0 # 2                        40        C03026F3
+        csrrs x14, hpmcounter4, x0 # 5                        44        C0402773
+        csrrs x15, cycle, x0    # x15 = cycle              48        C00027F3
+        csrrs x16, cycle, x0    # x16 = cycle              4C        C0002873
+        sub  x12, x11, x10      # x12 = 35 instructions    50        40A58633
+        sub  x17, x16, x15      # x17 = cycles per csrrs   54        40F808B3
+        sw   x12, 104(x0)       # [104] = 35               58        06C02423
+        sw   x13, 108(x0)       # [108] = 2                5C        06D02623
+        sw   x14, 112(x0)       # [112] = 5                60        06E02823
+        sw   x17, 116(x0)       # [116] = cycles           64        07102A23
+        sw   x2, 100(x0)        # [100] = 10               68        06202223
+done:   beq  x2, x2, done       # infinite loop            6C        00210063
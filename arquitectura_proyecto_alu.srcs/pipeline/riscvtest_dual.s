@@ -0,0 +1,41 @@
+# riscvtest_dual.s
+#
+# Test the dual-issue core (top with DUAL_ISSUE = 1, CACHES = 0).
+# An integer ALU instruction (R-type, I-type ALU, lui) issues together with
+# the instruction before it unless that one is a branch/jump or writes one
+# of its sources. "| pair" marks the bundles; the loop runs 5 instructions
+# in 3 cycles, so 53 instructions between the csrr take 31 cycles (51 on
+# the single-issue core).
+# If successful, it should write 45 to address 104, 53 to address 108,
+# 31 to address 112 and then the value 309 (0x135) to address 100.
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   addi x1, x0, 0          # x1 = 0 (i)     | pair    0         00000093
+        addi x2, x0, 10         # x2 = 10 (n)              4         00A00113
+        addi x3, x0, 0          # x3 = 0 (sum)   | pair    8         00000193
+        addi x4, x0, 128        # x4 = 128 (p)             C         08000213
+        csrr x20, instret       # x20 = 4                  10        C0202A73
+        csrr x21, cycle         # x21 = start cycle        14        C0002AF3
+loop:   sw   x1, 0(x4)          # [p] = i        | pair    18        00122023
+        addi x4, x4, 4          # p += 4                   1C        00420213
+        add  x3, x3, x1         # sum += i       | pair    20        001181B3
+        addi x1, x1, 1          # i++                      24        00108093
+        bne  x1, x2, loop       # 3 cycles per iteration   28        FE2098E3
+        csrr x22, cycle         # x22 = end cycle          2C        C0002B73
+        csrr x23, instret       # x23 = 57       | pair    30        C0202BF3
+        addi x5, x0, 3          # x5 = 3                   34        00300293
+        add  x6, x5, x5         # x6 = 6 (reads x5)        38        00528333
+        lw   x7, 128(x0)        # x7 = [128]     | pair    3C        08002383
+        addi x7, x0, 2          # x7 = 2 (WAW, wins)       40        00200393
+        lui  x8, 1              # x8 = 0x1000              44        00001437
+        srai x9, x8, 4          # x9 = 0x100     | pair    48        40445493
+        sub  x24, x23, x20      # x24 = 53 instructions    4C        414B8C33
+        sub  x25, x22, x21      # x25 = 31 cycles          50        415B0CB3
+        sw   x3, 104(x0)        # [104] = 45               54        06302423
+        sw   x24, 108(x0)       # [108] = 53               58        07802623
+        sw   x25, 112(x0)       # [112] = 31     | pair    5C        07902823
+        add  x3, x3, x6         # x3 = 51                  60        006181B3
+        add  x3, x3, x7         # x3 = 53 (reads x3)       64        007181B3
+        add  x3, x3, x9         # x3 = 309                 68        009181B3
+        sw   x3, 100(x0)        # [100] = 309 = 0x135      6C        06302223
+done:   beq  x3, x3, done       # infinite loop            70        00318063
@@ -0,0 +1,50 @@
+# riscvtest_fp.s
+#
+# Test the F/Zfh coprocessor.
+#  flw, flh, fsw, fsh, fadd/fsub/fmul/fdiv .s and .h, fmv.x.w, fmv.x.h,
+#  fmv.w.x, fmv.h.x, csrrw, csrrs, csrrwi on fflags/frm/fcsr
+# If successful, it should write 0x3FC00000 to address 104
+# and then the value 0x4121 to address 100
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   addi x1, x0, 15         # x1 = 0xF                 0         00F00093
+        addi x6, x0, 10         # 10 doublings             4         00A00313
+hshl:   add  x1, x1, x1         # x1 <<= 1                 8         001080B3
+        addi x6, x6, -1         #                          C         FFF30313
+        beq  x6, x0, hdone      #                          10        00030463
+        jal  x0, hshl           #                          14        FF5FF06F
+hdone:  fmv.h.x f1, x1          # f1 = 1.0h (0x3C00)       18        F40080D3
+        fadd.h f2, f1, f1       # f2 = 2.0h (0x4000)       1C        04108153
+        fadd.h f3, f2, f1       # f3 = 3.0h (0x4200)       20        041101D3
+        fmul.h f4, f3, f2       # f4 = 6.0h (0x4600)       24        14218253
+        fsub.h f5, f4, f1       # f5 = 5.0h (0x4500)       28        0C1202D3
+        fsh  f5, 96(x0)         # [96] = 0x4500            2C        06501027
+        flh  f6, 96(x0)         # f6 = 5.0h                30        06001307
+        fdiv.h f7, f6, f2       # f7 = 2.5h (0x4100)       34        1C2303D3
+        fmv.x.h x2, f7          # x2 = 0x4100              38        E4038153
+        csrrs x3, fflags, x0    # x3 = 0 (all exact)       3C        001021F3
+        fdiv.h f8, f1, f3       # 1/3 sets NX              40        1C308453
+        csrrs x4, fflags, x0    # x4 = 1                   44        00102273
+        csrrw x0, fflags, x0    # clear fflags             48        00101073
+        addi x5, x0, 0x3F8      # x5 = 0x3F8               4C        3F800293
+        addi x6, x0, 20         # 20 doublings             50        01400313
+sshl:   add  x5, x5, x5         # x5 <<= 1                 54        005282B3
+        addi x6, x6, -1         #                          58        FFF30313
+        beq  x6, x0, sdone      #                          5C        00030463
+        jal  x0, sshl           #                          60        FF5FF06F
+sdone:  fmv.w.x f9, x5          # f9 = 1.0 (0x3F800000)    64        F00284D3
+        fadd.s f10, f9, f9      # f10 = 2.0                68        00948553
+        fmul.s f11, f10, f10    # f11 = 4.0                6C        10A505D3
+        fsub.s f11, f11, f9     # f11 = 3.0                70        089585D3
+        fsw  f11, 96(x0)        # [96] = 0x40400000        74        06B02027
+        flw  f12, 96(x0)        # f12 = 3.0                78        06002607
+        fdiv.s f13, f12, f10    # f13 = 1.5 (0x3FC00000)   7C        18A606D3
+        fmv.x.w x7, f13         # x7 = 0x3FC00000          80        E00683D3
+        csrrwi x0, frm, 1       # frm = 1                  84        0020D073
+        csrrs x8, fcsr, x0      # x8 = 0x20                88        00302473
+        add  x2, x2, x3         # x2 = 0x4100              8C        00310133
+        add  x2, x2, x4         # x2 = 0x4101              90        00410133
+        add  x2, x2, x8         # x2 = 0x4121              94        00810133
+        sw   x7, 104(x0)        # [104] = 0x3FC00000       98        06702423
+        sw   x2, 100(x0)        # [100] = 0x4121           9C        06202223
+done:   beq  x2, x2, done       # infinite loop            A0        00210063
@@ -0,0 +1,33 @@
+# riscvtest_fpdiv.s
+#
+# Test the multi-cycle fdiv and the FP scoreboard.
+#  independent integer and FP instructions issue while fdiv.s runs,
+#  fmv.x.w of its destination and the fflags read wait for it
+# If successful, it should write 0x3EAAAAAB to address 104,
+# 0x41400000 to address 108 and then the value 4 to address 100
+# With the default 8-cycle divider the core stalls for 3 cycles
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   addi x1, x0, 0x3F8      # x1 = 0x3F8               0         3F800093
+        addi x6, x0, 20         # 20 doublings             4         01400313
+shl:    add  x1, x1, x1         # x1 <<= 1                 8         001080B3
+        addi x6, x6, -1         #                          C         FFF30313
+        beq  x6, x0, go         #                          10        00030463
+        jal  x0, shl            #                          14        FF5FF06F
+go:     fmv.w.x f1, x1          # f1 = 1.0 (0x3F800000)    18        F00080D3
+        fadd.s f2, f1, f1       # f2 = 2.0                 1C        00108153
+        fadd.s f3, f2, f1       # f3 = 3.0                 20        001101D3
+        fdiv.s f4, f1, f3       # f4 = 1/3, in the background 24        18308253
+        addi x2, x0, 1          # independent integer work 28        00100113
+        addi x3, x0, 2          #                          2C        00200193
+        add  x4, x2, x3         # x4 = 3                   30        00310233
+        fadd.s f5, f3, f3       # independent FP: f5 = 6.0 34        003182D3
+        fmul.s f6, f5, f2       # f6 = 12.0                38        10228353
+        fmv.x.w x7, f4          # waits for fdiv: 0x3EAAAAAB 3C        E00203D3
+        csrrs x8, fflags, x0    # x8 = 1 (NX from 1/3)     40        00102473
+        fmv.x.w x9, f6          # x9 = 0x41400000          44        E00304D3
+        sw   x7, 104(x0)        # [104] = 0x3EAAAAAB       48        06702423
+        sw   x9, 108(x0)        # [108] = 0x41400000       4C        06902623
+        add  x8, x8, x4         # x8 = 4                   50        00440433
+        sw   x8, 100(x0)        # [100] = 4                54        06802223
+done:   beq  x8, x8, done       # infinite loop            58        00840063
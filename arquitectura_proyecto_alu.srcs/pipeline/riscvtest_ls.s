@@ -0,0 +1,31 @@
+# riscvtest_ls.s
+#
+# Test byte and halfword loads and stores.
+#  sb, sh, lb, lh, lbu, lhu, with sign and zero extension,
+#  building one word out of byte and halfword stores
+# If successful, it should write 0xFFFE8055 to address 104
+# and then the value 32934 (0x80A6) to address 100
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   addi x1, x0, -128       # x1 = 0xFFFFFF80          0         F8000093
+        addi x2, x0, -2         # x2 = 0xFFFFFFFE          4         FFE00113
+        addi x3, x0, 0x55       # x3 = 0x55                8         05500193
+        sw   x0, 128(x0)        # [128] = 0                C         08002023
+        sb   x1, 129(x0)        # [128] = 0x00008000       10        081000A3
+        sh   x2, 130(x0)        # [128] = 0xFFFE8000       14        08201123
+        sb   x3, 128(x0)        # [128] = 0xFFFE8055       18        08300023
+        lw   x4, 128(x0)        # x4 = 0xFFFE8055          1C        08002203
+        lb   x5, 129(x0)        # x5 = -128                20        08100283
+        lbu  x6, 129(x0)        # x6 = 128                 24        08104303
+        lh   x7, 130(x0)        # x7 = -2                  28        08201383
+        lhu  x8, 130(x0)        # x8 = 65534               2C        08205403
+        lh   x9, 128(x0)        # x9 = -32683              30        08001483
+        lbu  x10, 128(x0)       # x10 = 85                 34        08004503
+        sw   x4, 104(x0)        # [104] = 0xFFFE8055       38        06402423
+        add  x11, x5, x6        # x11 = 0                  3C        006285B3
+        add  x11, x11, x7       # x11 = -2                 40        007585B3
+        add  x11, x11, x8       # x11 = 65532              44        008585B3
+        add  x11, x11, x9       # x11 = 32849              48        009585B3
+        add  x11, x11, x10      # x11 = 32934 = 0x80A6     4C        00A585B3
+        sw   x11, 100(x0)       # [100] = 0x80A6           50        06B02223
+done:   beq  x11, x11, done     # infinite loop            54        00B58063
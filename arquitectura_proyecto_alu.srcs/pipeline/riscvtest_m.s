@@ -0,0 +1,45 @@
+# riscvtest_m.s
+#
+# Test the RV32M extension.
+#  mul, mulh, mulhsu, mulhu, div, divu, rem, remu,
+#  including division by zero and the signed overflow case
+# If successful, it should write 0x55555553 to address 104
+# and then the value 0x15555533 to address 100
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   addi x1, x0, -7         # x1 = -7                  0         FF900093
+        addi x2, x0, 3          # x2 = 3                   4         00300113
+        mul  x4, x1, x2         # x4 = -21                 8         02208233
+        mulh x5, x1, x2         # x5 = -1                  C         022092B3
+        mulhu x6, x1, x2        # x6 = 2                   10        0220B333
+        mulhsu x7, x1, x2       # x7 = -1                  14        0220A3B3
+        div  x8, x1, x2         # x8 = -2                  18        0220C433
+        rem  x9, x1, x2         # x9 = -1                  1C        0220E4B3
+        divu x10, x1, x2        # x10 = 0x55555553         20        0220D533
+        remu x11, x1, x2        # x11 = 0                  24        0220F5B3
+        div  x12, x1, x0        # x12 = -1 (divide by zero) 28        0200C633
+        rem  x13, x1, x0        # x13 = -7                 2C        0200E6B3
+        addi x19, x0, 256       # x19 = 256                30        10000993
+        addi x20, x0, 128       # x20 = 128                34        08000A13
+        mul  x18, x19, x19      # x18 = 0x10000            38        03398933
+        mul  x20, x20, x19      # x20 = 0x8000             3C        033A0A33
+        mul  x17, x20, x18      # x17 = 0x80000000         40        032A08B3
+        addi x21, x0, -1        # x21 = -1                 44        FFF00A93
+        div  x16, x17, x21      # x16 = 0x80000000 (overflow) 48        0358C833
+        rem  x22, x17, x21      # x22 = 0                  4C        0358EB33
+        mulhu x23, x17, x17     # x23 = 0x40000000         50        0318BBB3
+        add  x3, x4, x5         # x3 = sum of x4..x13, x16, x22, x23 54        005201B3
+        add  x3, x3, x6         #                          58        006181B3
+        add  x3, x3, x7         #                          5C        007181B3
+        add  x3, x3, x8         #                          60        008181B3
+        add  x3, x3, x9         #                          64        009181B3
+        add  x3, x3, x10        #                          68        00A181B3
+        add  x3, x3, x11        #                          6C        00B181B3
+        add  x3, x3, x12        #                          70        00C181B3
+        add  x3, x3, x13        #                          74        00D181B3
+        add  x3, x3, x16        #                          78        010181B3
+        add  x3, x3, x22        #                          7C        016181B3
+        add  x3, x3, x23        #                          80        017181B3
+        sw   x10, 104(x0)       # [104] = 0x55555553       84        06A02423
+        sw   x3, 100(x0)        # [100] = 0x15555533       88        06302223
+done:   beq  x3, x3, done       # infinite loop            8C        00318063
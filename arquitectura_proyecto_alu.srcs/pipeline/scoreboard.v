@@ -0,0 +1,30 @@
+module scoreboard(input  clk, reset,
+                  // long-latency FP op leaving issue / writing back
+                  input  issue,
+                  input  [4:0] issuerd,
+                  input  complete,
+                  input  [4:0] completerd,
+                  // FP registers used by the instruction being issued
+                  input  reada, readb, write,
+                  input  [4:0] ra, rb, rw,
+                  output hazard,
+                  output pending);
+
+  // one bit per FP register: set while a long-latency op will still write it
+  //   hazard = RAW on ra/rb or WAW on rw against an op in flight
+  //   pending = some op is in flight (used to keep fflags reads in order)
+  // a register is cleared on the cycle after its write-back
+
+  reg [31:0] busy;
+
+  assign hazard  = reada & busy[ra] | readb & busy[rb] | write & busy[rw];
+  assign pending = |busy;
+
+  always @(posedge clk or posedge reset) begin
+    if (reset) busy <= 32'b0;
+    else begin
+      if (complete) busy[completerd] <= 1'b0;
+      if (issue)    busy[issuerd]    <= 1'b1;
+    end
+  end
+endmodule
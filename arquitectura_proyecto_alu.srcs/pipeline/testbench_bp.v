@@ -0,0 +1,48 @@
+module testbench_bp;
+  reg          clk;
+  reg          reset;
+  wire [31:0]  WriteData;
+  wire [31:0]  DataAdr;
+  wire         MemWrite;
+  
+  // instantiate device to be tested, running the branch predictor program
+  top #(.MEMFILE("riscvtest_bp.txt")) dut(
+    .clk(clk), 
+    .reset(reset), 
+    .WriteData(WriteData), 
+    .DataAdr(DataAdr), 
+    .MemWrite(MemWrite)
+  );
+
+  // initialize test
+  initial begin
+    reset = 1; # 22;
+    reset = 0;
+  end
+
+  // generate clock to sequence tests
+  always begin
+    clk = 1;
+    # 5; clk = 0; # 5;
+  end
+
+  // check results: the sum and the predictor statistics of the default
+  // bimodal configuration (cold BTB miss and loop exit on the beq,
+  // cold BTB miss on the jal and on the first return)
+  always @(negedge clk) begin
+    if(MemWrite) begin
+      $display("branches %0d (%0d mispredicted), jumps %0d (%0d mispredicted)",
+               dut.rvsingle.dp.bp.BranchCount, dut.rvsingle.dp.bp.BranchMiss,
+               dut.rvsingle.dp.bp.JumpCount, dut.rvsingle.dp.bp.JumpMiss);
+      if(DataAdr === 100 & WriteData === 45 &
+         dut.rvsingle.dp.bp.BranchCount === 10 & dut.rvsingle.dp.bp.BranchMiss === 2 &
+         dut.rvsingle.dp.bp.JumpCount === 20 & dut.rvsingle.dp.bp.JumpMiss === 2) begin
+        $display("Simulation succeeded");
+        $stop;
+      end else begin
+        $display("Simulation failed");
+        $stop;
+      end
+    end
+  end
+endmodule
@@ -0,0 +1,41 @@
+module testbench_branch;
+  reg          clk;
+  reg          reset;
+  wire [31:0]  WriteData;
+  wire [31:0]  DataAdr;
+  wire         MemWrite;
+  
+  // instantiate device to be tested, running the branch program
+  top #(.MEMFILE("riscvtest_branch.txt")) dut(
+    .clk(clk), 
+    .reset(reset), 
+    .WriteData(WriteData), 
+    .DataAdr(DataAdr), 
+    .MemWrite(MemWrite)
+  );
+
+  // initialize test
+  initial begin
+    reset = 1; # 22;
+    reset = 0;
+  end
+
+  // generate clock to sequence tests
+  always begin
+    clk = 1;
+    # 5; clk = 0; # 5;
+  end
+
+  // check results: every branch and sltu/sltiu right gives 25 at [100]
+  always @(negedge clk) begin
+    if(MemWrite) begin
+      if(DataAdr === 100 & WriteData === 25) begin
+        $display("Simulation succeeded");
+        $stop;
+      end else begin
+        $display("Simulation failed: [%0d] = %0d", DataAdr, WriteData);
+        $stop;
+      end
+    end
+  end
+endmodule
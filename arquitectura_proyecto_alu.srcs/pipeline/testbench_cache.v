@@ -0,0 +1,48 @@
+module testbench_cache;
+  reg          clk;
+  reg          reset;
+  wire [31:0]  WriteData;
+  wire [31:0]  DataAdr;
+  wire         MemWrite;
+  
+  // instantiate device to be tested, running the array program
+  top #(.MEMFILE("riscvtest_cache.txt")) dut(
+    .clk(clk), 
+    .reset(reset), 
+    .WriteData(WriteData), 
+    .DataAdr(DataAdr), 
+    .MemWrite(MemWrite)
+  );
+
+  // initialize test
+  initial begin
+    reset = 1; # 22;
+    reset = 0;
+  end
+
+  // generate clock to sequence tests
+  always begin
+    clk = 1;
+    # 5; clk = 0; # 5;
+  end
+
+  // check results: the sum and the D-cache statistics (see riscvtest_cache.s)
+  always @(negedge clk) begin
+    if(MemWrite) begin
+      if(DataAdr === 100) begin
+        $display("I-cache: %0d hits, %0d misses",
+                 dut.mem.IHits, dut.mem.IMisses);
+        $display("D-cache: %0d hits, %0d misses, %0d writebacks",
+                 dut.mem.DHits, dut.mem.DMisses, dut.mem.DWritebacks);
+        if(WriteData === 8128 & dut.mem.DMisses === 64 & dut.mem.DWritebacks === 32)
+          $display("Simulation succeeded");
+        else
+          $display("Simulation failed");
+        $stop;
+      end else if (DataAdr < 32'h400 | DataAdr >= 32'h600) begin
+        $display("Simulation failed");
+        $stop;
+      end
+    end
+  end
+endmodule
@@ -0,0 +1,46 @@
+module testbench_csr;
+  reg          clk;
+  reg          reset;
+  wire [31:0]  WriteData;
+  wire [31:0]  DataAdr;
+  wire         MemWrite;
+  
+  // instantiate device to be tested, running the counter program
+  top #(.MEMFILE("riscvtest_csr.txt")) dut(
+    .clk(clk), 
+    .reset(reset), 
+    .WriteData(WriteData), 
+    .DataAdr(DataAdr), 
+    .MemWrite(MemWrite)
+  );
+
+  // initialize test
+  initial begin
+    reset = 1; # 22;
+    reset = 0;
+  end
+
+  // generate clock to sequence tests
+  always begin
+    clk = 1;
+    # 5; clk = 0; # 5;
+  end
+
+  // check results: instret delta, mispredicts and load-use events
+  always @(negedge clk) begin
+    if(MemWrite) begin
+      if(DataAdr === 100 & WriteData === 10) begin
+        $display("Simulation succeeded");
+        $stop;
+      end else if (DataAdr === 116) begin
+        $display("cycle delta of one csrrs: %0d", WriteData);
+      end else if ((DataAdr === 104 & WriteData !== 35) |
+                   (DataAdr === 108 & WriteData !== 2) |
+                   (DataAdr === 112 & WriteData !== 5) |
+                   (DataAdr !== 96 & DataAdr !== 104 & DataAdr !== 108 & DataAdr !== 112)) begin
+        $display("Simulation failed");
+        $stop;
+      end
+    end
+  end
+endmodule
@@ -0,0 +1,51 @@
+module testbench_dual;
+  reg          clk;
+  reg          reset;
+  wire [31:0]  WriteData;
+  wire [31:0]  DataAdr;
+  wire         MemWrite;
+  
+  // instantiate device to be tested, the dual-issue core on imem/dmem
+  top #(.MEMFILE("riscvtest_dual.txt"), .CACHES(0), .DUAL_ISSUE(1)) dut(
+    .clk(clk), 
+    .reset(reset), 
+    .WriteData(WriteData), 
+    .DataAdr(DataAdr), 
+    .MemWrite(MemWrite)
+  );
+
+  // initialize test
+  initial begin
+    reset = 1; # 22;
+    reset = 0;
+  end
+
+  // generate clock to sequence tests
+  always begin
+    clk = 1;
+    # 5; clk = 0; # 5;
+  end
+
+  // check results: the loop stores to [128..164], [104] gets the sum,
+  // [108]/[112] the instructions and cycles of the measured section
+  always @(negedge clk) begin
+    if(MemWrite) begin
+      if(DataAdr === 100 & WriteData === 32'h135) begin
+        $display("Simulation succeeded");
+        $stop;
+      end else if (DataAdr === 104 & WriteData !== 45) begin
+        $display("Simulation failed: sum %0d", WriteData);
+        $stop;
+      end else if (DataAdr === 108 & WriteData !== 53 |
+                   DataAdr === 112 & WriteData !== 31) begin
+        $display("Simulation failed: %0d at %0d (53 instructions in 31 cycles expected)",
+                 WriteData, DataAdr);
+        $stop;
+      end else if (DataAdr !== 104 & DataAdr !== 108 & DataAdr !== 112 &
+                   (DataAdr < 128 | DataAdr > 164)) begin
+        $display("Simulation failed");
+        $stop;
+      end
+    end
+  end
+endmodule
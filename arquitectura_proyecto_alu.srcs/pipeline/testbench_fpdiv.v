@@ -0,0 +1,49 @@
+module testbench_fpdiv;
+  reg          clk;
+  reg          reset;
+  wire [31:0]  WriteData;
+  wire [31:0]  DataAdr;
+  wire         MemWrite;
+  integer      stalls;
+  
+  // instantiate device to be tested, without caches so that the
+  // only stalls are the ones caused by the divider
+  top #(.MEMFILE("riscvtest_fpdiv.txt"), .CACHES(0)) dut(
+    .clk(clk), 
+    .reset(reset), 
+    .WriteData(WriteData), 
+    .DataAdr(DataAdr), 
+    .MemWrite(MemWrite)
+  );
+
+  // initialize test
+  initial begin
+    stalls = 0;
+    reset = 1; # 22;
+    reset = 0;
+  end
+
+  // generate clock to sequence tests
+  always begin
+    clk = 1;
+    # 5; clk = 0; # 5;
+  end
+
+  // check results
+  always @(negedge clk) begin
+    if (dut.FPStall) stalls = stalls + 1;
+    if(MemWrite) begin
+      if(DataAdr === 100 & WriteData === 4) begin
+        $display("FP stall cycles: %0d", stalls);
+        if (stalls === 3) $display("Simulation succeeded");
+        else              $display("Simulation failed");
+        $stop;
+      end else if ((DataAdr === 104 & WriteData !== 32'h3EAAAAAB) |
+                   (DataAdr === 108 & WriteData !== 32'h41400000) |
+                   (DataAdr !== 104 & DataAdr !== 108)) begin
+        $display("Simulation failed");
+        $stop;
+      end
+    end
+  end
+endmodule
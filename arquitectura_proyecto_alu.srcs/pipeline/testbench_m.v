@@ -0,0 +1,44 @@
+module testbench_m;
+  reg          clk;
+  reg          reset;
+  wire [31:0]  WriteData;
+  wire [31:0]  DataAdr;
+  wire         MemWrite;
+  
+  // instantiate device to be tested, running the RV32M program
+  top #(.MEMFILE("riscvtest_m.txt")) dut(
+    .clk(clk), 
+    .reset(reset), 
+    .WriteData(WriteData), 
+    .DataAdr(DataAdr), 
+    .MemWrite(MemWrite)
+  );
+
+  // initialize test
+  initial begin
+    reset = 1; # 22;
+    reset = 0;
+  end
+
+  // generate clock to sequence tests
+  always begin
+    clk = 1;
+    # 5; clk = 0; # 5;
+  end
+
+  // check results: [104] gets divu, [100] the sum of all the results
+  always @(negedge clk) begin
+    if(MemWrite) begin
+      if(DataAdr === 100 & WriteData === 32'h15555533) begin
+        $display("Simulation succeeded");
+        $stop;
+      end else if (DataAdr === 104 & WriteData !== 32'h55555553) begin
+        $display("Simulation failed: divu result %h", WriteData);
+        $stop;
+      end else if (DataAdr !== 104) begin
+        $display("Simulation failed");
+        $stop;
+      end
+    end
+  end
+endmodule
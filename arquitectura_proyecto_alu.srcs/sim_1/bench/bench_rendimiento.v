@@ -0,0 +1,197 @@
+`timescale 1ns / 1ps
+// =============================================================================
+// Bancos de rendimiento para sim_1/rendimiento.py
+// Cada modulo es un top que aplica +n=N estimulos pseudoaleatorios
+// (+seed=S, por defecto 1) a un modelo, acumula sus salidas en una suma de
+// control (para que ningun simulador pueda descartar la logica) e imprime
+//   <modelo>: <N> <unidad> suma=<hex>
+// No comprueban resultados: eso lo hacen los testbenches de sim_1/new.
+// Con +traza=FICHERO vuelcan en VCD toda la jerarquia del modelo.
+//   bench_alu     un vector (a, b) por paso sobre alu #(SYSTEM), op fijo OP
+//   bench_fp_alu  una operacion por cada 2 ciclos (start, valid_out); op y
+//                 mode_fp aleatorios
+//   bench_basys3  una operacion half completa por la interfaz de botones:
+//                 4 bytes con BTNL/BTNR, BTNC y espera del resultado
+//   bench_top     N ciclos del core RISC-V (pipeline/top.v) con MEMFILE;
+//                 al terminar el programa el core sigue en su bucle 'done'
+// =============================================================================
+
+module bench_alu #(parameter SYSTEM = 16, parameter OP = 0);
+  reg  [SYSTEM-1:0] a, b;
+  wire [SYSTEM-1:0] y;
+  wire [4:0]        flags;
+  reg  [31:0]       suma;
+  reg  [8*256-1:0]  traza;
+  integer n, i, semilla;
+
+  alu #(.system(SYSTEM)) dut (
+    .a(a), .b(b), .op(OP[1:0]), .y(y), .ALUFlags(flags)
+  );
+
+  initial begin
+    if (!$value$plusargs("n=%d", n)) n = 100000;
+    if (!$value$plusargs("seed=%d", semilla)) semilla = 1;
+    if ($value$plusargs("traza=%s", traza)) begin
+      $dumpfile(traza);
+      $dumpvars(0, dut);
+    end
+    suma = 0;
+    for (i = 0; i < n; i = i + 1) begin
+      a = $random(semilla);
+      b = $random(semilla);
+      #1;
+      suma = {suma[30:0], suma[31]} ^ y ^ {flags, 27'b0};
+    end
+    $display("bench_alu%0d op=%0d: %0d vectores suma=%h", SYSTEM, OP, n, suma);
+    $finish;
+  end
+endmodule
+
+module bench_fp_alu;
+  reg         clk = 1'b0, rst = 1'b1, start = 1'b0, mode_fp = 1'b0;
+  reg  [31:0] op_a = 32'b0, op_b = 32'b0;
+  reg  [2:0]  op_code = 3'b0;
+  wire [31:0] result;
+  wire        valid_out;
+  wire [4:0]  flags;
+  reg  [31:0] suma;
+  reg  [8*256-1:0] traza;
+  integer n, i, semilla;
+
+  fp_alu #(.SUPPORT_SINGLE(1)) dut (
+    .clk(clk), .rst(rst), .start(start), .op_a(op_a), .op_b(op_b),
+    .op_code(op_code), .mode_fp(mode_fp), .round_mode(2'b00),
+    .result(result), .valid_out(valid_out), .flags(flags)
+  );
+
+  always #5 clk = ~clk;
+
+  initial begin
+    if (!$value$plusargs("n=%d", n)) n = 100000;
+    if (!$value$plusargs("seed=%d", semilla)) semilla = 1;
+    if ($value$plusargs("traza=%s", traza)) begin
+      $dumpfile(traza);
+      $dumpvars(0, dut);
+    end
+    suma = 0;
+    @(negedge clk) rst = 1'b0;
+    for (i = 0; i < n; i = i + 1) begin
+      @(negedge clk);
+      op_a    = $random(semilla);
+      op_b    = $random(semilla);
+      op_code = $random(semilla) & 3;
+      mode_fp = $random(semilla);
+      start   = 1'b1;
+      @(negedge clk);
+      start   = 1'b0;
+      suma = {suma[30:0], suma[31]} ^ result ^ {flags, valid_out, 26'b0};
+    end
+    $display("bench_fp_alu: %0d operaciones suma=%h", n, suma);
+    $finish;
+  end
+endmodule
+
+module bench_basys3;
+  reg         CLK100MHZ = 1'b0;
+  reg  [15:0] SW = 16'b0;
+  reg         BTNC = 1'b0, BTNU = 1'b0, BTND = 1'b0, BTNL = 1'b0, BTNR = 1'b0;
+  wire [15:0] LED;
+  wire [3:0]  AN;
+  wire        CA, CB, CC, CD, CE, CF, CG, DP;
+  reg  [31:0] suma, a, b;
+  reg  [8*256-1:0] traza;
+  integer n, i, semilla;
+
+  top_basys3_fp_alu #(.SUPPORT_SINGLE(1)) dut (
+    .CLK100MHZ(CLK100MHZ), .SW(SW),
+    .BTNC(BTNC), .BTNU(BTNU), .BTND(BTND), .BTNL(BTNL), .BTNR(BTNR),
+    .LED(LED), .AN(AN),
+    .CA(CA), .CB(CB), .CC(CC), .CD(CD), .CE(CE), .CF(CF), .CG(CG), .DP(DP)
+  );
+
+  always #5 CLK100MHZ = ~CLK100MHZ;
+
+  // Pulsacion de 4 ciclos y 4 de reposo: cubre sync_2ff y edge_up
+  task pulsar(input [2:0] boton); // 0=BTNL, 1=BTNR, 2=BTNC, 3=BTND
+    begin
+      @(negedge CLK100MHZ);
+      case (boton)
+        3'd0: BTNL = 1'b1;
+        3'd1: BTNR = 1'b1;
+        3'd2: BTNC = 1'b1;
+        default: BTND = 1'b1;
+      endcase
+      repeat (4) @(negedge CLK100MHZ);
+      {BTNL, BTNR, BTNC, BTND} = 4'b0;
+      repeat (4) @(negedge CLK100MHZ);
+    end
+  endtask
+
+  // Byte al bloque actual del operando SW[8] y avance al siguiente bloque
+  task cargar(input [7:0] dato);
+    begin
+      SW[7:0] = dato;
+      pulsar(3'd0);
+      pulsar(3'd1);
+    end
+  endtask
+
+  initial begin
+    if (!$value$plusargs("n=%d", n)) n = 1000;
+    if (!$value$plusargs("seed=%d", semilla)) semilla = 1;
+    if ($value$plusargs("traza=%s", traza)) begin
+      $dumpfile(traza);
+      $dumpvars(0, dut);
+    end
+    suma = 0;
+    pulsar(3'd3);
+    for (i = 0; i < n; i = i + 1) begin
+      a = $random(semilla);
+      b = $random(semilla);
+      SW[10:9] = a[31:30];
+      SW[8] = 1'b0; cargar(a[7:0]); cargar(a[15:8]);
+      SW[8] = 1'b1; cargar(b[7:0]); cargar(b[15:8]);
+      pulsar(3'd2);
+      suma = {suma[30:0], suma[31]} ^ dut.disp_latch ^ {LED, 16'b0};
+    end
+    $display("bench_basys3: %0d operaciones suma=%h", n, suma);
+    $finish;
+  end
+endmodule
+
+module bench_top #(parameter MEMFILE = "pipeline/riscvtest.txt");
+  reg         clk = 1'b0, reset = 1'b1;
+  wire [31:0] WriteData, DataAdr;
+  wire        MemWrite;
+  reg  [31:0] suma;
+  reg  [8*256-1:0] traza;
+  integer n, i, escrituras;
+
+  top #(.MEMFILE(MEMFILE)) dut (
+    .clk(clk), .reset(reset),
+    .WriteData(WriteData), .DataAdr(DataAdr), .MemWrite(MemWrite)
+  );
+
+  always #5 clk = ~clk;
+
+  initial begin
+    if (!$value$plusargs("n=%d", n)) n = 100000;
+    if ($value$plusargs("traza=%s", traza)) begin
+      $dumpfile(traza);
+      $dumpvars(0, dut);
+    end
+    suma = 0;
+    escrituras = 0;
+    repeat (2) @(negedge clk);
+    reset = 1'b0;
+    for (i = 0; i < n; i = i + 1) begin
+      @(negedge clk);
+      if (MemWrite) begin
+        escrituras = escrituras + 1;
+        suma = {suma[30:0], suma[31]} ^ WriteData ^ DataAdr;
+      end
+    end
+    $display("bench_top: %0d ciclos suma=%h (%0d escrituras)", n, suma, escrituras);
+    $finish;
+  end
+endmodule
@@ -0,0 +1,24 @@
+// =============================================================================
+// tb_alu_dpi.cpp
+// Lado C++ de tb_alu_dpi.sv: genera el vector numero 'index' de la semilla
+// 'seed' (cpp_model/stimulus.hpp) y calcula su resultado esperado con el
+// modelo bit-exacto de la ALU (cpp_model/fp_model.hpp).
+// =============================================================================
+#include <cstdint>
+
+#include "svdpi.h"
+
+#include "../../cpp_model/fp_model.hpp"
+#include "../../cpp_model/stimulus.hpp"
+
+extern "C" void alu_stim(int width, long long seed, long long index, int *a, int *b, int *op,
+                         int *y, int *flags) {
+  const fpmodel::Vector v = fpmodel::Stimulus((uint64_t)seed).at((uint64_t)index, width);
+  const fpmodel::Result r = width == 32 ? fpmodel::Single::eval(v.a, v.b, v.op)
+                                        : fpmodel::Half::eval(v.a, v.b, v.op);
+  *a = (int)v.a;
+  *b = (int)v.b;
+  *op = (int)v.op;
+  *y = (int)r.y;
+  *flags = (int)r.flags;
+}
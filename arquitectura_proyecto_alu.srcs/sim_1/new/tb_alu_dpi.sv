@@ -0,0 +1,176 @@
+`timescale 1ns/1ps
+
+// =============================================================================
+// tb_alu_dpi
+// Testbench sin ficheros: cada ciclo pide a C++ (tb_alu_dpi.cpp, via DPI-C)
+// un vector con la mezcla de casos de gen_random/gec_vector.py y su resultado
+// esperado segun el modelo bit-exacto (cpp_model/fp_model.hpp), lo aplica a
+// la ALU y compara {y, ALUFlags} en el flanco de bajada.
+//
+// Plusargs:
+//   +seed=S        semilla (por defecto 1)
+//   +start=I       primer indice (por defecto 0)
+//   +n=N           numero de vectores, 0 = sin limite (por defecto 100000)
+//   +max_errors=E  parar tras E discrepancias (por defecto 10)
+// Un fallo se reproduce solo con su semilla e indice: +seed=S +start=I +n=1
+//
+// Ondas con disparo (en lugar de volcar toda la ejecucion):
+//   +wave=F          vuelca en F solo ventanas alrededor de cada disparo
+//                    (FST con vvp -fst o verilator --trace-fst, si no VCD)
+//   +wave_window=W   vectores antes y despues del disparo (por defecto 8, max 255)
+//   +wave_flags=M    dispara tambien si la ALU activa algun flag de la mascara
+//                    M (ALUFlags[4:0]; p. ej. 24 = invalid|div0); siempre
+//                    dispara con una discrepancia
+//   +wave_depth=D    niveles de jerarquia volcados (por defecto 0 = todos)
+//   +wave_dut        vuelca solo el DUT, sin las senales del testbench
+//   +wave_max=K      como mucho K ventanas (por defecto 100)
+// Los ultimos vectores se guardan en un buffer circular; como la ALU es
+// combinacional, al disparar se vuelven a aplicar con el volcado activo y la
+// ventana sale igual que si se hubiese grabado todo (en otro tiempo de
+// simulacion: cada ventana se anuncia con su indice y su tiempo).
+//
+// Verilator 5 (desde arquitectura_proyecto_alu.srcs/; -GSYSTEM=32 para single):
+//   verilator --binary -j 0 -O3 -f verilator/alu.f --top-module tb_alu_dpi
+//     sim_1/new/tb_alu_dpi.sv sim_1/new/tb_alu_dpi.cpp --Mdir obj_dpi -o tb_alu_dpi
+//   obj_dpi/tb_alu_dpi +seed=7 +n=0
+// Vivado xsim:
+//   xvlog -sv sources_1/new/*.v sim_1/new/tb_alu_dpi.sv
+//   xsc sim_1/new/tb_alu_dpi.cpp
+//   xelab tb_alu_dpi -sv_lib dpi -R -testplusarg seed=7
+// =============================================================================
+module tb_alu_dpi #(parameter SYSTEM = 16);
+
+  import "DPI-C" function void alu_stim(input int width, input longint seed, input longint index,
+                                        output int a, output int b, output int op,
+                                        output int y, output int flags);
+
+  // =====================================
+  // Señales para la ALU
+  // =====================================
+  reg               clk = 0;
+  reg  [SYSTEM-1:0] a, b;
+  reg  [1:0]        op;
+  wire [SYSTEM-1:0] y;
+  wire [4:0]        ALUFlags;
+  reg  [SYSTEM-1:0] expected_y;
+  reg  [4:0]        expected_flags;
+
+  int     sa, sb, sop, sy, sflags;
+  longint seed, start, n, index, errors, max_errors;
+
+  // ondas con disparo: buffer circular de los ultimos vectores
+  localparam int RING = 256;
+  reg  [SYSTEM-1:0] ring_a [RING];
+  reg  [SYSTEM-1:0] ring_b [RING];
+  reg  [1:0]        ring_op[RING];
+  string  wave_path;
+  bit     wave_on, mismatch;
+  int     wave_window, wave_flags, wave_depth, wave_max, wave_post, windows, pre, k;
+
+  // =====================================
+  // Instancia del DUT
+  // =====================================
+  alu #( .system(SYSTEM) ) DUT (
+    .a(a),
+    .b(b),
+    .op(op),
+    .y(y),
+    .ALUFlags(ALUFlags)
+  );
+
+  always #5 clk = ~clk;
+
+  // =====================================
+  // Testbench principal
+  // =====================================
+  initial begin
+    if (!$value$plusargs("seed=%d", seed))             seed = 1;
+    if (!$value$plusargs("start=%d", start))           start = 0;
+    if (!$value$plusargs("n=%d", n))                   n = 100000;
+    if (!$value$plusargs("max_errors=%d", max_errors)) max_errors = 10;
+    errors = 0;
+
+    wave_on = $value$plusargs("wave=%s", wave_path);
+    if (!$value$plusargs("wave_window=%d", wave_window)) wave_window = 8;
+    if (!$value$plusargs("wave_flags=%d", wave_flags))   wave_flags = 0;
+    if (!$value$plusargs("wave_depth=%d", wave_depth))   wave_depth = 0;
+    if (!$value$plusargs("wave_max=%d", wave_max))       wave_max = 100;
+    if (wave_window > RING - 1) wave_window = RING - 1;
+    wave_post = 0;
+    windows = 0;
+    if (wave_on) begin
+      $dumpfile(wave_path);
+      if ($test$plusargs("wave_dut")) $dumpvars(wave_depth, DUT);
+      else                            $dumpvars(wave_depth, tb_alu_dpi);
+      $dumpoff;
+    end
+
+    $display("INICIO DE TESTBENCH DPI DE ALU FLOAT %0d bits (seed=%0d, start=%0d, n=%0d)",
+             SYSTEM, seed, start, n);
+
+    for (index = start; (n == 0 || index < start + n) && errors < max_errors; index++) begin
+      // vector y resultado esperado en la misma llamada
+      alu_stim(SYSTEM, seed, index, sa, sb, sop, sy, sflags);
+      a              = sa[SYSTEM-1:0];
+      b              = sb[SYSTEM-1:0];
+      op             = sop[1:0];
+      expected_y     = sy[SYSTEM-1:0];
+      expected_flags = sflags[4:0];
+
+      @(negedge clk);
+      mismatch = y !== expected_y || ALUFlags !== expected_flags;
+      if (mismatch) begin
+        errors++;
+        $display(" Mismatch seed=%0d index=%0d: a=%h b=%h op=%b", seed, index, a, b, op);
+        $display("   Esperado: y=%h, flags=%b", expected_y, expected_flags);
+        $display("   Obtenido: y=%h, flags=%b", y, ALUFlags);
+      end
+
+      if (wave_on) begin
+        if ((mismatch || (ALUFlags & wave_flags[4:0]) != 0) && wave_post == 0 && windows < wave_max) begin
+          // nueva ventana: reaplicar los vectores anteriores y el actual
+          pre = index - start < wave_window ? int'(index - start) : wave_window;
+          windows++;
+          $display(" Ventana de ondas %0d: indices %0d..%0d en t=%0t", windows, index - pre,
+                   index + wave_window, $time);
+          $dumpon;
+          for (k = pre; k >= 0; k--) begin
+            if (k > 0) begin
+              a  = ring_a[int'((index - k) % RING)];
+              b  = ring_b[int'((index - k) % RING)];
+              op = ring_op[int'((index - k) % RING)];
+            end else begin
+              a  = sa[SYSTEM-1:0];
+              b  = sb[SYSTEM-1:0];
+              op = sop[1:0];
+            end
+            @(posedge clk);
+            @(negedge clk);
+          end
+          wave_post = wave_window + 1;
+        end else if ((mismatch || (ALUFlags & wave_flags[4:0]) != 0) && wave_post > 0) begin
+          wave_post = wave_window + 1;  // otro disparo dentro de la ventana la alarga
+        end
+        if (wave_post > 0) begin
+          wave_post--;
+          if (wave_post == 0) $dumpoff;
+        end
+        ring_a[int'(index % RING)]  = a;
+        ring_b[int'(index % RING)]  = b;
+        ring_op[int'(index % RING)] = op;
+      end
+      if ((index - start + 1) % 1000000 == 0)
+        $display(" %0d vectores, %0d discrepancias", index - start + 1, errors);
+      @(posedge clk);
+    end
+
+    // Resumen
+    $display("\nRESULTADOS TOTALES");
+    $display("Casos totales:  %0d", index - start);
+    $display(" Discrepancias: %0d", errors);
+    if (errors == 0) $display("Simulation succeeded");
+    else             $display("Simulation failed");
+    $finish;
+  end
+
+endmodule
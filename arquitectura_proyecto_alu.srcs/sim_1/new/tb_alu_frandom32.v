@@ -21,6 +21,7 @@ module tb_alu_frandom32;
   reg [8*32-1:0] y_str;      // 16 caracteres
   reg [8*5-1:0]  flags_str;  // 5 caracteres
 
+  reg [8*256-1:0] path_inputs, path_outputs;  // rutas (+vectores=, +esperados=)
   integer fd_inputs, fd_outputs;
   integer total, correct, incorrect;
   integer near_correct; // nuevo contador
@@ -47,9 +48,13 @@ module tb_alu_frandom32;
     near_correct = 0;
     relaxed_correct = 0;
 
-    // Abrir archivos
-    fd_inputs  = $fopen("C:/Users/RODRIGO/alu/arquitectura_proyecto_alu.srcs/gen_random/data/tb_vectors_32_100000.mem", "r");
-    fd_outputs = $fopen("C:/Users/RODRIGO/alu/arquitectura_proyecto_alu.srcs/gen_random/output/tb_expected_output32_100000.mem", "r");
+    // Abrir archivos (las rutas se pueden cambiar con +vectores= y +esperados=)
+    if (!$value$plusargs("vectores=%s", path_inputs))
+      path_inputs  = "C:/Users/RODRIGO/alu/arquitectura_proyecto_alu.srcs/gen_random/data/tb_vectors_32_100000.mem";
+    if (!$value$plusargs("esperados=%s", path_outputs))
+      path_outputs = "C:/Users/RODRIGO/alu/arquitectura_proyecto_alu.srcs/gen_random/output/tb_expected_output32_100000.mem";
+    fd_inputs  = $fopen(path_inputs, "r");
+    fd_outputs = $fopen(path_outputs, "r");
 
     if (fd_inputs == 0 || fd_outputs == 0) begin
       $display("❌ ERROR: No se pudieron abrir los archivos de test.");
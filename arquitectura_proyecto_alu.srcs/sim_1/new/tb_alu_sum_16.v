@@ -20,9 +20,15 @@ module tb_alu_sum_16;
     .ALUFlags(ALUFlags)
   );
 
+  // Ondas solo si se piden: +wave=fichero (FST con vvp -fst), +wave_dut
+  // para volcar solo la ALU
+  reg [8*256-1:0] wave_path;
   initial begin
-    $dumpfile("wave.vcd");   // Nombre del archivo de salida
-    $dumpvars(0, tb_alu_sum_16); // Guardar todas las señales del testbench
+    if ($value$plusargs("wave=%s", wave_path)) begin
+      $dumpfile(wave_path);
+      if ($test$plusargs("wave_dut")) $dumpvars(0, DUT);
+      else                            $dumpvars(0, tb_alu_sum_16);
+    end
   end
 
   initial begin
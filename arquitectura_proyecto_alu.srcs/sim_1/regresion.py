@@ -0,0 +1,410 @@
+"""
+Regresion de los testbenches de sim_1/new fuera de Vivado.
+
+Compila cada testbench con un simulador libre (Icarus Verilog o Verilator),
+los ejecuta en paralelo, decide si pasan a partir de su salida y escribe un
+resumen en JSON y/o JUnit XML con el tiempo de compilacion y de ejecucion de
+cada uno:
+  - se prueban todos los .v/.sv de sim_1/new que tienen un bloque initial
+    (XDC.v no es un testbench); el top es el modulo del fichero;
+  - el RTL es sources_1/new/*.v; cada testbench se elabora por separado con
+    -s/--top-module (dos ficheros definen el mismo top_basys3_fp_alu_tb, asi
+    que no se pueden elaborar juntos), pero todas las compilaciones y
+    simulaciones van en paralelo;
+  - un test falla si el simulador termina con error ($fatal) o si imprime
+    alguna de las marcas de fallo de los testbenches (FALLO); cuenta como
+    comprobaciones las lineas de acierto y los "Casos totales" de los
+    testbenches de vectores. Un test sin comprobaciones (tb_alu.v,
+    tb_redondeo.v solo muestran resultados) pasa si termina sin errores;
+  - tb_alu_frandom16/32 leen los vectores de gen_random/ (+vectores=) y sus
+    esperados (+esperados=), que se calculan con cpp_model/fp_golden (el
+    modelo bit-exacto del RTL, compilado con g++): los de gen_random/output
+    son de compute.py, que no reproduce el RTL, y harian fallar siempre estos
+    tests. Sin g++ se omiten. tb_alu_dpi necesita DPI-C: solo se ejecuta con
+    Verilator. Con --vectores N se generan N vectores nuevos con
+    gen_random/batch.py para esos dos testbenches.
+
+Cache incremental (obj_regresion/cache/): un test que paso no se vuelve a
+simular mientras no cambie nada de lo que puede afectarle. Su clave es el
+hash del contenido de:
+  tb         el testbench (y el C++ de DPI con cpp_model/)
+  rtl        el cono de dependencias del testbench: solo los ficheros de
+             sources_1/new con modulos que instancia, directa o
+             indirectamente (tocar top_basys3_fp_alu.v no invalida los
+             testbenches de la ALU)
+  estimulos  los plusargs y los ficheros de vectores y esperados que leen
+  simulador  simulador y version, y este script
+Los vectores de --vectores se guardan con la clave (batch.py, vecbin.py,
+ancho, N, semilla) y los esperados con la de (vectores, cpp_model/).
+El informe indica para cada test si se reutiliza o, si no, que parte de la
+clave cambio. --sin-cache ejecuta todo (y actualiza la cache).
+
+Uso (desde arquitectura_proyecto_alu.srcs/):
+  python sim_1/regresion.py [-j N] [--sim icarus|verilator] [-k patron]
+      [--json resultados.json] [--junit resultados.xml] [--timeout 300]
+      [--vectores N [--seed S]] [--sin-cache]
+Los ficheros compilados y el log de cada test quedan en obj_regresion/<sim>/.
+Codigo de salida: 0 si todos pasan, 1 si alguno falla o no compila,
+2 si falta el simulador o no hay tests.
+"""
+import argparse
+import glob
+import hashlib
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+import xml.etree.ElementTree as ET
+from concurrent.futures import ThreadPoolExecutor
+
+RAIZ = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Ajustes por testbench (nombre del fichero sin extension)
+EXTRA = {
+    "tb_alu_frandom16": {"plusargs": ["+vectores=gen_random/data/tb_vectors_16_1000.mem"], "golden": True},
+    "tb_alu_frandom32": {"plusargs": ["+vectores=gen_random/data/tb_vectors_32_1000.mem"], "golden": True},
+    "tb_alu_dpi": {"cpp": ["sim_1/new/tb_alu_dpi.cpp"], "plusargs": ["+n=100000"],
+                   "solo": "verilator"},
+}
+
+FALLO = re.compile(r"❌|\bFAIL\b|MISMATCH|Mismatch|\bERROR\b|FATAL|%Fatal|%Error|Simulation failed")
+ACIERTO = re.compile(r"✅|\bOK\b")
+CASOS = re.compile(r"Casos totales:\s*(\d+)")
+COMENTARIO = re.compile(r"//[^\n]*|/\*.*?\*/", re.S)
+
+
+# --- Descubrimiento ---
+def descubrir(patron=None):
+    """Lista de tests: (nombre, fichero relativo, modulo top)"""
+    tests = []
+    for ruta in sorted(glob.glob(os.path.join(RAIZ, "sim_1", "new", "*.v")) +
+                       glob.glob(os.path.join(RAIZ, "sim_1", "new", "*.sv"))):
+        with open(ruta, encoding="utf-8", errors="replace") as f:
+            texto = f.read()
+        modulo = re.search(r"^\s*module\s+(\w+)", texto, re.M)
+        if not modulo or not re.search(r"\binitial\b", texto):
+            continue
+        nombre = os.path.splitext(os.path.basename(ruta))[0]
+        if patron and patron not in nombre:
+            continue
+        tests.append((nombre, os.path.relpath(ruta, RAIZ), modulo.group(1)))
+    return tests
+
+
+def fuentes_rtl():
+    return sorted(os.path.relpath(p, RAIZ) for p in glob.glob(os.path.join(RAIZ, "sources_1", "new", "*.v")))
+
+
+# --- Cono de dependencias y claves de la cache ---
+def huella(*rutas, texto=""):
+    """sha256 (16 hex) del contenido de los ficheros y un texto"""
+    h = hashlib.sha256(texto.encode())
+    for ruta in rutas:
+        h.update(ruta.encode() + b"\0")
+        with open(os.path.join(RAIZ, ruta), "rb") as f:
+            h.update(f.read())
+    return h.hexdigest()[:16]
+
+
+def instancias(cuerpo, nombres):
+    return {m for m in nombres if re.search(rf"\b{m}\b\s*(#|\w+\s*\()", cuerpo)}
+
+
+def indice_rtl():
+    """modulo -> (fichero, modulos que instancia) de sources_1/new"""
+    cuerpos = {}
+    for ruta in fuentes_rtl():
+        with open(os.path.join(RAIZ, ruta), encoding="utf-8", errors="replace") as f:
+            texto = COMENTARIO.sub("", f.read())
+        for m in re.finditer(r"\bmodule\s+(\w+)(.*?)\bendmodule", texto, re.S):
+            cuerpos[m.group(1)] = (ruta, m.group(2))
+    return {m: (ruta, instancias(c, cuerpos.keys() - {m})) for m, (ruta, c) in cuerpos.items()}
+
+
+def cono(fichero, indice):
+    """Ficheros del RTL de los que depende un testbench"""
+    with open(os.path.join(RAIZ, fichero), encoding="utf-8", errors="replace") as f:
+        pendientes = list(instancias(COMENTARIO.sub("", f.read()), indice.keys()))
+    vistos = set()
+    while pendientes:
+        m = pendientes.pop()
+        if m not in vistos:
+            vistos.add(m)
+            pendientes.extend(indice[m][1])
+    return sorted({indice[m][0] for m in vistos})
+
+
+def version_simulador(sim):
+    cmd = ["iverilog", "-V"] if sim == "icarus" else ["verilator", "--version"]
+    p = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    return p.stdout.decode(errors="replace").splitlines()[0] if p.stdout else sim
+
+
+def clave(test, sim, version, indice):
+    """Partes de la clave de cache de un test"""
+    nombre, fichero, _ = test
+    extra = EXTRA.get(nombre, {})
+    cpp = extra.get("cpp", [])
+    modelo = sorted(os.path.relpath(p, RAIZ) for p in glob.glob(os.path.join(RAIZ, "cpp_model", "*.hpp")))
+    datos = [a.split("=", 1)[1] for a in extra.get("plusargs", [])
+             if "=" in a and os.path.isfile(os.path.join(RAIZ, a.split("=", 1)[1]))]
+    return {
+        "tb": huella(fichero, *cpp, *(modelo if cpp else [])),
+        "rtl": huella(*cono(fichero, indice)),
+        "estimulos": huella(*datos, texto=" ".join(extra.get("plusargs", []))),
+        "simulador": huella(os.path.relpath(os.path.abspath(__file__), RAIZ), texto=sim + version),
+    }
+
+
+def generar_vectores(n, seed, dir_cache):
+    """Vectores nuevos para tb_alu_frandom16/32; devuelve {ancho: acierto}"""
+    aciertos = {}
+    fuentes = ("gen_random/batch.py", "gen_random/vecbin.py")
+    for w in (16, 32):
+        k = huella(*fuentes, texto=f"{w} {n} {seed}")
+        vec = os.path.join(dir_cache, "vectores", f"{k}_vectores{w}.mem")
+        aciertos[w] = os.path.isfile(vec)
+        if not aciertos[w]:
+            os.makedirs(os.path.dirname(vec), exist_ok=True)
+            subprocess.run([sys.executable, "batch.py", "vectores", str(w), str(n), vec + ".tmp",
+                            "--seed", str(seed)],
+                           cwd=os.path.join(RAIZ, "gen_random"), check=True, stdout=subprocess.DEVNULL)
+            os.replace(vec + ".tmp", vec)
+        EXTRA[f"tb_alu_frandom{w}"]["plusargs"] = [f"+vectores={os.path.relpath(vec, RAIZ)}"]
+    return aciertos
+
+
+def esperados_golden(dir_cache):
+    """+esperados= de los tests con "golden", calculados con fp_golden a partir de sus
+    vectores; devuelve {test: 'cache' | 'fp_golden'}, o {test: motivo} si se omiten"""
+    modelo = sorted(os.path.relpath(p, RAIZ) for p in glob.glob(os.path.join(RAIZ, "cpp_model", "*.?pp")))
+    tests = [nombre for nombre, extra in EXTRA.items() if extra.get("golden")]
+    binario = os.path.join(dir_cache, "fp_golden", huella(*modelo), "fp_golden")
+    motivo = None
+    if not os.path.isfile(binario):
+        if not shutil.which("g++"):
+            motivo = "sin g++ para compilar cpp_model/fp_golden.cpp"
+        else:
+            os.makedirs(os.path.dirname(binario), exist_ok=True)
+            p = subprocess.run(["g++", "-O2", "-std=c++17", "-pthread", "-o", binario + ".tmp",
+                                "cpp_model/fp_golden.cpp"], cwd=RAIZ,
+                               stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+            if p.returncode != 0:
+                motivo = "cpp_model/fp_golden.cpp no compila"
+            else:
+                os.replace(binario + ".tmp", binario)
+    estado = {}
+    for nombre in tests:
+        extra = EXTRA[nombre]
+        if motivo:
+            extra["omitir"] = estado[nombre] = motivo
+            continue
+        vec = next(a.split("=", 1)[1] for a in extra["plusargs"] if a.startswith("+vectores="))
+        esp = os.path.join(dir_cache, "esperados", f"{huella(vec, *modelo)}_esperados.mem")
+        estado[nombre] = "cache" if os.path.isfile(esp) else "fp_golden"
+        if not os.path.isfile(esp):
+            os.makedirs(os.path.dirname(esp), exist_ok=True)
+            subprocess.run([binario, "--quiet", vec, esp + ".tmp"], cwd=RAIZ, check=True)
+            os.replace(esp + ".tmp", esp)
+        extra["plusargs"] = [a for a in extra["plusargs"] if not a.startswith("+esperados=")]
+        extra["plusargs"].append(f"+esperados={os.path.relpath(esp, RAIZ)}")
+    return estado
+
+
+# --- Compilacion y ejecucion ---
+def comandos(sim, nombre, fichero, top, dir_obj):
+    """(compilacion, ejecucion) para un test"""
+    extra = EXTRA.get(nombre, {})
+    rtl = fuentes_rtl()
+    if sim == "icarus":
+        vvp = os.path.join(dir_obj, nombre + ".vvp")
+        compilar = ["iverilog", "-g2012", "-Isources_1/new", "-s", top, "-o", vvp] + rtl + [fichero]
+        ejecutar = ["vvp", "-n", vvp]
+    else:
+        mdir = os.path.join(dir_obj, nombre)
+        compilar = (["verilator", "--binary", "--timing", "-j", "1", "-Wno-fatal", "-Wno-lint",
+                     "-Wno-style", "-Isources_1/new", "--top-module", top, "--Mdir", mdir,
+                     "-o", nombre] + rtl + [fichero] + extra.get("cpp", []))
+        ejecutar = [os.path.join(mdir, nombre)]
+    return compilar, ejecutar + extra.get("plusargs", [])
+
+
+def lanzar(cmd, timeout):
+    """(codigo, salida, segundos); codigo None si se agota el tiempo"""
+    t0 = time.monotonic()
+    try:
+        p = subprocess.run(cmd, cwd=RAIZ, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                           timeout=timeout)
+        codigo, salida = p.returncode, p.stdout
+    except subprocess.TimeoutExpired as e:
+        codigo, salida = None, e.stdout or b""
+    return codigo, salida.decode("utf-8", errors="replace"), round(time.monotonic() - t0, 3)
+
+
+def evaluar(codigo, salida):
+    """(estado, comprobaciones, lineas de fallo) de una simulacion"""
+    fallos = [l.strip() for l in salida.splitlines() if FALLO.search(l)]
+    checks = sum(1 for l in salida.splitlines() if ACIERTO.search(l))
+    checks += sum(int(n) for n in CASOS.findall(salida))
+    if codigo is None:
+        return "error", checks, ["tiempo agotado"] + fallos
+    if fallos or codigo != 0:
+        return "failed", checks, fallos or [f"codigo de salida {codigo}"]
+    return "passed", checks, []
+
+
+def correr(test, sim, dir_obj, timeout):
+    nombre, fichero, top = test
+    r = {"name": nombre, "file": fichero, "top": top, "status": "skipped",
+         "compile_s": 0.0, "run_s": 0.0, "checks": 0, "failures": [], "log": None, "cache": "-"}
+    solo = EXTRA.get(nombre, {}).get("solo")
+    if solo and solo != sim:
+        r["failures"] = [f"solo con {solo}"]
+        return r
+    if EXTRA.get(nombre, {}).get("omitir"):
+        r["failures"] = [EXTRA[nombre]["omitir"]]
+        return r
+
+    compilar, ejecutar = comandos(sim, nombre, fichero, top, dir_obj)
+    log = os.path.join(dir_obj, nombre + ".log")
+    r["log"] = os.path.relpath(log, RAIZ)
+    codigo, salida_c, r["compile_s"] = lanzar(compilar, timeout)
+    if codigo != 0:
+        r["status"] = "error"
+        r["failures"] = ["no compila"] + [l for l in salida_c.splitlines() if l.strip()][-20:]
+        salida = salida_c
+    else:
+        codigo, salida, r["run_s"] = lanzar(ejecutar, timeout)
+        r["status"], r["checks"], r["failures"] = evaluar(codigo, salida)
+        salida = salida_c + salida
+    with open(log, "w", encoding="utf-8") as f:
+        f.write(" ".join(compilar) + "\n" + " ".join(ejecutar) + "\n\n" + salida)
+    return r
+
+
+# --- Resumen ---
+def escribir_junit(ruta, sim, resultados, total_s):
+    cuenta = lambda e: sum(r["status"] == e for r in resultados)
+    suite = ET.Element("testsuite", name=f"sim_1.{sim}", tests=str(len(resultados)),
+                       failures=str(cuenta("failed")), errors=str(cuenta("error")),
+                       skipped=str(cuenta("skipped")), time=f"{total_s:.3f}")
+    for r in resultados:
+        caso = ET.SubElement(suite, "testcase", classname=f"sim_1.{sim}", name=r["name"],
+                             file=r["file"], time=f"{r['compile_s'] + r['run_s']:.3f}")
+        ET.SubElement(caso, "properties")
+        for prop in ("top", "compile_s", "run_s", "checks", "log", "cache"):
+            if r[prop] is not None:
+                ET.SubElement(caso[0], "property", name=prop, value=str(r[prop]))
+        mensaje = r["failures"][0] if r["failures"] else ""
+        detalle = "\n".join(r["failures"])
+        if r["status"] == "failed":
+            ET.SubElement(caso, "failure", message=mensaje).text = detalle
+        elif r["status"] == "error":
+            ET.SubElement(caso, "error", message=mensaje).text = detalle
+        elif r["status"] == "skipped":
+            ET.SubElement(caso, "skipped", message=mensaje)
+    raiz = ET.Element("testsuites")
+    raiz.append(suite)
+    ET.indent(raiz)
+    ET.ElementTree(raiz).write(ruta, encoding="utf-8", xml_declaration=True)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="regresion de los testbenches de sim_1/new")
+    ap.add_argument("-j", type=int, default=os.cpu_count() or 1, help="tests en paralelo")
+    ap.add_argument("--sim", choices=("icarus", "verilator"), default="icarus")
+    ap.add_argument("-k", dest="patron", help="solo los tests cuyo nombre contiene el patron")
+    ap.add_argument("--json", help="resumen en JSON")
+    ap.add_argument("--junit", help="resumen en JUnit XML")
+    ap.add_argument("--timeout", type=float, default=300, help="segundos por compilacion o simulacion")
+    ap.add_argument("--dir", default="obj_regresion", help="directorio de trabajo")
+    ap.add_argument("--vectores", type=int, help="N vectores nuevos para tb_alu_frandom16/32")
+    ap.add_argument("--seed", type=int, default=1, help="semilla de --vectores (por defecto 1)")
+    ap.add_argument("--sin-cache", action="store_true", help="no reutilizar resultados")
+    args = ap.parse_args()
+
+    herramienta = "iverilog" if args.sim == "icarus" else "verilator"
+    if not shutil.which(herramienta):
+        print(f"❌ ERROR: no se encuentra {herramienta} en el PATH", file=sys.stderr)
+        return 2
+    tests = descubrir(args.patron)
+    if not tests:
+        print("❌ ERROR: ningun testbench coincide", file=sys.stderr)
+        return 2
+    dir_obj = os.path.join(RAIZ, args.dir, args.sim)
+    dir_cache = os.path.join(RAIZ, args.dir, "cache")
+    os.makedirs(dir_obj, exist_ok=True)
+    os.makedirs(dir_cache, exist_ok=True)
+
+    t0 = time.monotonic()
+    if args.vectores:
+        for w, acierto in generar_vectores(args.vectores, args.seed, dir_cache).items():
+            print(f"vectores {w} bits (n={args.vectores}, seed={args.seed}): "
+                  f"{'cache' if acierto else 'generados con batch.py'}")
+    for nombre, estado in esperados_golden(dir_cache).items():
+        if any(t[0] == nombre for t in tests):
+            print(f"esperados de {nombre}: {estado}")
+
+    # un test que paso se reutiliza si su clave no cambio
+    ruta_cache = os.path.join(dir_cache, args.sim + ".json")
+    cache = {}
+    if os.path.isfile(ruta_cache):
+        with open(ruta_cache, encoding="utf-8") as f:
+            cache = json.load(f)
+    indice, version = indice_rtl(), version_simulador(args.sim)
+    claves = {t[0]: clave(t, args.sim, version, indice) for t in tests}
+    reutilizados, pendientes = {}, []
+    for t in tests:
+        previo = cache.get(t[0])
+        if (previo and previo["clave"] == claves[t[0]] and previo["resultado"]["status"] == "passed"
+                and not args.sin_cache):
+            reutilizados[t[0]] = dict(previo["resultado"], compile_s=0.0, run_s=0.0, cache="reutilizado")
+        else:
+            pendientes.append(t)
+
+    with ThreadPoolExecutor(max_workers=max(1, args.j)) as pool:
+        nuevos = dict(zip((t[0] for t in pendientes),
+                          pool.map(lambda t: correr(t, args.sim, dir_obj, args.timeout), pendientes)))
+    total_s = time.monotonic() - t0
+
+    for nombre, r in nuevos.items():
+        previo = cache.get(nombre)
+        if args.sin_cache:
+            r["cache"] = "desactivada"
+        elif not previo:
+            r["cache"] = "nuevo"
+        elif previo["clave"] == claves[nombre]:
+            r["cache"] = f"antes {previo['resultado']['status']}"
+        else:
+            r["cache"] = "cambia " + ",".join(k for k in claves[nombre] if previo["clave"].get(k) != claves[nombre][k])
+        cache[nombre] = {"clave": claves[nombre], "resultado": r}
+    with open(ruta_cache, "w", encoding="utf-8") as f:
+        json.dump(cache, f, indent=1, ensure_ascii=False)
+    resultados = [reutilizados.get(t[0]) or nuevos[t[0]] for t in tests]
+
+    marca = {"passed": "✅", "failed": "❌", "error": "❌", "skipped": "--"}
+    for r in resultados:
+        print(f"{marca[r['status']]} {r['name']:<24} {r['status']:<8} "
+              f"compilacion {r['compile_s']:6.2f} s  ejecucion {r['run_s']:6.2f} s  "
+              f"comprobaciones {r['checks']:<8} cache: {r['cache']}")
+        for l in r["failures"][:3]:
+            print(f"     {l}")
+    cuenta = {e: sum(r["status"] == e for r in resultados) for e in marca}
+    print(f"\n{len(resultados)} tests con {args.sim} en {total_s:.1f} s: {cuenta['passed']} pasan, "
+          f"{cuenta['failed']} fallan, {cuenta['error']} con error, {cuenta['skipped']} omitidos")
+    print(f"cache: {len(reutilizados)} reutilizados, {len(nuevos)} ejecutados")
+
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump({"simulator": args.sim, "time_s": round(total_s, 3), "summary": cuenta,
+                       "tests": resultados}, f, indent=2, ensure_ascii=False)
+    if args.junit:
+        escribir_junit(args.junit, args.sim, resultados, total_s)
+    return 1 if cuenta["failed"] or cuenta["error"] else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,418 @@
+"""
+Rendimiento de simulacion (estimulos por segundo) de los modelos del proyecto
+con cada simulador disponible, con comparacion contra una linea base.
+
+Modelos (bancos de sim_1/bench/bench_rendimiento.v):
+  alu16_add .. alu32_div  alu #(16|32) con un op fijo, vectores/s
+  fp_alu                  envoltorio con handshake start/valid_out, operaciones/s
+  basys3                  top_basys3_fp_alu por la interfaz de botones, operaciones/s
+  top                     core RISC-V de pipeline/top.v, ciclos/s
+Variantes, segun los simuladores que haya en el PATH (o --sim):
+  icarus, icarus+traza         iverilog/vvp
+  verilator, verilator-tN      Verilator 5 (--binary -O3), 1 hilo y --threads N
+  verilator+traza              compilado con --trace
+  xsim, xsim+traza             Vivado (xvlog/xelab/xsim)
+Las variantes +traza vuelcan toda la jerarquia del modelo en VCD (+traza=);
+el fichero se borra despues de cada ejecucion y se informa de su tamano.
+
+Medicion: cada binario se ejecuta con +n=N duplicando N hasta que una
+ejecucion dura al menos --min-s segundos; el ritmo es el de las dos ultimas,
+(N2 - N1) / (t2 - t1), asi que no incluye el arranque del simulador (la
+elaboracion de vvp/xsim, la lectura de MEMFILE), que se informa aparte.
+Con --repeticiones R se repite ese par R veces y se queda el mejor ritmo.
+Las compilaciones van en paralelo (-j); las mediciones, una detras de otra.
+
+Linea base: --guardar FICHERO escribe (o actualiza) el ritmo de cada
+modelo/variante y la maquina y versiones con que se midio; --base FICHERO
+compara y marca como regresion las que bajan mas de --umbral (10 %). Las
+bases solo son comparables en la misma maquina: se avisa si no coincide.
+
+Perfil (--perfil): ademas, compila cada modelo con Verilator con
+--prof-cfuncs y -pg, lo ejecuta con el ultimo N medido y reparte el tiempo
+por modulo con gprof y verilator_profcfunc (perfil.txt en su directorio).
+
+Uso (desde arquitectura_proyecto_alu.srcs/):
+  python sim_1/rendimiento.py [--sim icarus,verilator,xsim] [-k patron]
+      [--variantes patron] [--hilos 4] [--min-s 2] [--repeticiones R]
+      [--base base.json] [--guardar base.json] [--umbral 0.10]
+      [--json rendimiento.json] [--perfil] [-j N]
+Los binarios y logs quedan en obj_rendimiento/<modelo>/<variante>/.
+Codigo de salida: 0 si todo se mide sin regresiones, 1 si alguna medicion
+falla o hay regresiones, 2 si no hay simuladores, ningun modelo coincide o
+la linea base no se puede leer.
+
+Estado: el script solo se ha probado con simuladores simulados (guiones que
+imitan iverilog/vvp/verilator e imprimen la linea de los bancos); los bancos
+y los comandos de compilacion no se han ejecutado con un simulador real y no
+hay linea base en el repositorio. La primera ejecucion en una maquina con
+simuladores debe revisar obj_rendimiento/*/*/compilacion.log y guardar la
+base con --guardar.
+"""
+import argparse
+import glob
+import json
+import os
+import platform
+import re
+import shutil
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+RAIZ = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BANCO = "sim_1/bench/bench_rendimiento.v"
+FP_ALU = ["sources_1/new/top_basys3_fp_alu.v"]
+
+# nombre -> top del banco, lista de ficheros (.f de verilator/), ficheros
+# adicionales, parametros, unidad y N inicial
+MODELOS = {}
+for _w in (16, 32):
+    for _op, _nombre in enumerate(("add", "sub", "mul", "div")):
+        MODELOS[f"alu{_w}_{_nombre}"] = {"top": "bench_alu", "lista": "verilator/alu.f",
+                                          "params": {"SYSTEM": _w, "OP": _op},
+                                          "unidad": "vectores", "n": 1000}
+MODELOS["fp_alu"] = {"top": "bench_fp_alu", "lista": "verilator/alu.f", "extra": FP_ALU,
+                     "unidad": "operaciones", "n": 1000}
+MODELOS["basys3"] = {"top": "bench_basys3", "lista": "verilator/alu.f", "extra": FP_ALU,
+                     "unidad": "operaciones", "n": 20}
+MODELOS["top"] = {"top": "bench_top", "lista": "verilator/top.f",
+                  "params": {"MEMFILE": os.path.join(RAIZ, "pipeline", "riscvtest.txt")},
+                  "unidad": "ciclos", "n": 1000}
+
+HERRAMIENTAS = {"icarus": ["iverilog", "vvp"], "verilator": ["verilator"],
+                "xsim": ["xvlog", "xelab", "xsim"]}
+SALIDA = re.compile(r":\s*(\d+)\s+(\w+)\s+suma=([0-9a-fA-F]+)")
+MAX_N = 1 << 30
+
+
+# --- Ficheros y comandos ---
+def leer_lista(lista):
+    """(fuentes, directorios de include) de un fichero .f de verilator/"""
+    fuentes, incluir = [], []
+    with open(os.path.join(RAIZ, lista), encoding="utf-8") as f:
+        for linea in f:
+            linea = linea.split("//")[0].strip()
+            if linea.startswith("-I"):
+                incluir.append(linea[2:])
+            elif linea.endswith((".v", ".sv")):
+                fuentes.append(linea)
+    return fuentes, incluir
+
+
+def generico(valor):
+    """Valor de un parametro en la linea de comandos (las cadenas van entre comillas)"""
+    return f'"{valor}"' if isinstance(valor, str) else str(valor)
+
+
+def variantes(sims, hilos):
+    """(nombre, simulador, hilos, traza)"""
+    v = []
+    for sim in sims:
+        v.append((sim, sim, 1, False))
+        if sim == "verilator" and hilos > 1:
+            v.append((f"verilator-t{hilos}", sim, hilos, False))
+        v.append((sim + "+traza", sim, 1, True))
+    return v
+
+
+def comandos(modelo, sim, hilos, traza, dir_obj, perfil=False):
+    """(compilacion: lista de comandos, ejecucion, directorio de trabajo)"""
+    m = MODELOS[modelo]
+    fuentes, incluir = leer_lista(m["lista"])
+    fuentes = [os.path.join(RAIZ, p) for p in fuentes + m.get("extra", []) + [BANCO]]
+    incluir = [os.path.join(RAIZ, p) for p in incluir]
+    params = m.get("params", {})
+    top = m["top"]
+    if sim == "icarus":
+        vvp = os.path.join(dir_obj, "bench.vvp")
+        compilar = (["iverilog", "-g2012", "-s", top, "-o", vvp] + [f"-I{d}" for d in incluir] +
+                    [f"-P{top}.{k}={generico(v)}" for k, v in params.items()] + fuentes)
+        return [compilar], ["vvp", "-n", vvp], RAIZ
+    if sim == "verilator":
+        opciones = ["--binary", "--timing", "-O3", "-j", "0", "-Wno-fatal", "-Wno-lint", "-Wno-style",
+                    "--top-module", top, "--Mdir", dir_obj, "-o", "bench"]
+        if hilos > 1:
+            opciones += ["--threads", str(hilos)]
+        if traza:
+            opciones.append("--trace")
+        if perfil:
+            opciones += ["--prof-cfuncs", "-CFLAGS", "-pg", "-LDFLAGS", "-pg"]
+        compilar = (["verilator"] + opciones + [f"-I{d}" for d in incluir] +
+                    [f"-G{k}={generico(v)}" for k, v in params.items()] + fuentes)
+        return [compilar], [os.path.join(dir_obj, "bench")], RAIZ
+    # xsim deja xsim.dir y sus logs en el directorio de trabajo
+    elaborar = ["xelab", top, "-s", "bench", "--timescale", "1ns/1ps"]
+    for k, v in params.items():
+        elaborar += ["-generic_top", f"{k}={generico(v)}"]
+    if traza:
+        elaborar += ["-debug", "typical"]
+    compilar = [["xvlog"] + [a for d in incluir for a in ("-i", d)] + fuentes, elaborar]
+    return compilar, ["xsim", "bench", "-runall"], dir_obj
+
+
+def plusargs(sim, args):
+    if sim == "xsim":
+        return [a for p in args for a in ("-testplusarg", p)]
+    return ["+" + p for p in args]
+
+
+def lanzar(cmd, cwd, timeout, env=None):
+    """(codigo, salida, segundos); codigo None si se agota el tiempo"""
+    t0 = time.monotonic()
+    try:
+        p = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                           timeout=timeout, env=env)
+        codigo, salida = p.returncode, p.stdout
+    except subprocess.TimeoutExpired as e:
+        codigo, salida = None, e.stdout or b""
+    except OSError as e:
+        codigo, salida = 127, str(e).encode()
+    return codigo, salida.decode("utf-8", errors="replace"), time.monotonic() - t0
+
+
+def version(sim):
+    cmd = {"icarus": ["iverilog", "-V"], "verilator": ["verilator", "--version"],
+           "xsim": ["xsim", "-version"]}[sim]
+    codigo, salida, _ = lanzar(cmd, RAIZ, 60)
+    lineas = [l for l in salida.splitlines() if l.strip()]
+    return lineas[0].strip() if lineas else sim
+
+
+# --- Compilacion y medicion ---
+def compilar(caso, timeout):
+    modelo, (variante, sim, hilos, traza), dir_obj = caso
+    os.makedirs(dir_obj, exist_ok=True)
+    pasos, ejecutar, cwd = comandos(modelo, sim, hilos, traza, dir_obj)
+    t, salida = 0.0, ""
+    for cmd in pasos:
+        codigo, s, dt = lanzar(cmd, cwd, timeout)
+        t, salida = t + dt, salida + " ".join(cmd) + "\n" + s
+        if codigo != 0:
+            break
+    with open(os.path.join(dir_obj, "compilacion.log"), "w", encoding="utf-8") as f:
+        f.write(salida)
+    if codigo != 0:
+        return None, round(t, 3), [l for l in s.splitlines() if l.strip()][-10:]
+    return (ejecutar, cwd), round(t, 3), []
+
+
+def ejecutar(binario, sim, traza, dir_obj, n, unidad, timeout, log):
+    """(segundos, bytes de traza) de una ejecucion con +n=n; ValueError si falla
+    o si el banco no informa de n <unidad>"""
+    ruta = os.path.join(dir_obj, "traza.vcd")
+    cmd, cwd = binario
+    cmd = cmd + plusargs(sim, [f"n={n}"] + ([f"traza={ruta}"] if traza else []))
+    codigo, salida, t = lanzar(cmd, cwd, timeout)
+    log.write(f"{' '.join(cmd)}\n{salida}\n")
+    tam = 0
+    if os.path.isfile(ruta):
+        tam = os.path.getsize(ruta)
+        os.remove(ruta)
+    r = SALIDA.search(salida)
+    if codigo is None:
+        raise ValueError(f"tiempo agotado con n={n}")
+    if codigo != 0 or not r or int(r.group(1)) != n or r.group(2) != unidad:
+        lineas = [l for l in salida.splitlines() if l.strip()][-3:]
+        raise ValueError(f"n={n} (se esperaba '{n} {unidad}'): codigo {codigo}; " + " | ".join(lineas))
+    return t, tam
+
+
+def medir(caso, binario, args):
+    """Ritmo de un binario ya compilado (ver la cabecera)"""
+    modelo, (variante, sim, hilos, traza), dir_obj = caso
+    with open(os.path.join(dir_obj, "ejecucion.log"), "w", encoding="utf-8") as log:
+        n, unidad, historial = MODELOS[modelo]["n"], MODELOS[modelo]["unidad"], []
+        while True:
+            t, tam = ejecutar(binario, sim, traza, dir_obj, n, unidad, args.timeout, log)
+            historial.append((n, t))
+            if t >= args.min_s or n >= MAX_N:
+                break
+            n *= 2
+        if len(historial) == 1:
+            n1 = max(1, n // 4)
+            historial.insert(0, (n1, ejecutar(binario, sim, traza, dir_obj, n1, unidad, args.timeout, log)[0]))
+        (n1, t1), (n2, t2) = historial[-2:]
+        mejor = (n2 - n1) / (t2 - t1) if t2 > t1 else n2 / t2
+        for _ in range(args.repeticiones - 1):
+            t1 = ejecutar(binario, sim, traza, dir_obj, n1, unidad, args.timeout, log)[0]
+            t2, tam = ejecutar(binario, sim, traza, dir_obj, n2, unidad, args.timeout, log)
+            mejor = max(mejor, (n2 - n1) / (t2 - t1) if t2 > t1 else n2 / t2)
+    return {"n": n2, "run_s": round(t2, 3), "rate": round(mejor, 1),
+            "startup_s": round(max(0.0, t1 - n1 / mejor), 3), "trace_mb": round(tam / 2**20, 1)}
+
+
+def perfilar(modelo, n, dir_raiz, timeout):
+    """Tiempo por modulo del modelo con Verilator --prof-cfuncs; devuelve lineas de resumen"""
+    if not (shutil.which("gprof") and shutil.which("verilator_profcfunc")):
+        return ["--perfil necesita gprof y verilator_profcfunc en el PATH"]
+    dir_obj = os.path.join(dir_raiz, modelo, "verilator+perfil")
+    os.makedirs(dir_obj, exist_ok=True)
+    for viejo in glob.glob(os.path.join(dir_obj, "gmon.out*")):
+        os.remove(viejo)
+    pasos, (cmd, cwd), _ = comandos(modelo, "verilator", 1, False, dir_obj, perfil=True)
+    codigo, salida, _ = lanzar(pasos[0], RAIZ, timeout)
+    if codigo != 0:
+        return ["no compila con --prof-cfuncs"] + salida.splitlines()[-5:]
+    env = dict(os.environ, GMON_OUT_PREFIX=os.path.join(dir_obj, "gmon.out"))
+    codigo, salida, _ = lanzar(cmd + [f"+n={n}"], cwd, timeout, env)
+    gmon = glob.glob(os.path.join(dir_obj, "gmon.out*"))
+    if codigo != 0 or not gmon:
+        return [f"la ejecucion perfilada falla (codigo {codigo})"]
+    gprof = os.path.join(dir_obj, "gprof.txt")
+    with open(gprof, "w", encoding="utf-8") as f:
+        subprocess.run(["gprof", os.path.join(dir_obj, "bench"), gmon[0]], stdout=f, check=False)
+    codigo, salida, _ = lanzar(["verilator_profcfunc", gprof], RAIZ, timeout)
+    ruta = os.path.join(dir_obj, "perfil.txt")
+    with open(ruta, "w", encoding="utf-8") as f:
+        f.write(salida)
+    # la seccion por modulo, si verilator_profcfunc la reconoce
+    lineas = salida.splitlines()
+    inicio = next((i for i, l in enumerate(lineas) if re.search(r"summary by module", l, re.I)), None)
+    if inicio is None:
+        resumen = lineas[:20]
+    else:
+        resumen = []
+        for l in lineas[inicio:]:
+            if resumen and not l.strip():
+                break
+            resumen.append(l)
+    return resumen + [f"(completo en {os.path.relpath(ruta, RAIZ)})"]
+
+
+# --- Linea base ---
+def maquina():
+    return {"host": platform.node(), "cpu": platform.processor() or platform.machine(),
+            "cores": os.cpu_count()}
+
+
+def main():
+    ap = argparse.ArgumentParser(description="rendimiento de simulacion de los modelos del proyecto")
+    ap.add_argument("--sim", help="simuladores separados por comas (por defecto los del PATH)")
+    ap.add_argument("-k", dest="patron", help="solo los modelos cuyo nombre contiene el patron")
+    ap.add_argument("--variantes", help="solo las variantes cuyo nombre contiene el patron")
+    ap.add_argument("--hilos", type=int, default=4, help="hilos de la variante verilator-tN (1 = sin ella)")
+    ap.add_argument("--min-s", type=float, default=2.0, help="duracion minima de la ultima ejecucion")
+    ap.add_argument("--repeticiones", type=int, default=1, help="pares de ejecuciones por medicion")
+    ap.add_argument("--base", help="linea base con la que comparar")
+    ap.add_argument("--guardar", help="escribe o actualiza la linea base")
+    ap.add_argument("--umbral", type=float, default=0.10, help="caida relativa que es regresion")
+    ap.add_argument("--json", help="resultados en JSON")
+    ap.add_argument("--perfil", action="store_true", help="tiempo por modulo con --prof-cfuncs")
+    ap.add_argument("-j", type=int, default=os.cpu_count() or 1, help="compilaciones en paralelo")
+    ap.add_argument("--timeout", type=float, default=600, help="segundos por compilacion o ejecucion")
+    ap.add_argument("--dir", default="obj_rendimiento", help="directorio de trabajo")
+    args = ap.parse_args()
+
+    pedidos = args.sim.split(",") if args.sim else list(HERRAMIENTAS)
+    for sim in pedidos:
+        if sim not in HERRAMIENTAS:
+            ap.error(f"simulador desconocido: {sim}")
+    sims = [s for s in pedidos if all(shutil.which(h) for h in HERRAMIENTAS[s])]
+    for sim in sorted(set(pedidos) - set(sims)):
+        print(f"⚠ {sim}: no se encuentra {', '.join(HERRAMIENTAS[sim])} en el PATH", file=sys.stderr)
+    if not sims:
+        print("❌ ERROR: ningun simulador disponible", file=sys.stderr)
+        return 2
+    modelos = [m for m in MODELOS if not args.patron or args.patron in m]
+    vs = [v for v in variantes(sims, args.hilos) if not args.variantes or args.variantes in v[0]]
+    if not modelos or not vs:
+        print("❌ ERROR: ningun modelo o variante coincide", file=sys.stderr)
+        return 2
+    dir_raiz = os.path.join(RAIZ, args.dir)
+    casos = [(m, v, os.path.join(dir_raiz, m, v[0])) for m in modelos for v in vs]
+
+    base = {}
+    if args.base and os.path.isfile(args.base):
+        try:
+            with open(args.base, encoding="utf-8") as f:
+                base = json.load(f)
+            if not isinstance(base, dict) or not isinstance(base.get("results", {}), dict):
+                raise ValueError("no es una linea base de rendimiento.py")
+        except (OSError, ValueError) as e:
+            print(f"❌ ERROR: {args.base}: {e}", file=sys.stderr)
+            return 2
+        if base.get("machine") != maquina():
+            print(f"⚠ la linea base es de otra maquina ({base.get('machine')}): "
+                  "los ritmos no son comparables", file=sys.stderr)
+    elif args.base:
+        print(f"⚠ {args.base} no existe: no hay con que comparar", file=sys.stderr)
+    anteriores = base.get("results", {})
+    versiones = {s: version(s) for s in sims}
+
+    with ThreadPoolExecutor(max_workers=max(1, args.j)) as pool:
+        compilados = list(pool.map(lambda c: compilar(c, args.timeout), casos))
+
+    resultados, fallos, regresiones = [], 0, 0
+    print(f"   {'modelo':<11} {'variante':<16} {'unidad':<11} {'N':>10} {'s':>7} {'ritmo/s':>12} "
+          f"{'arranque':>8} {'traza MB':>8} {'base/s':>12} {'cambio':>8}")
+    for caso, (binario, compile_s, errores) in zip(casos, compilados):
+        modelo, (variante, sim, _, _), dir_obj = caso
+        clave = f"{modelo}/{variante}"
+        r = {"model": modelo, "variant": variante, "unit": MODELOS[modelo]["unidad"],
+             "compile_s": compile_s, "status": "ok", "errors": errores}
+        if binario is None:
+            r["status"], r["errors"] = "error", ["no compila"] + errores
+        else:
+            try:
+                r.update(medir(caso, binario, args))
+            except ValueError as e:
+                r["status"], r["errors"] = "error", [str(e)]
+        resultados.append(r)
+        if r["status"] != "ok":
+            fallos += 1
+            print(f"❌ {modelo:<11} {variante:<16} {r['errors'][0]}")
+            for l in r["errors"][1:4]:
+                print(f"     {l}")
+            continue
+        previo = anteriores.get(clave)
+        cambio, marca = "", "  "
+        if previo:
+            r["baseline"] = previo
+            r["change"] = round(r["rate"] / previo - 1, 4)
+            cambio = f"{100 * r['change']:+7.1f}%"
+            if r["change"] < -args.umbral:
+                r["status"], marca = "regression", "❌"
+                regresiones += 1
+            else:
+                marca = "✅"
+        print(f"{marca} {modelo:<11} {variante:<16} {r['unit']:<11} {r['n']:>10} {r['run_s']:>7.2f} "
+              f"{r['rate']:>12.1f} {r['startup_s']:>8.2f} {r['trace_mb'] or '':>8} "
+              f"{previo or '':>12} {cambio:>8}")
+
+    if args.perfil and "verilator" in sims:
+        for modelo in modelos:
+            medido = next((r for r in resultados if r["model"] == modelo and r["variant"] == "verilator"
+                           and "n" in r), None)
+            print(f"\nperfil de {modelo} (verilator --prof-cfuncs):")
+            for l in perfilar(modelo, medido["n"] if medido else MODELOS[modelo]["n"],
+                              dir_raiz, args.timeout):
+                print(f"  {l}")
+    elif args.perfil:
+        print("⚠ --perfil necesita verilator", file=sys.stderr)
+
+    medidos = sum(r["status"] != "error" for r in resultados)
+    print(f"\n{medidos} de {len(resultados)} mediciones con {', '.join(sims)}: "
+          f"{fallos} con error, {regresiones} regresiones (umbral {100 * args.umbral:.0f} %)")
+
+    if args.guardar:
+        nueva = {"results": {}}
+        if os.path.isfile(args.guardar):
+            with open(args.guardar, encoding="utf-8") as f:
+                nueva = json.load(f)
+        nueva.update(machine=maquina(), versions=dict(nueva.get("versions", {}), **versiones))
+        for r in resultados:
+            if "rate" in r:
+                nueva["results"][f"{r['model']}/{r['variant']}"] = r["rate"]
+        with open(args.guardar, "w", encoding="utf-8") as f:
+            json.dump(nueva, f, indent=1, sort_keys=True)
+        print(f"linea base: {args.guardar}")
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump({"machine": maquina(), "versions": versiones, "results": resultados},
+                      f, indent=2, ensure_ascii=False)
+    return 1 if fallos or regresiones else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
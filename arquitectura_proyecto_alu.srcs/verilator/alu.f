@@ -0,0 +1,14 @@
+// Verilator file list for the IEEE-754 alu (sources_1/new/alu.v), relative to
+// arquitectura_proyecto_alu.srcs/; see sim_alu.cpp for the build command
+--top-module alu
+--timescale 1ns/1ps
++1800-2017ext+v
+verilator/lint.vlt
+-Isources_1/new
+sources_1/new/alu.v
+sources_1/new/SumaResta.v
+sources_1/new/Multiplicacion.v
+sources_1/new/Division.v
+sources_1/new/RoundNearestEven.v
+sources_1/new/flags_operations.v
+sources_1/new/fp16_special_cases.v
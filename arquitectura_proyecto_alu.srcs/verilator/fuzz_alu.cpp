@@ -0,0 +1,426 @@
+// fuzz_alu.cpp - coverage-guided fuzzing of the Verilated alu against IEEE-754
+//
+// A libFuzzer (or AFL++) target: the fuzzer input is a sequence of vectors,
+// each one applied to the Verilated alu and compared with an independent
+// IEEE-754 result, cpp_model/ieee_ref.hpp (the host FPU, round to nearest
+// even, flags through <cfenv>). Random vectors almost never reach the rare
+// rounding and normalization corners of single precision; here the
+// mutations are steered by the compiler's edge coverage of the Verilated
+// code instead.
+//
+// Waivers: the RTL deviates from IEEE-754 in known ways (the same ones that
+// formal/alu_formal.sv waives for add, sub and mul, plus the divider's).
+// Each one is a named class below, saying which operands it covers and what
+// it excuses: the whole result and/or some flags. A difference outside every
+// waiver aborts, so the fuzzer keeps the input as a crash; a new deviation,
+// a wrong waiver or an RTL fix that makes one unnecessary all show up there
+// or in the FUZZ_ALU_WAIVERS table.
+//
+// Porting check: with FUZZ_ALU_MODEL=1 each vector is also compared bit for
+// bit with cpp_model/fp_model.hpp, which reproduces the RTL's quirks on
+// purpose; a mismatch there is a porting error on one side, not an IEEE
+// deviation.
+//
+// Input: records of a, b (WIDTH/8 bytes each, little-endian) and op (one
+// byte, low 2 bits), at most MAX_RECORDS per input; a trailing partial
+// record is ignored.
+//
+// Coverage: the fuzzer's feedback is the compiler's edge coverage (and,
+// with -use_value_profile=1, its comparison operands). Verilator's own
+// line/toggle counters are not fed back: reading them per input means a
+// coveragep()->write() and a parse of the dump, 2-10 ms for 3000-12000
+// points against ~10 us for the 90 vectors of an input, i.e. a fuzzer a few
+// hundred times slower (measured on dumps of that size; the 32-bit alu
+// declares ~6000 bits). A --coverage-line --coverage-toggle build still
+// works and writes the counts accumulated over the whole run to
+// FUZZ_ALU_COVERAGE on exit.
+//
+// Crashers: the first vector of every new signature (op, class of a and b,
+// whether y differs, which flags differ, and "model" for a porting
+// mismatch) is written to FUZZ_ALU_OUT (default fuzz_alu_out/) as
+// <signature>_vectores.mem and _esperados.mem, with the IEEE result (the
+// model's for a porting mismatch), in the format of the sim_1 testbenches
+// and gen_random/triage.py. Files are created exclusively, so parallel jobs
+// (-fork / -jobs) and later runs don't duplicate a signature.
+//
+// Build (from arquitectura_proyecto_alu.srcs/, Verilator 5 + clang), one binary per format:
+//   verilator -f verilator/alu.f --cc --exe --build -j 0 -O2 -Gsystem=16
+//     --compiler clang -CFLAGS "-g -fsanitize=fuzzer" -LDFLAGS -fsanitize=fuzzer
+//     --Mdir obj_fuzz16 -o fuzz_alu verilator/fuzz_alu.cpp
+// (-Gsystem=32 and obj_fuzz32 for single precision; never -ffast-math,
+// ieee_ref.hpp needs the host FPU's IEEE behaviour). For AFL++ add
+//   -MAKEFLAGS "CXX=afl-clang-fast++ LINK=afl-clang-fast++"
+// and use --Mdir obj_afl16. Without clang, -DFUZZ_ALU_STANDALONE in -CFLAGS
+// builds a plain main that runs the given inputs (or stdin), for replays
+// and for afl-fuzz with afl-g++.
+//
+// Usage:
+//   obj_fuzz16/fuzz_alu -max_len=450 -use_value_profile=1 corpus16/
+//   obj_fuzz32/fuzz_alu -max_len=810 -fork=8 -ignore_crashes=1 corpus32/
+//   afl-fuzz -i seeds16 -o afl16 -- obj_afl16/fuzz_alu
+//   obj_fuzz16/fuzz_alu crash-<sha1>         replay one crasher
+// Environment:
+//   FUZZ_ALU_OUT=DIR       directory for the deduplicated .mem crashers
+//   FUZZ_ALU_MODEL=1       also compare with fp_model.hpp (porting check)
+//   FUZZ_ALU_WAIVERS=1     on exit, print how often each waiver was used
+//                          and how often it alone excused a difference
+//   FUZZ_ALU_COVERAGE=F    on exit, write the coverage accumulated over
+//                          all inputs to F (--coverage builds only)
+//
+// Exit code: libFuzzer's (non-zero after a crash); the standalone build
+// aborts on the first unwaived difference and returns 2 on unreadable
+// inputs.
+//
+// Status: only the standalone build has been compiled, against stub
+// Verilator headers standing in fp_model.hpp for the alu; the waivers leave
+// no difference between fp_model.hpp and ieee_ref.hpp over every 997th
+// half-precision operand pair (all four ops) and 20M structured
+// single-precision vectors. No fuzzing campaign has been run yet.
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Valu.h"
+#include "verilated.h"
+#if VM_COVERAGE
+#include "verilated_cov.h"
+#endif
+
+#include "../cpp_model/fp_model.hpp"
+#include "../cpp_model/ieee_ref.hpp"
+
+static const int WIDTH = 8 * (int)sizeof(Valu::y);
+static const int FRAC = WIDTH == 16 ? 10 : 23;
+static const uint32_t EMAX = (1u << (WIDTH - 1 - FRAC)) - 1;
+static const int BIAS = (int)(EMAX >> 1);
+static const size_t BYTES = WIDTH / 8;
+static const size_t RECORD = 2 * BYTES + 1;
+static const size_t MAX_RECORDS = 90;  // -max_len = MAX_RECORDS * RECORD
+static const char* OP_NAME[4] = {"add", "sub", "mul", "div"};
+
+// ---------------------------------------------------------------------------
+// Known deviations from IEEE-754 (waivers)
+// ---------------------------------------------------------------------------
+struct Waiver {
+  const char* name;
+  bool y;          // excuses the whole result
+  unsigned flags;  // excused flags, {invalid, div0, ovf, unf, inx}
+};
+
+enum {
+  W_QNAN_INVALID,
+  W_INF_INF_INVALID,
+  W_INF_FLAGS,
+  W_SUBNORMAL_ZERO_UNF,
+  W_ZERO_MINUS_ZERO,
+  W_EXP0_OPERAND,
+  W_TINY_RESULT,
+  W_ADD_INEXACT,
+  W_ADD_FAR,
+  W_SUB_ALIGN,
+  W_MUL_LOW_BITS,
+  W_ZERO_DIV_ZERO,
+  W_DIV_BY_ZERO_FLAGS,
+  W_DIV_EXP_OVERFLOW,
+  W_DIV_STICKY,
+  W_COUNT
+};
+
+static const Waiver WAIVERS[W_COUNT] = {
+    {"qnan_invalid", false, 0x10},
+    {"inf_inf_invalid", false, 0x10},
+    {"inf_flags", false, 0x07},
+    {"subnormal_zero_unf", false, 0x02},
+    {"zero_minus_zero", true, 0x00},
+    {"exp0_operand", true, 0x1F},
+    {"tiny_result", true, 0x1F},
+    {"add_inexact", false, 0x01},
+    {"add_far", true, 0x00},
+    {"sub_align", true, 0x01},
+    {"mul_low_bits", true, 0x01},
+    {"zero_div_zero", true, 0x00},
+    {"div_by_zero_flags", false, 0x0A},
+    {"div_exp_overflow", true, 0x07},
+    {"div_sticky", true, 0x00},
+};
+
+static uint32_t expo(uint32_t v) { return (v >> FRAC) & EMAX; }
+static uint32_t frac(uint32_t v) { return v & ((1u << FRAC) - 1); }
+static bool is_zero(uint32_t v) { return expo(v) == 0 && frac(v) == 0; }
+static bool is_sub(uint32_t v) { return expo(v) == 0 && frac(v) != 0; }
+static bool is_inf(uint32_t v) { return expo(v) == EMAX && frac(v) == 0; }
+static bool is_nan(uint32_t v) { return expo(v) == EMAX && frac(v) != 0; }
+static bool is_norm(uint32_t v) { return expo(v) != 0 && expo(v) != EMAX; }
+
+// bit W_* set for every waiver that covers (a, b, op); ref is the IEEE result
+static uint32_t waivers(uint32_t a, uint32_t b, unsigned op, const ieeeref::Result& ref) {
+  uint32_t w = 0;
+  auto set = [&w](int i, bool c) { if (c) w |= 1u << i; };
+  const bool add = op < 2;
+  const bool both_norm = is_norm(a) && is_norm(b);
+  const bool eff_sub = (((a ^ b) >> (WIDTH - 1)) & 1) ^ (op == 1);  // opposite signs
+  const int exp_diff = std::abs((int)expo(a) - (int)expo(b));
+  // operands that reach the datapath, not fp16_special_case_handler
+  const bool datapath =
+      !is_nan(a) && !is_nan(b) && !is_inf(a) && !is_inf(b) &&
+      (add ? !((is_zero(a) || is_zero(b)) && !is_norm(a) && !is_norm(b))
+           : !is_zero(a) && !is_zero(b));
+
+  // NaN operands: any NaN raises invalid, also a quiet one (IEEE: only sNaN)
+  set(W_QNAN_INVALID, is_nan(a) || is_nan(b));
+  // Inf op Inf: both_are_inf raises invalid even when the result is a valid
+  // Inf (Inf + Inf, Inf * Inf); in 32 bits it looks at the low 16 bits only
+  set(W_INF_INF_INVALID, is_inf(a) && is_inf(b));
+  // Inf op x with an Inf result raises inx, plus ovf for a +Inf operand and
+  // unf for a -Inf one; IEEE raises nothing (the result is exact)
+  set(W_INF_FLAGS, (is_inf(a) || is_inf(b)) && !is_nan(a) && !is_nan(b));
+  // subnormal +/- zero: the handler returns the subnormal operand with unf
+  // set, without inx; IEEE raises nothing (the result is exact)
+  set(W_SUBNORMAL_ZERO_UNF, add && ((is_sub(a) && is_zero(b)) || (is_zero(a) && is_sub(b))));
+  // -0 - 0 and -0 - -0: the handler takes the sign as sign(a) & sign(b) of
+  // the operands before b is negated, so they return +0 and -0 (IEEE: -0, +0)
+  set(W_ZERO_MINUS_ZERO, op == 1 && is_zero(a) && is_zero(b) && (a >> (WIDTH - 1)));
+  // an operand with a zero exponent field that reaches the datapath: the
+  // units read it with a hidden 1, as 1.f * 2^-BIAS instead of 0.f * 2^(1-BIAS)
+  set(W_EXP0_OPERAND, datapath && (expo(a) == 0 || expo(b) == 0));
+  // tiny results of the datapath: the adder does not denormalize (the
+  // exponent wraps below zero), the multiplier and the divider flush to zero
+  set(W_TINY_RESULT, datapath && (is_sub(ref.y) || (ref.flags & ieeeref::UNF)));
+  // effective addition: inx only counts bits lost in the alignment shift,
+  // not the bit dropped when the sum carries out
+  set(W_ADD_INEXACT, add && both_norm && !eff_sub);
+  // effective addition with exponents more than 10 apart: the alignment
+  // shifter keeps 10 bits below the significand ({1, m, 10'b0}), the rest
+  // are lost for sticky and ties round wrongly
+  set(W_ADD_FAR, add && both_norm && !eff_sub && exp_diff > 10);
+  // effective subtraction with different exponents: the aligned operand's
+  // guard and sticky bits are dropped and the difference is truncated and
+  // renormalized from FRAC bits (errors of several ulps, wrong inx)
+  set(W_SUB_ALIGN, add && both_norm && eff_sub && exp_diff != 0);
+  // mul: the product bits below the sticky window (FRAC-5 bits with a
+  // carry-out, FRAC-6 without) are dropped: ties round to even wrongly and
+  // inx is missed
+  const uint64_t prod = (uint64_t)((1u << FRAC) | frac(a)) * ((1u << FRAC) | frac(b));
+  const uint64_t low = ((prod >> (2 * FRAC + 1)) & 1) ? prod & ((1ull << (FRAC - 5)) - 1)
+                                                      : prod & ((1ull << (FRAC - 6)) - 1);
+  set(W_MUL_LOW_BITS, op == 2 && both_norm && low != 0);
+  // 0 / 0: the handler returns a signed zero with invalid (IEEE: NaN)
+  set(W_ZERO_DIV_ZERO, op == 3 && is_zero(a) && is_zero(b));
+  // x / 0: the handler raises unf along with div0, and takes Inf / 0 as a
+  // division by zero too (IEEE: an exact Inf, no flags)
+  set(W_DIV_BY_ZERO_FLAGS, op == 3 && is_zero(b) && !is_zero(a) && !is_nan(a));
+  // div: overflow is decided on ea - eb + BIAS before normalization and the
+  // exponent wraps, so a quotient below 1.0 at that exponent goes to Inf and
+  // a wrapped one comes out as +/-0 with ovf and unf
+  set(W_DIV_EXP_OVERFLOW, op == 3 && both_norm && (int)expo(a) - (int)expo(b) + BIAS >= (int)EMAX);
+  // div: the remainder only feeds inx, not the rounding: a quotient whose
+  // bits below guard are zero rounds as a tie although it is above one
+  const uint64_t num = (uint64_t)((1u << FRAC) | frac(a)) << (FRAC + 5);
+  const uint64_t den = (1u << FRAC) | frac(b);
+  const uint64_t quo = num / den;
+  const uint64_t win = ((quo >> (FRAC + 5)) & 1) ? quo : quo << 1;  // guard at bit 4
+  set(W_DIV_STICKY, op == 3 && both_norm && num % den != 0 && ((win >> 4) & 1) && (win & 15) == 0);
+  return w;
+}
+
+static bool excused(uint32_t w, bool y_differs, unsigned flags_differ) {
+  bool y = false;
+  unsigned flags = 0;
+  for (int i = 0; i < W_COUNT; i++)
+    if ((w >> i) & 1) {
+      y = y || WAIVERS[i].y;
+      flags |= WAIVERS[i].flags;
+    }
+  return (!y_differs || y) && (flags_differ & ~flags) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Target
+// ---------------------------------------------------------------------------
+struct Target {
+  std::unique_ptr<VerilatedContext> ctx;
+  std::unique_ptr<Valu> dut;
+  std::string out_dir;
+  bool check_model = false;
+  uint64_t used[W_COUNT] = {};    // differences each waiver covered
+  uint64_t needed[W_COUNT] = {};  // ... that no other waiver covered
+
+  Target() : ctx(new VerilatedContext), dut(new Valu(ctx.get())) {
+    const char* out = std::getenv("FUZZ_ALU_OUT");
+    out_dir = out && *out ? out : "fuzz_alu_out";
+    const char* model = std::getenv("FUZZ_ALU_MODEL");
+    check_model = model && *model && std::strcmp(model, "0") != 0;
+  }
+
+  // coverage.dat with the counts of the whole run, for verilator_coverage
+  void write_coverage(const char* path) {
+#if VM_COVERAGE
+    ctx->coveragep()->write(path);
+#else
+    std::fprintf(stderr, "fuzz_alu: built without --coverage, %s not written\n", path);
+#endif
+  }
+
+  void print_waivers() const {
+    std::fprintf(stderr, "fuzz_alu: %-20s %12s %12s\n", "waiver", "used", "needed");
+    for (int i = 0; i < W_COUNT; i++)
+      std::fprintf(stderr, "fuzz_alu: %-20s %12llu %12llu\n", WAIVERS[i].name,
+                   (unsigned long long)used[i], (unsigned long long)needed[i]);
+  }
+
+  void apply(uint32_t a, uint32_t b, unsigned op) {
+    dut->a = a;
+    dut->b = b;
+    dut->op = op;
+    dut->eval();
+  }
+};
+
+static Target* g_target = nullptr;
+
+static void at_exit() {
+  if (!g_target) return;
+  if (const char* path = std::getenv("FUZZ_ALU_COVERAGE")) g_target->write_coverage(path);
+  const char* w = std::getenv("FUZZ_ALU_WAIVERS");
+  if (w && *w && std::strcmp(w, "0") != 0) g_target->print_waivers();
+}
+
+// ---------------------------------------------------------------------------
+// Crashers
+// ---------------------------------------------------------------------------
+static const char* cls(uint32_t v) {
+  if (expo(v) == 0) return frac(v) ? "denorm" : "zero";
+  if (expo(v) == EMAX) return frac(v) ? "nan" : "inf";
+  return "normal";
+}
+
+static std::string bin(uint32_t v, int n) {
+  std::string s(n, '0');
+  for (int i = 0; i < n; i++)
+    if ((v >> (n - 1 - i)) & 1) s[i] = '1';
+  return s;
+}
+
+// writes 'text' to 'path' unless it already exists; true if written
+static bool write_new(const std::string& path, const std::string& text) {
+  const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) return false;
+  const bool ok = write(fd, text.data(), text.size()) == (ssize_t)text.size();
+  close(fd);
+  return ok;
+}
+
+// 'exp' is the IEEE result, or fp_model's when 'model' is set
+static void report(const Target& t, uint32_t a, uint32_t b, unsigned op, uint32_t y,
+                   unsigned flags, uint32_t exp_y, unsigned exp_flags, bool model) {
+  const int h = WIDTH / 4;
+  std::fprintf(stderr,
+               "fuzz_alu: %s %s a=%0*x b=%0*x: %s y=%0*x flags=%s, alu y=%0*x flags=%s\n",
+               model ? "model mismatch" : "unwaived IEEE difference", OP_NAME[op], h, a, h, b,
+               model ? "model" : "ieee", h, exp_y, bin(exp_flags, 5).c_str(), h, y,
+               bin(flags, 5).c_str());
+  if (!model) {
+    const uint32_t w = waivers(a, b, op, {exp_y, exp_flags});
+    for (int i = 0; i < W_COUNT; i++)
+      if ((w >> i) & 1) std::fprintf(stderr, "fuzz_alu:   covered in part by %s\n", WAIVERS[i].name);
+  }
+
+  // e.g. 32_add_normal_denorm_y_flags01: y wrong and inexact wrong
+  char sig[96], diff[16] = "";
+  if (flags != exp_flags) std::snprintf(diff, sizeof diff, "_flags%02x", flags ^ exp_flags);
+  std::snprintf(sig, sizeof sig, "%d_%s%s_%s_%s%s%s", WIDTH, model ? "model_" : "", OP_NAME[op],
+                cls(a), cls(b), y != exp_y ? "_y" : "", diff);
+  mkdir(t.out_dir.c_str(), 0755);
+  const std::string base = t.out_dir + "/" + sig;
+  if (write_new(base + "_vectores.mem",
+                bin(a, WIDTH) + " " + bin(b, WIDTH) + " " + bin(op, 2) + "\n")) {
+    write_new(base + "_esperados.mem", bin(exp_y, WIDTH) + " " + bin(exp_flags, 5) + "\n");
+    std::fprintf(stderr, "fuzz_alu: new signature, written %s_vectores.mem\n", base.c_str());
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Fuzzer entry points
+// ---------------------------------------------------------------------------
+static uint32_t load_le(const uint8_t* p) {
+  uint32_t v = 0;
+  for (size_t i = 0; i < BYTES; i++) v |= (uint32_t)p[i] << (8 * i);
+  return v;
+}
+
+extern "C" int LLVMFuzzerInitialize(int*, char***) {
+  g_target = new Target;
+  std::atexit(at_exit);
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  Target& t = *g_target;
+  const size_t n = std::min(size / RECORD, MAX_RECORDS);
+  for (size_t r = 0; r < n; r++) {
+    const uint8_t* p = data + r * RECORD;
+    const uint32_t a = load_le(p), b = load_le(p + BYTES);
+    const unsigned op = p[2 * BYTES] & 3u;
+    t.apply(a, b, op);
+    const uint32_t y = t.dut->y;
+    const unsigned flags = t.dut->ALUFlags;
+
+    const ieeeref::Result ref = ieeeref::eval(a, b, op, WIDTH);
+    if (y != ref.y || flags != ref.flags) {
+      const bool y_differs = y != ref.y;
+      const unsigned flags_differ = flags ^ ref.flags;
+      const uint32_t w = waivers(a, b, op, ref);
+      if (!excused(w, y_differs, flags_differ)) {
+        report(t, a, b, op, y, flags, ref.y, ref.flags, false);
+        std::abort();
+      }
+      for (int i = 0; i < W_COUNT; i++)
+        if ((w >> i) & 1) {
+          t.used[i]++;
+          if (!excused(w & ~(1u << i), y_differs, flags_differ)) t.needed[i]++;
+        }
+    }
+
+    if (t.check_model) {
+      const fpmodel::Result m = WIDTH == 16 ? fpmodel::Half::eval(a, b, op)
+                                            : fpmodel::Single::eval(a, b, op);
+      if (y != m.y || flags != m.flags) {
+        report(t, a, b, op, y, flags, m.y, m.flags, true);
+        std::abort();
+      }
+    }
+  }
+  return 0;
+}
+
+#ifdef FUZZ_ALU_STANDALONE
+// runs each file (or stdin) as one input, as libFuzzer does for file arguments
+int main(int argc, char** argv) {
+  LLVMFuzzerInitialize(&argc, &argv);
+  std::vector<const char*> paths(argv + 1, argv + argc);
+  if (paths.empty()) paths.push_back("-");
+  for (const char* path : paths) {
+    FILE* f = std::strcmp(path, "-") == 0 ? stdin : std::fopen(path, "rb");
+    if (!f) {
+      std::fprintf(stderr, "fuzz_alu: cannot read %s: %s\n", path, std::strerror(errno));
+      return 2;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buf[4096];
+    for (size_t got; (got = std::fread(buf, 1, sizeof buf, f)) > 0;) data.insert(data.end(), buf, buf + got);
+    if (f != stdin) std::fclose(f);
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+  }
+  return 0;
+}
+#endif
@@ -0,0 +1,15 @@
+# hello.s
+#
+# Smoke test for sim_top: console and tohost MMIO.
+# If successful, it prints "Hi" and sim_top reports PASSED
+
+#       RISC-V Assembly         Description               Address   Machine Code
+main:   addi x1, x0, 72         # x1 = 'H'                 0         04800093
+        sw   x1, -12(x0)        # console <- 'H'           4         FE102A23
+        addi x1, x0, 105        # x1 = 'i'                 8         06900093
+        sw   x1, -12(x0)        # console <- 'i'           C         FE102A23
+        addi x1, x0, 10         # x1 = '\n'                10        00A00093
+        sw   x1, -12(x0)        # console <- '\n'          14        FE102A23
+        addi x1, x0, 1          # x1 = 1                   18        00100093
+        sw   x1, -16(x0)        # tohost <- 1 (pass)       1C        FE102823
+done:   beq  x0, x0, done       # infinite loop            20        00000063
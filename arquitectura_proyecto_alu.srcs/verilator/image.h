@@ -0,0 +1,144 @@
+// image.h - program images for the RISC-V harnesses
+//
+// Loads a 32-bit little-endian RISC-V ELF (PT_LOAD segments) or a
+// $readmemh-style hex file (one 32-bit word per line, optional @addr
+// lines with a word address, // comments) as in pipeline/riscvtest.txt.
+// The core starts at PC 0, so ELF programs must be linked at address 0
+// (e.g. -Ttext=0); a different entry point is reported as a warning.
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Segment {
+  uint32_t addr;              // byte address
+  std::vector<uint8_t> bytes;
+};
+
+struct Image {
+  std::vector<Segment> segments;
+  uint32_t entry = 0;
+
+  // little-endian word view, calls f(word_address, word) for every word touched
+  template <class F> void for_each_word(F f) const {
+    for (const Segment& s : segments) {
+      uint32_t first = s.addr & ~3u;
+      uint32_t end = s.addr + (uint32_t)s.bytes.size();
+      for (uint32_t a = first; a < end; a += 4) {
+        uint32_t w = 0;
+        for (int b = 0; b < 4; b++) {
+          uint32_t ba = a + b;
+          if (ba >= s.addr && ba < end) w |= (uint32_t)s.bytes[ba - s.addr] << (8 * b);
+        }
+        f(a >> 2, w);
+      }
+    }
+  }
+
+  // one past the highest byte address of any segment (0 for an empty image)
+  uint64_t end() const {
+    uint64_t e = 0;
+    for (const Segment& s : segments)
+      if (!s.bytes.empty() && s.addr + (uint64_t)s.bytes.size() > e) e = s.addr + (uint64_t)s.bytes.size();
+    return e;
+  }
+};
+
+namespace image_detail {
+
+struct Elf32Ehdr {
+  uint8_t  ident[16];
+  uint16_t type, machine;
+  uint32_t version, entry, phoff, shoff, flags;
+  uint16_t ehsize, phentsize, phnum, shentsize, shnum, shstrndx;
+};
+
+struct Elf32Phdr {
+  uint32_t type, offset, vaddr, paddr, filesz, memsz, flags, align;
+};
+
+inline bool load_elf(const std::vector<uint8_t>& f, Image& img, std::string& err) {
+  Elf32Ehdr eh;
+  if (f.size() < sizeof eh) { err = "truncated ELF header"; return false; }
+  std::memcpy(&eh, f.data(), sizeof eh);
+  if (eh.ident[4] != 1 || eh.ident[5] != 1) { err = "not a 32-bit little-endian ELF"; return false; }
+  if (eh.machine != 243) { err = "not a RISC-V ELF"; return false; }
+  img.entry = eh.entry;
+  for (unsigned i = 0; i < eh.phnum; i++) {
+    Elf32Phdr ph;
+    size_t off = eh.phoff + (size_t)i * eh.phentsize;
+    if (off + sizeof ph > f.size()) { err = "truncated program header"; return false; }
+    std::memcpy(&ph, f.data() + off, sizeof ph);
+    if (ph.type != 1 || ph.memsz == 0) continue; // PT_LOAD only
+    if (ph.offset + ph.filesz > f.size()) { err = "truncated segment"; return false; }
+    Segment s;
+    s.addr = ph.paddr;
+    s.bytes.assign(ph.memsz, 0); // .bss is zero-filled
+    std::memcpy(s.bytes.data(), f.data() + ph.offset, ph.filesz);
+    img.segments.push_back(std::move(s));
+  }
+  return true;
+}
+
+inline bool load_hex(const std::string& text, Image& img, std::string& err) {
+  std::istringstream in(text);
+  std::string tok;
+  uint32_t waddr = 0;
+  Segment cur{0, {}};
+  auto flush = [&]() {
+    if (!cur.bytes.empty()) img.segments.push_back(cur);
+    cur.bytes.clear();
+  };
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t c = line.find("//");
+    if (c != std::string::npos) line.erase(c);
+    std::istringstream ls(line);
+    while (ls >> tok) {
+      if (tok[0] == '@') {
+        flush();
+        waddr = (uint32_t)std::stoul(tok.substr(1), nullptr, 16);
+        cur.addr = waddr * 4;
+        continue;
+      }
+      uint32_t w;
+      try { w = (uint32_t)std::stoul(tok, nullptr, 16); }
+      catch (...) { err = "bad hex word '" + tok + "'"; return false; }
+      if (cur.bytes.empty()) cur.addr = waddr * 4;
+      for (int b = 0; b < 4; b++) cur.bytes.push_back((uint8_t)(w >> (8 * b)));
+      waddr++;
+    }
+  }
+  flush();
+  return true;
+}
+
+} // namespace image_detail
+
+inline bool load_image(const std::string& path, Image& img, std::string& err) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) { err = "cannot open " + path; return false; }
+  std::vector<uint8_t> f((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (f.size() >= 4 && f[0] == 0x7f && f[1] == 'E' && f[2] == 'L' && f[3] == 'F')
+    return image_detail::load_elf(f, img, err);
+  return image_detail::load_hex(std::string(f.begin(), f.end()), img, err);
+}
+
+// mainmem and the ISS index their words with the low mem_bits bits of the
+// address, so an image larger than 4 << mem_bits bytes, or linked above it,
+// would silently wrap onto itself; false (with err set) in that case
+inline bool image_fits(const Image& img, unsigned mem_bits, std::string& err) {
+  uint64_t size = 4ull << mem_bits;
+  if (img.end() <= size) return true;
+  char buf[160];
+  std::snprintf(buf, sizeof buf, "image ends at 0x%llx, beyond the 0x%llx bytes of memory (MEM_BITS = %u)",
+                (unsigned long long)img.end(), (unsigned long long)size, mem_bits);
+  err = buf;
+  return false;
+}
@@ -0,0 +1,365 @@
+// iss.h - functional instruction-set simulator for the RISC-V core
+//
+// RV32I, RV32M, RV32C, Zicsr and the F/Zfh subset of the core (flw, flh, fsw, fsh,
+// fadd/fsub/fmul/fdiv .s/.h, fmv.x.w/.h, fmv.w/.h.x). FP arithmetic goes
+// through the bit-exact model of the IEEE-754 alu (cpp_model/fp_model.hpp),
+// so results and flags match the RTL, quirks included: always
+// round-to-nearest-even, improperly NaN-boxed halves read as 0x7E00.
+//
+// One step() executes one instruction and describes its architectural
+// effects in a Retire record, which is what the lockstep checker compares
+// against the RTL (sim_cosim.cpp). Like the core, the ISS is Harvard:
+// instructions are fetched from their own copy of the program and stores
+// only reach data memory. Both are flat little-endian arrays of
+// 4 << mem_bits bytes that wrap like mainmem; the MMIO page 0xFFFFF000 is
+// not backed (stores are only reported, loads return 0).
+// Counter CSRs (cycle, time, instret, hpmcounters) are timing dependent:
+// their reads are flagged so the checker can take the value from the RTL.
+// ecall and ebreak retire as nops, as in the core (no traps).
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "../cpp_model/fp_model.hpp"
+
+struct Retire {
+  uint32_t pc = 0, instr = 0;
+  bool we = false;              // integer register write (rd != 0)
+  uint32_t rd = 0, wd = 0;
+  bool fwe = false;             // FP register write
+  bool fwe_late = false;        // ... done later by the multi-cycle fdiv
+  uint32_t frd = 0, fwd = 0;
+  bool mwe = false;             // store
+  unsigned msize = 0;           // 1, 2 or 4 bytes
+  uint32_t madr = 0, mwd = 0;
+  bool counter_read = false;    // wd is a counter value (timing dependent)
+  bool illegal = false;         // not implemented here, executed as a nop
+};
+
+class Iss {
+ public:
+  uint32_t pc = 0;
+  uint32_t x[32] = {};
+  uint32_t f[32] = {};
+  uint32_t fflags = 0, frm = 0;
+  uint64_t instret = 0;
+
+  explicit Iss(unsigned mem_bits = 20)
+      : imem_(1u << mem_bits, 0), mem_(4u << mem_bits, 0), mask_((4u << mem_bits) - 1) {}
+
+  static bool mmio(uint32_t a) { return (a >> 12) == 0xFFFFF; }
+
+  // program loading: the word goes to both memories
+  void store_word(uint32_t waddr, uint32_t w) {
+    imem_[waddr & (mask_ >> 2)] = w;
+    write(waddr << 2, w, 4);
+  }
+  uint32_t fetch_word(uint32_t waddr) const { return imem_[waddr & (mask_ >> 2)]; }
+  uint32_t fetch_half(uint32_t ad) const { return fetch_word(ad >> 2) >> (16 * (ad >> 1 & 1)) & 0xffff; }
+  uint32_t load_word(uint32_t waddr) const { return read(waddr << 2, 4); }
+  size_t mem_words() const { return imem_.size(); }
+
+  Retire step() {
+    Retire r;
+    const uint32_t lo = fetch_half(pc), raw = (lo & 3) != 3 ? lo : lo | fetch_half(pc + 2) << 16;
+    const uint32_t len = (lo & 3) != 3 ? 2 : 4;
+    const uint32_t in = len == 2 ? expand(lo) : raw;
+    r.pc = pc;
+    r.instr = raw;
+
+    const uint32_t op = in & 0x7f, rd = (in >> 7) & 31, f3 = (in >> 12) & 7;
+    const uint32_t rs1 = (in >> 15) & 31, rs2 = (in >> 20) & 31, f7 = in >> 25;
+    const uint32_t a = x[rs1], b = x[rs2];
+    const int32_t immi = (int32_t)in >> 20;
+    const int32_t imms = ((int32_t)in >> 25 << 5) | (int32_t)((in >> 7) & 31);
+    const int32_t immb = ((int32_t)in >> 31 << 12) | (int32_t)(((in >> 7) & 1) << 11) |
+                         (int32_t)(((in >> 25) & 0x3f) << 5) | (int32_t)(((in >> 8) & 0xf) << 1);
+    const int32_t immj = ((int32_t)in >> 31 << 20) | (int32_t)(in & 0xff000) |
+                         (int32_t)(((in >> 20) & 1) << 11) | (int32_t)(((in >> 21) & 0x3ff) << 1);
+    uint32_t next = pc + len;
+
+    auto setx = [&](uint32_t v) {
+      if (rd == 0) return;
+      r.we = true;
+      r.rd = rd;
+      r.wd = v;
+    };
+    auto setf = [&](uint32_t v, bool late) {
+      r.fwe = true;
+      r.fwe_late = late;
+      r.frd = rd;
+      r.fwd = v;
+    };
+
+    switch (op) {
+      case 0x37: setx(in & 0xfffff000); break;                    // lui
+      case 0x17: setx(pc + (in & 0xfffff000)); break;             // auipc
+      case 0x6f: setx(pc + len); next = pc + immj; break;         // jal
+      case 0x67: setx(pc + len); next = (a + immi) & ~1u; break;  // jalr
+      case 0x63: {                                                // branches
+        bool t = false;
+        switch (f3) {
+          case 0: t = a == b; break;
+          case 1: t = a != b; break;
+          case 4: t = (int32_t)a < (int32_t)b; break;
+          case 5: t = (int32_t)a >= (int32_t)b; break;
+          case 6: t = a < b; break;
+          case 7: t = a >= b; break;
+          default: r.illegal = true;
+        }
+        if (t) next = pc + immb;
+        break;
+      }
+      case 0x03: {                                                // loads
+        const uint32_t ad = a + immi;
+        switch (f3) {
+          case 0: setx((uint32_t)(int8_t)read(ad, 1)); break;
+          case 1: setx((uint32_t)(int16_t)read(ad, 2)); break;
+          case 2: setx(read(ad, 4)); break;
+          case 4: setx(read(ad, 1)); break;
+          case 5: setx(read(ad, 2)); break;
+          default: r.illegal = true;
+        }
+        break;
+      }
+      case 0x23: {                                                // stores
+        const unsigned size = f3 == 0 ? 1 : f3 == 1 ? 2 : 4;
+        if (f3 > 2) { r.illegal = true; break; }
+        do_store(r, a + imms, b, size);
+        break;
+      }
+      case 0x13: setx(alu(f3, a, (uint32_t)immi, false, f7 == 0x20)); break;
+      case 0x33:
+        if (f7 == 1) setx(muldiv(f3, a, b));
+        else if (f7 == 0 || f7 == 0x20) setx(alu(f3, a, b, f7 == 0x20, f7 == 0x20));
+        else r.illegal = true;
+        break;
+      case 0x0f: break;                                           // fence
+      case 0x07: {                                                // flw, flh
+        const uint32_t ad = a + immi;
+        if (f3 == 2) setf(read(ad, 4), false);
+        else if (f3 == 1) setf(0xffff0000u | read(ad, 2), false);
+        else r.illegal = true;
+        break;
+      }
+      case 0x27: {                                                // fsw, fsh
+        if (f3 == 2) do_store(r, a + imms, f[rs2], 4);
+        else if (f3 == 1) do_store(r, a + imms, f[rs2], 2);
+        else r.illegal = true;
+        break;
+      }
+      case 0x53: op_fp(r, in, rd, rs1, rs2, setx, setf); break;
+      case 0x73: op_csr(r, in, rd, rs1, f3, a, setx); break;
+      default: r.illegal = true;
+    }
+
+    // the RTL writes registers as part of retiring the instruction
+    if (r.we) x[r.rd] = r.wd;
+    if (r.fwe) f[r.frd] = r.fwd;
+    x[0] = 0;
+    pc = next;
+    instret++;
+    return r;
+  }
+
+  // RV32C: 32-bit equivalent of a 16-bit instruction, 0 if reserved or
+  // not supported (same rules as pipeline/cdec.v)
+  static uint32_t expand(uint32_t c) {
+    auto bit = [c](unsigned hi, unsigned lo) { return (c >> lo) & ((1u << (hi - lo + 1)) - 1); };
+    auto sext = [](uint32_t v, unsigned bits) { return (uint32_t)((int32_t)(v << (32 - bits)) >> (32 - bits)); };
+    auto I = [](uint32_t imm, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t op) {
+      return (imm & 0xfff) << 20 | rs1 << 15 | f3 << 12 | rd << 7 | op;
+    };
+    auto S = [](uint32_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3, uint32_t op) {
+      return (imm >> 5 & 0x7f) << 25 | rs2 << 20 | rs1 << 15 | f3 << 12 | (imm & 31) << 7 | op;
+    };
+    auto R = [](uint32_t f7, uint32_t rs2, uint32_t rs1, uint32_t f3, uint32_t rd) {
+      return f7 << 25 | rs2 << 20 | rs1 << 15 | f3 << 12 | rd << 7 | 0x33;
+    };
+    auto J = [](uint32_t imm, uint32_t rd) {
+      return (imm >> 20 & 1) << 31 | (imm >> 1 & 0x3ff) << 21 | (imm >> 11 & 1) << 20 |
+             (imm >> 12 & 0xff) << 12 | rd << 7 | 0x6f;
+    };
+    auto B = [](uint32_t imm, uint32_t rs1, uint32_t f3) {
+      return (imm >> 12 & 1) << 31 | (imm >> 5 & 0x3f) << 25 | rs1 << 15 | f3 << 12 |
+             (imm >> 1 & 0xf) << 8 | (imm >> 11 & 1) << 7 | 0x63;
+    };
+    const uint32_t rd = bit(11, 7), rs2 = bit(6, 2), rdp = 8 + bit(4, 2), rs1p = 8 + bit(9, 7);
+    const uint32_t immci = sext(bit(12, 12) << 5 | bit(6, 2), 6);
+    const uint32_t imm4spn = bit(10, 7) << 6 | bit(12, 11) << 4 | bit(5, 5) << 3 | bit(6, 6) << 2;
+    const uint32_t imm16sp = sext(bit(12, 12) << 9 | bit(4, 3) << 7 | bit(5, 5) << 6 | bit(2, 2) << 5 | bit(6, 6) << 4, 10);
+    const uint32_t immlw = bit(5, 5) << 6 | bit(12, 10) << 3 | bit(6, 6) << 2;
+    const uint32_t immlwsp = bit(3, 2) << 6 | bit(12, 12) << 5 | bit(6, 4) << 2;
+    const uint32_t immswsp = bit(8, 7) << 6 | bit(12, 9) << 2;
+    const uint32_t immj = sext(bit(12, 12) << 11 | bit(8, 8) << 10 | bit(10, 9) << 8 | bit(6, 6) << 7 |
+                               bit(7, 7) << 6 | bit(2, 2) << 5 | bit(11, 11) << 4 | bit(5, 3) << 1, 12);
+    const uint32_t immb = sext(bit(12, 12) << 8 | bit(6, 5) << 6 | bit(2, 2) << 5 | bit(11, 10) << 3 | bit(4, 3) << 1, 9);
+    const bool c12 = bit(12, 12);
+    switch (bit(15, 13) << 2 | bit(1, 0)) {
+      case 0b000'00: return imm4spn ? I(imm4spn, 2, 0, rdp, 0x13) : 0;      // c.addi4spn
+      case 0b010'00: return I(immlw, rs1p, 2, rdp, 0x03);                   // c.lw
+      case 0b011'00: return I(immlw, rs1p, 2, rdp, 0x07);                   // c.flw
+      case 0b110'00: return S(immlw, rdp, rs1p, 2, 0x23);                   // c.sw
+      case 0b111'00: return S(immlw, rdp, rs1p, 2, 0x27);                   // c.fsw
+      case 0b000'01: return I(immci, rd, 0, rd, 0x13);                      // c.addi
+      case 0b001'01: return J(immj, 1);                                     // c.jal
+      case 0b010'01: return I(immci, 0, 0, rd, 0x13);                       // c.li
+      case 0b011'01:
+        if (rd == 2) return imm16sp ? I(imm16sp, 2, 0, 2, 0x13) : 0;        // c.addi16sp
+        return immci ? (immci << 12 | rd << 7 | 0x37) : 0;                  // c.lui
+      case 0b100'01:
+        switch (bit(11, 10)) {
+          case 0: return c12 ? 0 : I(rs2, rs1p, 5, rs1p, 0x13);             // c.srli
+          case 1: return c12 ? 0 : I(0x400 | rs2, rs1p, 5, rs1p, 0x13);     // c.srai
+          case 2: return I(immci, rs1p, 7, rs1p, 0x13);                     // c.andi
+          default: {
+            if (c12) return 0;
+            static const uint32_t f3[4] = {0, 4, 6, 7};                     // c.sub, c.xor, c.or, c.and
+            return R(bit(6, 5) == 0 ? 0x20 : 0, rdp, rs1p, f3[bit(6, 5)], rs1p);
+          }
+        }
+      case 0b101'01: return J(immj, 0);                                     // c.j
+      case 0b110'01: return B(immb, rs1p, 0);                               // c.beqz
+      case 0b111'01: return B(immb, rs1p, 1);                               // c.bnez
+      case 0b000'10: return c12 ? 0 : I(rs2, rd, 1, rd, 0x13);              // c.slli
+      case 0b010'10: return rd ? I(immlwsp, 2, 2, rd, 0x03) : 0;            // c.lwsp
+      case 0b011'10: return I(immlwsp, 2, 2, rd, 0x07);                     // c.flwsp
+      case 0b100'10:
+        if (!c12) {
+          if (rs2) return R(0, rs2, 0, 0, rd);                              // c.mv
+          return rd ? I(0, rd, 0, 0, 0x67) : 0;                             // c.jr
+        }
+        if (rs2) return R(0, rs2, rd, 0, rd);                               // c.add
+        return rd ? I(0, rd, 0, 1, 0x67) : 0x00100073;                      // c.jalr, c.ebreak
+      case 0b110'10: return S(immswsp, rs2, 2, 2, 0x23);                    // c.swsp
+      case 0b111'10: return S(immswsp, rs2, 2, 2, 0x27);                    // c.fswsp
+      default: return 0;
+    }
+  }
+
+  // counter configuration, for the fast-forward hand-off to the RTL
+  uint32_t mcountinhibit() const { return mcountinhibit_; }
+  uint32_t mhpmevent(unsigned n) const { return mhpmevent_[n & 31]; }
+
+  // the RTL value of a counter read replaces the ISS one
+  void sync_counter_read(const Retire& r, uint32_t rtl_wd) {
+    if (r.we && r.counter_read) x[r.rd] = rtl_wd;
+  }
+
+ private:
+  std::vector<uint32_t> imem_;
+  std::vector<uint8_t> mem_;
+  uint32_t mask_;
+  uint32_t mhpmevent_[32] = {};
+  uint32_t mcountinhibit_ = 0;
+
+  uint32_t read(uint32_t ad, unsigned size) const {
+    if (mmio(ad)) return 0;
+    uint32_t v = 0;
+    for (unsigned i = 0; i < size; i++) v |= (uint32_t)mem_[(ad + i) & mask_] << (8 * i);
+    return v;
+  }
+
+  void write(uint32_t ad, uint32_t v, unsigned size) {
+    for (unsigned i = 0; i < size; i++) mem_[(ad + i) & mask_] = (uint8_t)(v >> (8 * i));
+  }
+
+  void do_store(Retire& r, uint32_t ad, uint32_t v, unsigned size) {
+    r.mwe = true;
+    r.msize = size;
+    r.madr = ad;
+    r.mwd = v;
+    if (!mmio(ad)) write(ad, v, size);
+  }
+
+  static uint32_t alu(uint32_t f3, uint32_t a, uint32_t b, bool sub, bool sra) {
+    switch (f3) {
+      case 0: return sub ? a - b : a + b;
+      case 1: return a << (b & 31);
+      case 2: return (int32_t)a < (int32_t)b;
+      case 3: return a < b;
+      case 4: return a ^ b;
+      case 5: return sra ? (uint32_t)((int32_t)a >> (b & 31)) : a >> (b & 31);
+      case 6: return a | b;
+      default: return a & b;
+    }
+  }
+
+  static uint32_t muldiv(uint32_t f3, uint32_t a, uint32_t b) {
+    const int64_t sa = (int32_t)a, sb = (int32_t)b;
+    switch (f3) {
+      case 0: return a * b;
+      case 1: return (uint32_t)((sa * sb) >> 32);
+      case 2: return (uint32_t)((sa * (int64_t)(uint64_t)b) >> 32);
+      case 3: return (uint32_t)(((uint64_t)a * b) >> 32);
+      case 4:
+        if (b == 0) return 0xffffffffu;
+        if (a == 0x80000000u && b == 0xffffffffu) return a;
+        return (uint32_t)((int32_t)a / (int32_t)b);
+      case 5: return b == 0 ? 0xffffffffu : a / b;
+      case 6:
+        if (b == 0) return a;
+        if (a == 0x80000000u && b == 0xffffffffu) return 0;
+        return (uint32_t)((int32_t)a % (int32_t)b);
+      default: return b == 0 ? a : a % b;
+    }
+  }
+
+  static uint32_t unbox(uint32_t v) { return (v >> 16) == 0xffff ? (v & 0xffff) : 0x7e00; }
+
+  template <class SetX, class SetF>
+  void op_fp(Retire& r, uint32_t in, uint32_t rd, uint32_t rs1, uint32_t rs2, SetX setx, SetF setf) {
+    (void)rd;
+    const uint32_t f5 = in >> 27, fmt = (in >> 25) & 3;
+    const bool half = fmt == 2;
+    if (fmt != 0 && fmt != 2) { r.illegal = true; return; }
+    if (f5 <= 3) {                                                // fadd, fsub, fmul, fdiv
+      fpmodel::Result res = half ? fpmodel::Half::eval(unbox(f[rs1]), unbox(f[rs2]), f5)
+                                 : fpmodel::Single::eval(f[rs1], f[rs2], f5);
+      setf(half ? 0xffff0000u | res.y : res.y, f5 == 3);
+      fflags |= res.flags;
+    } else if (f5 == 0x1c && rs2 == 0 && ((in >> 12) & 7) == 0) { // fmv.x.w, fmv.x.h
+      setx(half ? (uint32_t)(int16_t)(f[rs1] & 0xffff) : f[rs1]);
+    } else if (f5 == 0x1e && rs2 == 0 && ((in >> 12) & 7) == 0) { // fmv.w.x, fmv.h.x
+      setf(half ? 0xffff0000u | (x[rs1] & 0xffff) : x[rs1], false);
+    } else {
+      r.illegal = true;
+    }
+  }
+
+  static bool is_counter(uint32_t csr) {
+    const uint32_t base = csr & ~0x1fu;
+    return base == 0xb00 || base == 0xb80 || base == 0xc00 || base == 0xc80;
+  }
+
+  template <class SetX>
+  void op_csr(Retire& r, uint32_t in, uint32_t rd, uint32_t rs1, uint32_t f3, uint32_t a, SetX setx) {
+    (void)rd;
+    const uint32_t csr = in >> 20;
+    // ecall, ebreak (and the rest of funct3 000, and the reserved 100):
+    // there are no traps, so the core retires them as nops (maindec.v)
+    if ((f3 & 3) == 0) return;
+    const uint32_t src = (f3 & 4) ? rs1 : a;
+    uint32_t old = 0;
+    if (csr == 0x001) old = fflags;
+    else if (csr == 0x002) old = frm;
+    else if (csr == 0x003) old = (frm << 5) | fflags;
+    else if (csr == 0x320) old = mcountinhibit_;
+    else if (csr >= 0x323 && csr <= 0x33f) old = mhpmevent_[csr - 0x320];
+    else if (is_counter(csr)) { old = 0; r.counter_read = true; }
+    uint32_t v = old;
+    switch (f3 & 3) {
+      case 1: v = src; break;
+      case 2: v = old | src; break;
+      case 3: v = old & ~src; break;
+    }
+    if (csr == 0x001) fflags = v & 31;
+    else if (csr == 0x002) frm = v & 7;
+    else if (csr == 0x003) { fflags = v & 31; frm = (v >> 5) & 7; }
+    else if (csr == 0x320) mcountinhibit_ = v;
+    else if (csr >= 0x323 && csr <= 0x33f) mhpmevent_[csr - 0x320] = v & 15;
+    setx(old);
+  }
+};
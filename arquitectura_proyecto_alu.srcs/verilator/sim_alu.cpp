@@ -0,0 +1,373 @@
+// sim_alu.cpp - Verilator testbench for the IEEE-754 alu (sources_1/new/alu.v)
+//
+// Replaces the $fscanf flow of sim_1/new/tb_alu_frandom16/32.v: the vector
+// set is sharded across threads, each with its own model, and the
+// combinational alu is evaluated directly (no #10 per vector). Results are
+// graded with the categories of the Verilog testbenches:
+//   exact      y and flags match
+//   near       same sign and exponent, mantissa off in the low 3 (half)
+//              or 6 (single) bits; flags are not compared
+//   relaxed    y matches except for the sign, flags match except for inexact
+//   incorrect  anything else (printed, up to --max-print)
+// Without an expected file the golden values come from the bit-exact C++
+// model (cpp_model/fp_model.hpp), evaluated per vector in the shards. Both
+// files may be text (.mem) or the packed binary format of gen_random/vecbin.py;
+// binary files are read in place from the mapping, not copied.
+//
+// Build (from arquitectura_proyecto_alu.srcs/, Verilator 5), one binary per format:
+//   verilator -f verilator/alu.f --cc --exe --build -j 0 -O3 -Gsystem=16
+//     -CFLAGS -pthread -LDFLAGS -pthread --Mdir obj_alu16 -o sim_alu verilator/sim_alu.cpp
+// (-Gsystem=32 and obj_alu32 for single precision); add --trace-fst (or
+// --trace for VCD) to enable --trace
+//
+// Usage:
+//   obj_alu16/sim_alu [options] tb_vectors_16_N.mem [tb_expected_output16_N.mem]
+//     -j N             threads (default: all cores)
+//     --max-print N    incorrect cases printed (default 20)
+//     --dump FILE      write the alu result of every vector in the expected
+//                      format (binary if FILE ends in .bin), for gen_random/triage.py;
+//                      FILE must be a regular file (each thread writes its
+//                      records in place as it goes)
+//     --trace FILE     dump waves only for a window of vectors around each trigger
+//     --trace-on T     trigger, repeatable: incorrect (default), near (any result
+//                      that is not exact), flags=MASK (the alu raises a flag of
+//                      ALUFlags MASK, e.g. 0x18 = invalid|div0), index=I (case I
+//                      as printed, a user-chosen vector)
+//     --trace-window N vectors dumped before and after each trigger (default 8)
+//     --trace-max N    at most N triggers (default 100)
+//     --trace-scope S  only the signals under S (e.g. alu.U_DIV)
+//     --trace-depth D  hierarchy levels under the scope (default 0 = all)
+// The alu is combinational, so the windows are not recorded during the
+// threaded run: the triggers are collected, and afterwards only the vectors
+// of the merged windows are evaluated again on a traced model. The time in
+// the dump is the vector index, so gaps between windows show as time jumps.
+//
+// Exit code: 0 if no case is incorrect, 1 otherwise, 2 on usage/file errors.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Valu.h"
+#include "verilated.h"
+#if VM_TRACE_FST
+#include "verilated_fst_c.h"
+typedef VerilatedFstC TraceFile;
+#elif VM_TRACE
+#include "verilated_vcd_c.h"
+typedef VerilatedVcdC TraceFile;
+#endif
+
+#include "../cpp_model/fp_model.hpp"
+#include "../cpp_model/vectors.hpp"
+
+using fpmodel::Result;
+using fpmodel::ResultSet;
+using fpmodel::Vector;
+using fpmodel::VectorSet;
+
+// the port width follows -Gsystem: SData for half, IData for single
+static const int WIDTH = 8 * (int)sizeof(Valu::y);
+typedef std::conditional<WIDTH == 16, fpmodel::Half, fpmodel::Single>::type Golden;
+
+enum Grade { EXACT, NEAR, RELAXED, INCORRECT };
+
+struct Mismatch {
+  size_t index;
+  Result exp, got;
+};
+
+// --dump output: records have a fixed size in both formats, so each shard
+// writes its own range in place (pwrite) while it runs, in chunks
+class DumpFile {
+ public:
+  static const size_t CHUNK = 4096;  // records per write
+
+  bool open(const char* path, size_t count) {
+    const size_t len = std::strlen(path);
+    bin_ = len >= 4 && !std::strcmp(path + len - 4, ".bin");
+    fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    struct stat st;
+    if (fd_ < 0 || fstat(fd_, &st) != 0 || !S_ISREG(st.st_mode)) return false;
+    if (!bin_) return ftruncate(fd_, (off_t)(count * record_size())) == 0;
+    fpmodel::BinHeader h = {{'F', 'P', 'V', 'B'}, 1, fpmodel::BIN_EXPECTED, (uint8_t)WIDTH, 0, count};
+    return pwrite(fd_, &h, sizeof h, 0) == (ssize_t)sizeof h &&
+           ftruncate(fd_, (off_t)(sizeof h + count * record_size())) == 0;
+  }
+
+  size_t record_size() const { return bin_ ? WIDTH / 4 : WIDTH + 7; }
+
+  // adds the result of vector i (consecutive within a shard) to buf and
+  // writes buf once it holds CHUNK records or i is the shard's last one
+  bool put(size_t i, const Result& r, size_t hi, std::string& buf) {
+    if (bin_) fpmodel::append_expected_bin(r, WIDTH, buf);
+    else      fpmodel::format_expected(r, WIDTH, buf);
+    if (buf.size() < CHUNK * record_size() && i + 1 < hi) return true;
+    const size_t first = i + 1 - buf.size() / record_size();
+    const off_t at = (off_t)((bin_ ? sizeof(fpmodel::BinHeader) : 0) + first * record_size());
+    const bool ok = pwrite(fd_, buf.data(), buf.size(), at) == (ssize_t)buf.size();
+    buf.clear();
+    return ok;
+  }
+
+  bool close() { return fd_ >= 0 && ::close(fd_) == 0; }
+
+ private:
+  int fd_ = -1;
+  bool bin_ = false;
+};
+
+struct Shard {
+  uint64_t count[4] = {};
+  std::vector<Mismatch> bad;
+  std::vector<size_t> trig;
+  bool dump_ok = true;
+};
+
+// --trace options
+struct Trigger {
+  int grade = INCORRECT + 1;  // trigger on this grade or worse; INCORRECT + 1 = never
+  unsigned flags = 0;
+  std::vector<size_t> index;
+  size_t window = 8, max = 100;
+  int depth = 0;
+  std::string scope;
+};
+
+static Grade grade(const Result& got, const Result& exp) {
+  const uint32_t sign = 1u << (WIDTH - 1);
+  const int low = WIDTH == 16 ? 3 : 6;
+  if (got.y == exp.y && got.flags == exp.flags) return EXACT;
+  if ((got.y >> low) == (exp.y >> low)) return NEAR;
+  if (((got.y ^ exp.y) & ~sign) == 0 && (got.flags >> 1) == (exp.flags >> 1)) return RELAXED;
+  return INCORRECT;
+}
+
+static std::string bin(uint32_t v, int n) {
+  std::string s;
+  for (int i = n - 1; i >= 0; i--) s += (char)('0' + ((v >> i) & 1));
+  return s;
+}
+
+// exp is null when the golden values come from fp_model
+static void run_shard(const VectorSet* vec, const ResultSet* exp, DumpFile* dump, const Trigger* trig,
+                      size_t lo, size_t hi, Shard& sh) {
+  // Verilated models are not shared between threads: one context per shard
+  auto ctx = std::make_unique<VerilatedContext>();
+  auto dut = std::make_unique<Valu>(ctx.get());
+  std::string buf;
+  for (size_t i = lo; i < hi; i++) {
+    const Vector v = (*vec)[i];
+    dut->a = v.a;
+    dut->b = v.b;
+    dut->op = v.op;
+    dut->eval();
+    const Result got{(uint32_t)dut->y, (unsigned)dut->ALUFlags};
+    const Result want = exp ? (*exp)[i] : Golden::eval(v.a, v.b, v.op);
+    if (dump && sh.dump_ok) sh.dump_ok = dump->put(i, got, hi, buf);
+    const Grade g = grade(got, want);
+    sh.count[g]++;
+    if (g == INCORRECT) sh.bad.push_back({i, want, got});
+    if (trig && sh.trig.size() < trig->max && (g >= trig->grade || (got.flags & trig->flags)))
+      sh.trig.push_back(i);
+  }
+  dut->final();
+}
+
+// evaluates the merged windows around the triggers again, with tracing on;
+// returns the number of windows
+static size_t trace_windows(const VectorSet& vec, size_t n, const std::vector<size_t>& at,
+                            const Trigger& t, const char* path) {
+#if VM_TRACE
+  auto ctx = std::make_unique<VerilatedContext>();
+  ctx->traceEverOn(true);
+  auto dut = std::make_unique<Valu>(ctx.get());
+  TraceFile tf;
+  dut->trace(&tf, 99);
+  if (!t.scope.empty()) tf.dumpvars(t.depth, t.scope);
+  tf.open(path);
+  size_t windows = 0, next = 0;  // next: first vector not dumped yet
+  for (size_t k = 0; k < at.size(); k++) {
+    const size_t lo = std::max(next, at[k] >= t.window ? at[k] - t.window : 0);
+    size_t hi = std::min(n, at[k] + t.window + 1);
+    while (k + 1 < at.size() && at[k + 1] <= hi + t.window) hi = std::min(n, at[++k] + t.window + 1);
+    windows++;
+    for (size_t i = lo; i < hi; i++) {
+      const Vector v = vec[i];
+      dut->a = v.a;
+      dut->b = v.b;
+      dut->op = v.op;
+      dut->eval();
+      tf.dump(i);
+    }
+    next = hi;
+  }
+  tf.close();
+  dut->final();
+  return windows;
+#else
+  (void)vec, (void)n, (void)at, (void)t, (void)path;
+  std::fprintf(stderr, "sim_alu: built without --trace, ignoring --trace\n");
+  return 0;
+#endif
+}
+
+int main(int argc, char** argv) {
+  unsigned threads = std::thread::hardware_concurrency();
+  size_t max_print = 20;
+  const char* vec_path = nullptr;
+  const char* exp_path = nullptr;
+  const char* dump_path = nullptr;
+  const char* trace_path = nullptr;
+  Trigger trig;
+  bool trig_set = false;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "-j" && i + 1 < argc)               threads = (unsigned)std::atoi(argv[++i]);
+    else if (a == "--max-print" && i + 1 < argc) max_print = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--dump" && i + 1 < argc)      dump_path = argv[++i];
+    else if (a == "--trace" && i + 1 < argc)     trace_path = argv[++i];
+    else if (a == "--trace-window" && i + 1 < argc) trig.window = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--trace-max" && i + 1 < argc) trig.max = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--trace-scope" && i + 1 < argc) trig.scope = argv[++i];
+    else if (a == "--trace-depth" && i + 1 < argc) trig.depth = std::atoi(argv[++i]);
+    else if (a == "--trace-on" && i + 1 < argc) {
+      const std::string t = argv[++i];
+      trig_set = true;
+      if (t == "incorrect")                 trig.grade = std::min(trig.grade, (int)INCORRECT);
+      else if (t == "near")                 trig.grade = NEAR;
+      else if (t.rfind("flags=", 0) == 0)   trig.flags |= (unsigned)std::strtoul(t.c_str() + 6, nullptr, 0);
+      else if (t.rfind("index=", 0) == 0 && std::strtoull(t.c_str() + 6, nullptr, 0) > 0)
+        trig.index.push_back(std::strtoull(t.c_str() + 6, nullptr, 0) - 1);
+      else {
+        std::fprintf(stderr, "sim_alu: unknown trigger %s\n", t.c_str());
+        return 2;
+      }
+    }
+    else if (a[0] == '+')                        continue; // plusargs for Verilator
+    else if (a[0] != '-' && !vec_path)           vec_path = argv[i];
+    else if (a[0] != '-' && !exp_path)           exp_path = argv[i];
+    else {
+      std::fprintf(stderr, "sim_alu: unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (!vec_path) {
+    std::fprintf(stderr, "usage: sim_alu [-j N] [--max-print N] [--dump FILE] [--trace FILE [--trace-on T]...]"
+                         " vectors.mem [expected.mem]\n");
+    return 2;
+  }
+  if (threads == 0) threads = 1;
+  if (!trig_set) trig.grade = INCORRECT;
+
+  std::string err;
+  int width = 0;
+  VectorSet vec;
+  if (!fpmodel::load_vectors(vec_path, width, vec, err)) {
+    std::fprintf(stderr, "sim_alu: %s\n", err.c_str());
+    return 2;
+  }
+  if (width != WIDTH) {
+    std::fprintf(stderr, "sim_alu: %s has %d-bit vectors, this binary was built with -Gsystem=%d\n",
+                 vec_path, width, WIDTH);
+    return 2;
+  }
+
+  ResultSet exp;
+  if (exp_path) {
+    if (!fpmodel::load_expected(exp_path, width, exp, err)) {
+      std::fprintf(stderr, "sim_alu: %s\n", err.c_str());
+      return 2;
+    }
+    if (exp.size() != vec.size()) {
+      std::fprintf(stderr, "sim_alu: %zu vectors but %zu expected results\n", vec.size(), exp.size());
+      return 2;
+    }
+  }
+
+  const size_t n = vec.size();
+  DumpFile dump;
+  if (dump_path && !dump.open(dump_path, n)) {
+    std::fprintf(stderr, "sim_alu: cannot write %s (--dump needs a regular file)\n", dump_path);
+    return 2;
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+  const size_t per = (n + threads - 1) / threads;
+  std::vector<Shard> shards(threads);
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; t++) {
+    const size_t lo = std::min(n, t * per), hi = std::min(n, lo + per);
+    pool.emplace_back(run_shard, &vec, exp_path ? &exp : nullptr, dump_path ? &dump : nullptr,
+                      trace_path ? &trig : nullptr, lo, hi, std::ref(shards[t]));
+  }
+  for (std::thread& th : pool) th.join();
+  const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  if (trace_path) {
+    // shards cover increasing index ranges: the triggers come out sorted
+    std::vector<size_t> at;
+    for (const Shard& sh : shards) at.insert(at.end(), sh.trig.begin(), sh.trig.end());
+    for (size_t i : trig.index)
+      if (i < n) at.push_back(i);
+    std::sort(at.begin(), at.end());
+    at.erase(std::unique(at.begin(), at.end()), at.end());
+    if (at.size() > trig.max) at.resize(trig.max);
+    const size_t windows = trace_windows(vec, n, at, trig, trace_path);
+    if (windows) std::fprintf(stderr, "%zu triggers, %zu windows of waves in %s\n", at.size(), windows, trace_path);
+  }
+
+  if (dump_path) {
+    bool ok = dump.close();
+    for (const Shard& sh : shards) ok = ok && sh.dump_ok;
+    if (!ok) {
+      std::fprintf(stderr, "sim_alu: cannot write %s\n", dump_path);
+      return 2;
+    }
+  }
+
+  // shards cover increasing index ranges, so the mismatches come out in order
+  uint64_t count[4] = {};
+  size_t printed = 0;
+  for (const Shard& sh : shards) {
+    for (int g = 0; g < 4; g++) count[g] += sh.count[g];
+    for (const Mismatch& m : sh.bad) {
+      if (printed++ >= max_print) continue;
+      const Vector v = vec[m.index];
+      std::printf("Mismatch en caso %zu: a=%s b=%s op=%s\n", m.index + 1, bin(v.a, WIDTH).c_str(),
+                  bin(v.b, WIDTH).c_str(), bin(v.op, 2).c_str());
+      std::printf("   Esperado: y=%s, flags=%s\n", bin(m.exp.y, WIDTH).c_str(),
+                  bin(m.exp.flags, 5).c_str());
+      std::printf("   Obtenido: y=%s, flags=%s\n", bin(m.got.y, WIDTH).c_str(),
+                  bin(m.got.flags, 5).c_str());
+    }
+  }
+  if (printed > max_print) std::printf("... %zu casos incorrectos mas\n", printed - max_print);
+
+  const double total = (double)n;
+  std::printf("\nRESULTADOS TOTALES (%d bits, golden: %s)\n", WIDTH, exp_path ? exp_path : "fp_model.hpp");
+  std::printf("Casos totales: %zu\n", n);
+  std::printf(" Correctos:       %llu\n", (unsigned long long)count[EXACT]);
+  std::printf(" Casi correctos:  %llu\n", (unsigned long long)count[NEAR]);
+  std::printf(" Relajados:       %llu\n", (unsigned long long)count[RELAXED]);
+  std::printf(" Incorrectos:     %llu\n", (unsigned long long)count[INCORRECT]);
+  std::printf(" Precision exacta:         %.2f %%\n", count[EXACT] * 100.0 / total);
+  std::printf(" Precision con tolerancia: %.2f %%\n", (count[EXACT] + count[NEAR]) * 100.0 / total);
+  std::printf(" Precision relajada:       %.2f %%\n", (count[EXACT] + count[RELAXED]) * 100.0 / total);
+  std::printf(" Precision de Ambos:       %.2f %%\n",
+              (count[EXACT] + count[NEAR] + count[RELAXED]) * 100.0 / total);
+  std::fprintf(stderr, "%zu vectors, %u threads, %.3f s (%.2f M vectors/s)\n", n, threads, secs,
+               secs > 0 ? total / secs / 1e6 : 0.0);
+  return count[INCORRECT] ? 1 : 0;
+}
@@ -0,0 +1,439 @@
+// sim_alu_cov.cpp - coverage-directed stimulus for the internal paths of the alu
+//
+// gec_vector.py draws operands with fixed percentages, which rarely reach the
+// hard corners of the datapath. This harness defines functional coverage bins
+// on internal RTL conditions, reads them from the Verilated alu through VPI
+// after every vector, and biases the stimulus toward the bins still unhit.
+//
+// Bins, per op (sampled only on the normal path, i.e. when !is_special):
+//   add, sub  effective add  SumMantisa carry x rounding class, rounding carry
+//             effective sub  exact zero, RestaMantisa normalization shift
+//                            (none, 1, 2-3, 4-K, >K = large cancellation,
+//                            K = mantissa bits / 2), rounding class,
+//                            rounding carry (*)
+//   mul       Prod Debe x rounding class, rounding carry, ShiftCondition (*)
+//   div       Division ShiftCondition x rounding class, exact quotient,
+//             rounding carry (*), Debe (*)
+// The rounding class comes from the guard/rest bits of the RoundNearestEven
+// instance of the path: exact, below half, tie kept (even), tie rounded up
+// (odd), above half. The rounding carry is the mantissa overflow of the
+// rounder (exponent + 1).
+// (*) unreachable, reported but not counted towards closure:
+//   - the units always set the hidden bit, so the mantissa product is in
+//     [1, 4) and the quotient in (1/2, 2): no Prod shift, no Division Debe;
+//   - a quotient of two (FRAC+1)-bit mantissas is never within half an ulp
+//     of 1 or 2 without being exact, so Division never carries when rounding;
+//   - RestaMantisa rounds only the bits its normalization shift pushes out
+//     of the top of the difference (a leading 0..01, or its complement), so
+//     guard set with rest clear never happens and neither does a carry.
+//     eff_sub therefore only sees exact, below and above.
+//
+// Generator: each vector picks an op (weighted by its unhit bins) and one of
+// the operand strategies below; a strategy's weight for that op grows with
+// the new bins it hits and decays while it hits none (a simple bandit).
+//   gec      the gec_vector.py mix (cpp_model/stimulus.hpp)
+//   uniform  normal numbers around 1.0
+//   near     b close to a (same or adjacent exponent, small mantissa delta)
+//   sparse   mantissas with many trailing zeros
+//   tie      operands built so the bits lost in alignment/product are 10..0
+//   ones     rounding carry: all-ones mantissas (add/sub with a b of the same
+//            or a much smaller exponent), a product close to 2 (mul)
+// Every vector is also checked against cpp_model/fp_model.hpp.
+//
+// Build (from arquitectura_proyecto_alu.srcs/, Verilator 5), one binary per format:
+//   verilator -f verilator/alu.f --cc --exe --build -j 0 -O3 -Gsystem=16 --vpi --public-flat-rw
+//     --Mdir obj_cov16 -o sim_alu_cov verilator/sim_alu_cov.cpp
+// (-Gsystem=32 and obj_cov32 for single precision)
+//
+// Usage:
+//   obj_cov16/sim_alu_cov [options]
+//     --max N        vector budget (default 20000)
+//     --seed S       generator seed (default 1)
+//     --baseline     gec_vector.py mix with uniform ops and no feedback, for comparison
+//     --save FILE    write the vectors that hit a new bin, as a tb_vectors .mem
+//
+// Exit code: 0 if every reachable bin was hit and no vector mismatched the
+// model, 1 otherwise, 2 on usage errors or missing signals.
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Valu.h"
+#include "verilated.h"
+#include "verilated_vpi.h"
+
+#include "../cpp_model/fp_model.hpp"
+#include "../cpp_model/stimulus.hpp"
+
+static const int WIDTH = 8 * (int)sizeof(Valu::y);
+static const int FRAC = WIDTH == 16 ? 10 : 23;
+static const int EXPB = WIDTH - 1 - FRAC;
+static const uint32_t EMAX = (1u << EXPB) - 1;
+static const uint32_t BIAS = EMAX / 2;
+static const int K = FRAC / 2;
+static const char* OP_NAME[4] = {"add", "sub", "mul", "div"};
+
+// ---------------------------------------------------------------------------
+// Internal signals
+// ---------------------------------------------------------------------------
+static vpiHandle signal(const std::string& path) {
+  // the top scope is "alu" or "TOP.alu" depending on the Verilator version
+  for (const char* top : {"alu.", "TOP.alu."}) {
+    std::string name = top + path;
+    if (vpiHandle h = vpi_handle_by_name((PLI_BYTE8*)name.c_str(), nullptr)) return h;
+  }
+  std::fprintf(stderr, "sim_alu_cov: signal alu.%s not found (build with --vpi --public-flat-rw)\n",
+               path.c_str());
+  std::exit(2);
+}
+
+static uint32_t value(vpiHandle h) {
+  s_vpi_value v;
+  v.format = vpiIntVal;
+  vpi_get_value(h, &v);
+  return (uint32_t)v.value.integer;
+}
+
+enum RoundClass { EXACT, BELOW, TIE_EVEN, TIE_ODD, ABOVE };
+static const char* ROUND_NAME[5] = {"exact", "below", "tie_even", "tie_odd", "above"};
+
+// one RoundNearestEven instance
+struct Rounder {
+  vpiHandle guard, rest, even, temp;
+
+  explicit Rounder(const std::string& p)
+      : guard(signal(p + ".guard")), rest(signal(p + ".boolean")), even(signal(p + ".is_even")),
+        temp(signal(p + ".temp")) {}
+  int cls() const {
+    if (!value(guard)) return value(rest) ? BELOW : EXACT;
+    if (value(rest)) return ABOVE;
+    return value(even) ? TIE_EVEN : TIE_ODD;
+  }
+  bool carry() const { return (value(temp) >> FRAC) & 1; }  // temp[MBS+1]
+};
+
+// Suma16Bits instance (U_ADD or U_SUB)
+struct Adder {
+  vpiHandle dif_sign, zero, sum_carry, sub_shift_on, sub_shift;
+  Rounder sum_rne, sub_rne;
+
+  explicit Adder(const std::string& p)
+      : dif_sign(signal(p + ".boolean2")), zero(signal(p + ".is_zero_result")),
+        sum_carry(signal(p + ".sm.carry")), sub_shift_on(signal(p + ".rm.cond_F_shift")),
+        sub_shift(signal(p + ".rm.idx_to_use")), sum_rne(p + ".sm.rne_sum"),
+        sub_rne(p + ".rm.rounder") {}
+};
+
+// ---------------------------------------------------------------------------
+// Coverage bins
+// ---------------------------------------------------------------------------
+struct Bin {
+  std::string name;
+  bool reachable = true;
+  uint64_t hits = 0;
+  int64_t first = -1;  // index of the first vector that hit it
+};
+
+struct Coverage {
+  std::vector<Bin> bins[4];
+  int64_t closed_at[4] = {-1, -1, -1, -1};
+
+  Coverage() {
+    for (int op = 0; op < 2; op++) {
+      for (int c = 0; c < 2; c++)
+        for (int r = 0; r < 5; r++) add(op, std::string("eff_add.carry") + (char)('0' + c) + "." + ROUND_NAME[r]);
+      add(op, "eff_add.round_carry");
+      add(op, "eff_sub.zero");
+      for (const std::string& s : {std::string("none"), std::string("1"), std::string("2-3"), "4-" + std::to_string(K), ">" + std::to_string(K)})
+        add(op, "eff_sub.shift_" + s);
+      for (int r = 0; r < 5; r++)
+        add(op, std::string("eff_sub.") + ROUND_NAME[r], r != TIE_EVEN && r != TIE_ODD);
+      add(op, "eff_sub.round_carry", false);
+    }
+    for (int c = 0; c < 2; c++)
+      for (int r = 0; r < 5; r++) add(2, std::string("debe") + (char)('0' + c) + "." + ROUND_NAME[r]);
+    add(2, "round_carry");
+    add(2, "shift_condition", false);
+    for (int c = 0; c < 2; c++)
+      for (int r = 0; r < 5; r++) add(3, std::string("shift_condition") + (char)('0' + c) + "." + ROUND_NAME[r]);
+    add(3, "exact_quotient");
+    add(3, "round_carry", false);
+    add(3, "debe", false);
+  }
+
+  void add(int op, const std::string& name, bool reachable = true) {
+    Bin b;
+    b.name = name;
+    b.reachable = reachable;
+    bins[op].push_back(b);
+  }
+
+  int unhit(int op) const {
+    int n = 0;
+    for (const Bin& b : bins[op]) n += b.reachable && !b.hits;
+    return n;
+  }
+
+  // returns the number of bins hit for the first time
+  int hit(int op, const std::vector<int>& ids, int64_t index) {
+    int fresh = 0;
+    for (int id : ids) {
+      Bin& b = bins[op][id];
+      if (!b.hits++) {
+        b.first = index;
+        fresh++;
+      }
+    }
+    if (fresh && closed_at[op] < 0 && !unhit(op)) closed_at[op] = index;
+    return fresh;
+  }
+};
+
+// bin ids hit by the current vector; same layout as the Coverage constructor
+struct Probes {
+  vpiHandle is_special;
+  Adder add, sub;
+  vpiHandle mul_debe, mul_shift;
+  Rounder mul_rne;
+  vpiHandle div_debe, div_shift, div_rem;
+  Rounder div_rne;
+
+  Probes()
+      : is_special(signal("is_special")), add("U_ADD"), sub("U_SUB"),
+        mul_debe(signal("U_MUL.product_mantisa.Debe")),
+        mul_shift(signal("U_MUL.product_mantisa.ShiftCondition")),
+        mul_rne("U_MUL.product_mantisa.rne_mul"), div_debe(signal("U_DIV.div.Debe")),
+        div_shift(signal("U_DIV.div.ShiftCondition")), div_rem(signal("U_DIV.div.rem_nz")),
+        div_rne("U_DIV.div.rounder") {}
+
+  std::vector<int> sample(unsigned op) const {
+    std::vector<int> ids;
+    if (value(is_special)) return ids;
+    if (op < 2) {
+      const Adder& u = op == 0 ? add : sub;
+      if (!value(u.dif_sign)) {
+        ids.push_back((int)value(u.sum_carry) * 5 + u.sum_rne.cls());
+        if (u.sum_rne.carry()) ids.push_back(10);
+      } else if (value(u.zero)) {
+        ids.push_back(11);
+      } else {
+        const uint32_t s = value(u.sub_shift_on) ? value(u.sub_shift) : 0;
+        ids.push_back(12 + (s == 0 ? 0 : s == 1 ? 1 : s <= 3 ? 2 : s <= (uint32_t)K ? 3 : 4));
+        ids.push_back(17 + u.sub_rne.cls());
+        if (u.sub_rne.carry()) ids.push_back(22);
+      }
+    } else if (op == 2) {
+      ids.push_back((int)value(mul_debe) * 5 + mul_rne.cls());
+      if (mul_rne.carry()) ids.push_back(10);
+      if (value(mul_shift)) ids.push_back(11);
+    } else {
+      ids.push_back((int)value(div_shift) * 5 + div_rne.cls());
+      if (!value(div_rem)) ids.push_back(10);
+      if (div_rne.carry()) ids.push_back(11);
+      if (value(div_debe)) ids.push_back(12);
+    }
+    return ids;
+  }
+};
+
+// ---------------------------------------------------------------------------
+// Operand strategies
+// ---------------------------------------------------------------------------
+enum Strategy { GEC, UNIFORM, NEAR, SPARSE, TIE, ONES, NSTRAT };
+static const char* STRAT_NAME[NSTRAT] = {"gec", "uniform", "near", "sparse", "tie", "ones"};
+
+struct Generator {
+  std::mt19937_64 rng;
+  fpmodel::Stimulus gec;
+
+  explicit Generator(uint64_t seed) : rng(seed), gec(seed) {}
+
+  uint32_t bits(int n) { return n <= 0 ? 0 : (uint32_t)(rng() & ((1ull << n) - 1)); }
+  uint32_t range(uint32_t lo, uint32_t hi) { return lo + (uint32_t)(rng() % (hi - lo + 1)); }
+  static uint32_t pack(uint32_t s, uint32_t e, uint32_t m) {
+    return s << (WIDTH - 1) | e << FRAC | (m & ((1u << FRAC) - 1));
+  }
+  static uint32_t expo(uint32_t v) { return (v >> FRAC) & EMAX; }
+  static uint32_t mant(uint32_t v) { return v & ((1u << FRAC) - 1); }
+
+  uint32_t normal() { return pack(bits(1), range(BIAS - 6, BIAS + 6), bits(FRAC)); }
+
+  fpmodel::Vector make(Strategy s, unsigned op, uint64_t index) {
+    if (s == GEC) {
+      fpmodel::Vector v = gec.at(index, WIDTH);
+      v.op = op;
+      return v;
+    }
+    uint32_t a = normal(), b = normal();
+    switch (s) {
+      case NEAR: {
+        const uint32_t e = std::min(std::max(expo(a) + range(0, 2), 2u) - 1, EMAX - 1);
+        uint32_t delta = bits((int)range(0, FRAC));
+        const uint32_t m = bits(1) ? mant(a) + delta : mant(a) - delta;
+        b = pack(bits(1), e, m);
+        break;
+      }
+      case SPARSE: {
+        const int ta = (int)range(FRAC / 2, FRAC), tb = (int)range(FRAC / 2, FRAC);
+        a = pack(a >> (WIDTH - 1), expo(a), mant(a) >> ta << ta);
+        b = pack(b >> (WIDTH - 1), expo(b), mant(b) >> tb << tb);
+        break;
+      }
+      case TIE:
+        if (op < 2) {
+          // b aligned d places right: its d low bits are shifted out as 10..0
+          const uint32_t d = range(1, 6);
+          const uint32_t m = (mant(b) >> d << d) | (1u << (d - 1));
+          b = pack(bits(1), expo(a) - d, m);
+        } else {
+          const int t = (int)range(FRAC - 4, FRAC);
+          static const uint32_t mb[4] = {0, 1u << (FRAC - 1), 1u << (FRAC - 2), 3u << (FRAC - 2)};
+          a = pack(a >> (WIDTH - 1), expo(a), mant(a) >> t << t);
+          b = pack(b >> (WIDTH - 1), expo(b), mb[rng() & 3]);
+        }
+        break;
+      case ONES:
+        a = pack(a >> (WIDTH - 1), expo(a), ~bits((int)range(0, 4)));
+        if (op == 2) {
+          // 1.mb ~= 2 / 1.ma, so the product lands just below 2
+          const uint64_t ma = (1ull << FRAC) | mant(a);
+          const uint64_t mb = std::min((1ull << (2 * FRAC + 1)) / ma + range(0, 2) - 1,
+                                       (2ull << FRAC) - 1);
+          b = pack(b >> (WIDTH - 1), expo(b), (uint32_t)mb);
+        } else if (op < 2 && bits(1)) {
+          const uint32_t d = range(FRAC / 2, FRAC + 2);
+          b = pack(b >> (WIDTH - 1), expo(a) > d ? expo(a) - d : 1, bits(FRAC));
+        } else if (bits(1)) {
+          b = pack(b >> (WIDTH - 1), expo(b), ~bits((int)range(0, 4)));
+        }
+        break;
+      default:
+        break;
+    }
+    return {a, b, op};
+  }
+};
+
+// ---------------------------------------------------------------------------
+
+static std::string bin(uint32_t v, int n) {
+  std::string s;
+  for (int i = n - 1; i >= 0; i--) s += (char)('0' + ((v >> i) & 1));
+  return s;
+}
+
+template <class T>
+static int pick(std::mt19937_64& rng, const T* w, int n) {
+  double total = 0;
+  for (int i = 0; i < n; i++) total += w[i];
+  double r = std::uniform_real_distribution<double>(0, total)(rng);
+  for (int i = 0; i < n; i++)
+    if ((r -= w[i]) < 0) return i;
+  return n - 1;
+}
+
+int main(int argc, char** argv) {
+  uint64_t max = 20000, seed = 1;
+  bool baseline = false;
+  const char* save_path = nullptr;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--max" && i + 1 < argc)       max = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--seed" && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--save" && i + 1 < argc) save_path = argv[++i];
+    else if (a == "--baseline")             baseline = true;
+    else if (a[0] == '+')                   continue; // plusargs for Verilator
+    else {
+      std::fprintf(stderr, "usage: sim_alu_cov [--max N] [--seed S] [--baseline] [--save FILE]\n");
+      return 2;
+    }
+  }
+
+  auto ctx = std::make_unique<VerilatedContext>();
+  auto dut = std::make_unique<Valu>(ctx.get());
+  const Probes probes;
+  Coverage cov;
+  Generator gen(seed);
+  FILE* save = save_path ? std::fopen(save_path, "w") : nullptr;
+  if (save_path && !save) {
+    std::fprintf(stderr, "sim_alu_cov: cannot write %s\n", save_path);
+    return 2;
+  }
+
+  double weight[4][NSTRAT];
+  uint64_t used[4][NSTRAT] = {}, fresh_by[4][NSTRAT] = {};
+  for (auto& w : weight) std::fill(w, w + NSTRAT, 1.0);
+  uint64_t n = 0, special = 0, mismatches = 0;
+
+  for (; n < max; n++) {
+    unsigned op;
+    Strategy s = GEC;
+    if (baseline) {
+      op = gen.gec.at(n, WIDTH).op;
+    } else {
+      double unhit[4];
+      for (int o = 0; o < 4; o++) unhit[o] = cov.unhit(o);
+      if (unhit[0] + unhit[1] + unhit[2] + unhit[3] == 0) break;
+      op = (unsigned)pick(gen.rng, unhit, 4);
+      s = (Strategy)pick(gen.rng, weight[op], NSTRAT);
+    }
+    const fpmodel::Vector v = gen.make(s, op, n);
+
+    dut->a = v.a;
+    dut->b = v.b;
+    dut->op = v.op;
+    dut->eval();
+    const fpmodel::Result m = WIDTH == 16 ? fpmodel::Half::eval(v.a, v.b, v.op)
+                                          : fpmodel::Single::eval(v.a, v.b, v.op);
+    mismatches += (uint32_t)dut->y != m.y || (unsigned)dut->ALUFlags != m.flags;
+
+    const std::vector<int> ids = probes.sample(op);
+    special += ids.empty();
+    const int fresh = cov.hit((int)op, ids, (int64_t)n);
+    used[op][s]++;
+    fresh_by[op][s] += fresh;
+    weight[op][s] = fresh ? weight[op][s] + fresh : std::max(0.05, weight[op][s] * 0.98);
+    if (fresh && save) std::fprintf(save, "%s %s %s\n", bin(v.a, WIDTH).c_str(), bin(v.b, WIDTH).c_str(), bin(v.op, 2).c_str());
+  }
+  dut->final();
+  if (save) std::fclose(save);
+
+  std::printf("alu internal coverage, %d bits, %s, seed %llu: %llu vectors (%llu special-case)\n",
+              WIDTH, baseline ? "baseline gec mix" : "coverage-directed", (unsigned long long)seed,
+              (unsigned long long)n, (unsigned long long)special);
+  std::printf("  op   bins    hit     closure at\n");
+  bool closed = true;
+  for (int op = 0; op < 4; op++) {
+    int total = 0, hit = 0;
+    for (const Bin& b : cov.bins[op])
+      if (b.reachable) {
+        total++;
+        hit += b.hits != 0;
+      }
+    closed = closed && hit == total;
+    char at[32] = "-";
+    if (cov.closed_at[op] >= 0) std::snprintf(at, sizeof at, "vector %lld", (long long)cov.closed_at[op]);
+    std::printf("  %-4s %-7d %-7d %s\n", OP_NAME[op], total, hit, at);
+  }
+  for (int op = 0; op < 4; op++)
+    for (const Bin& b : cov.bins[op])
+      if (b.reachable ? !b.hits : b.hits != 0)
+        std::printf("  %s %s.%s\n", b.reachable ? "unhit:" : "unexpected hit:", OP_NAME[op], b.name.c_str());
+  if (!baseline) {
+    std::printf("  vectors / new bins per strategy:\n");
+    for (int op = 0; op < 4; op++) {
+      std::printf("    %-4s", OP_NAME[op]);
+      for (int s = 0; s < NSTRAT; s++)
+        std::printf(" %s %llu/%llu", STRAT_NAME[s], (unsigned long long)used[op][s],
+                    (unsigned long long)fresh_by[op][s]);
+      std::printf("\n");
+    }
+  }
+  std::printf("  mismatches against fp_model: %llu\n", (unsigned long long)mismatches);
+  return closed && !mismatches ? 0 : 1;
+}
@@ -0,0 +1,261 @@
+// sim_alu_sweep.cpp - exhaustive fp16 check of the alu against fp_model.hpp
+//
+// Every (a, b) pair of every op of alu #(.system(16)) - 4 x 2^32 cases - is
+// run on the Verilated alu and compared with the bit-exact C++ model
+// (cpp_model/fp_model.hpp). The sweep is split into units of 256 values
+// of a x all 65536 values of b for one op (1024 units). Each thread owns
+// a deque of units and steals from the others when it runs dry, so slow
+// units (the divider) do not leave cores idle at the end.
+//
+// Progress is logged to the checkpoint file, one line per finished unit;
+// rerunning with the same file skips the units already in it (a torn last
+// line from a killed run is ignored), so the sweep can be stopped and resumed.
+//   unit <id> <mismatches> <y mismatches> <flag 4..0 mismatches> [<a> <b> <rtl y/flags> <model y/flags>]
+// The optional fields are the first mismatch of the unit.
+//
+// Build (from arquitectura_proyecto_alu.srcs/, Verilator 5):
+//   verilator -f verilator/alu.f --cc --exe --build -j 0 -O3 -Gsystem=16
+//     -CFLAGS -pthread -LDFLAGS -pthread --Mdir obj_sweep -o sim_alu_sweep verilator/sim_alu_sweep.cpp
+//
+// Usage:
+//   obj_sweep/sim_alu_sweep [options]
+//     -j N               threads (default: all cores)
+//     --checkpoint FILE  progress log to resume from (default sweep16.ckpt)
+//     --ops LIST         ops to sweep, e.g. 0,1 (default 0,1,2,3 = add,sub,mul,div)
+//     --units N          stop after N new units (smoke tests)
+//
+// Exit code: 0 if the swept units have no mismatch, 1 otherwise, 2 on usage errors.
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Valu.h"
+#include "verilated.h"
+
+#include "../cpp_model/fp_model.hpp"
+
+static_assert(sizeof(Valu::y) == 2, "build with -Gsystem=16");
+
+static const unsigned A_PER_UNIT = 256;
+static const unsigned UNITS_PER_OP = 65536 / A_PER_UNIT;
+static const unsigned UNITS = 4 * UNITS_PER_OP;
+static const uint64_t CASES_PER_UNIT = (uint64_t)A_PER_UNIT * 65536;
+static const char* OP_NAME[4] = {"add", "sub", "mul", "div"};
+
+struct Counts {
+  uint64_t cases = 0, bad = 0, y = 0, flag[5] = {};
+
+  void add(const Counts& c) {
+    cases += c.cases;
+    bad += c.bad;
+    y += c.y;
+    for (int f = 0; f < 5; f++) flag[f] += c.flag[f];
+  }
+};
+
+struct UnitResult {
+  Counts c;
+  bool has_first = false;
+  uint32_t a = 0, b = 0, got = 0, exp = 0; // got/exp = y << 5 | flags
+};
+
+// per-thread deque of unit ids; the owner pops from the front, thieves from the back
+struct WorkQueue {
+  std::mutex m;
+  std::deque<unsigned> units;
+
+  bool pop(unsigned& u, bool steal) {
+    std::lock_guard<std::mutex> lk(m);
+    if (units.empty()) return false;
+    if (steal) { u = units.back();  units.pop_back(); }
+    else       { u = units.front(); units.pop_front(); }
+    return true;
+  }
+};
+
+static UnitResult run_unit(Valu& dut, unsigned unit) {
+  const unsigned op = unit / UNITS_PER_OP;
+  const uint32_t a0 = (unit % UNITS_PER_OP) * A_PER_UNIT;
+  UnitResult r;
+  dut.op = op;
+  for (uint32_t a = a0; a < a0 + A_PER_UNIT; a++) {
+    dut.a = a;
+    for (uint32_t b = 0; b < 65536; b++) {
+      dut.b = b;
+      dut.eval();
+      const fpmodel::Result m = fpmodel::Half::eval(a, b, op);
+      const uint32_t dy = (uint32_t)dut.y ^ m.y;
+      const uint32_t df = (uint32_t)dut.ALUFlags ^ m.flags;
+      if (dy | df) {
+        if (!r.has_first) {
+          r.has_first = true;
+          r.a = a;
+          r.b = b;
+          r.got = (uint32_t)dut.y << 5 | dut.ALUFlags;
+          r.exp = m.y << 5 | m.flags;
+        }
+        r.c.bad++;
+        r.c.y += dy != 0;
+        for (int f = 0; f < 5; f++) r.c.flag[f] += (df >> f) & 1;
+      }
+    }
+  }
+  r.c.cases = CASES_PER_UNIT;
+  return r;
+}
+
+static std::string format_first(const UnitResult& r) {
+  char buf[64];
+  std::snprintf(buf, sizeof buf, " %04x %04x %06x %06x", r.a, r.b, r.got, r.exp);
+  return buf;
+}
+
+static std::string format_unit(unsigned unit, const UnitResult& r) {
+  char line[256];
+  int n = std::snprintf(line, sizeof line, "unit %u %" PRIu64 " %" PRIu64, unit, r.c.bad, r.c.y);
+  for (int f = 4; f >= 0; f--) n += std::snprintf(line + n, sizeof line - n, " %" PRIu64, r.c.flag[f]);
+  return line + (r.has_first ? format_first(r) : std::string()) + "\n";
+}
+
+// loads the finished units of a previous run; only complete lines count,
+// returns the length of the file up to its last complete line
+static size_t load_checkpoint(const char* path, std::vector<bool>& done, Counts op_counts[4],
+                              std::vector<std::string>& firsts) {
+  std::ifstream in(path, std::ios::binary);
+  std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  size_t pos = 0;
+  for (size_t eol; (eol = text.find('\n', pos)) != std::string::npos; pos = eol + 1) {
+    std::istringstream ls(text.substr(pos, eol - pos));
+    std::string tag, first;
+    unsigned unit;
+    Counts c;
+    if (!(ls >> tag >> unit >> c.bad >> c.y) || tag != "unit" || unit >= UNITS || done[unit]) continue;
+    bool ok = true;
+    for (int f = 4; f >= 0; f--) ok = ok && (ls >> c.flag[f]);
+    if (!ok) continue;
+    std::getline(ls, first);
+    c.cases = CASES_PER_UNIT;
+    done[unit] = true;
+    op_counts[unit / UNITS_PER_OP].add(c);
+    if (!first.empty()) firsts.push_back(OP_NAME[unit / UNITS_PER_OP] + first);
+  }
+  return pos;
+}
+
+int main(int argc, char** argv) {
+  unsigned threads = std::thread::hardware_concurrency();
+  const char* ckpt_path = "sweep16.ckpt";
+  bool op_on[4] = {true, true, true, true};
+  uint64_t max_units = UINT64_MAX;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "-j" && i + 1 < argc)                threads = (unsigned)std::atoi(argv[++i]);
+    else if (a == "--checkpoint" && i + 1 < argc) ckpt_path = argv[++i];
+    else if (a == "--units" && i + 1 < argc)      max_units = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--ops" && i + 1 < argc) {
+      for (int o = 0; o < 4; o++) op_on[o] = false;
+      for (const char* p = argv[++i]; *p; p++)
+        if (*p >= '0' && *p <= '3') op_on[*p - '0'] = true;
+    } else if (a[0] == '+') continue; // plusargs for Verilator
+    else {
+      std::fprintf(stderr, "usage: sim_alu_sweep [-j N] [--checkpoint FILE] [--ops LIST] [--units N]\n");
+      return 2;
+    }
+  }
+  if (threads == 0) threads = 1;
+
+  std::vector<bool> done(UNITS, false);
+  Counts op_counts[4];
+  std::vector<std::string> firsts;
+  const size_t keep = load_checkpoint(ckpt_path, done, op_counts, firsts);
+
+  // drop a torn last line before appending to the log
+  std::error_code ec;
+  if (std::filesystem::exists(ckpt_path, ec)) std::filesystem::resize_file(ckpt_path, keep, ec);
+  FILE* log = std::fopen(ckpt_path, "ab");
+  if (!log) {
+    std::fprintf(stderr, "sim_alu_sweep: cannot open %s\n", ckpt_path);
+    return 2;
+  }
+
+  // deal the pending units round-robin; the threads go through the ops in
+  // step and stealing only has to even out the tail
+  std::vector<std::unique_ptr<WorkQueue>> queues;
+  for (unsigned t = 0; t < threads; t++) queues.emplace_back(new WorkQueue);
+  uint64_t pending = 0;
+  for (unsigned u = 0; u < UNITS; u++)
+    if (op_on[u / UNITS_PER_OP] && !done[u] && pending < max_units)
+      queues[pending++ % threads]->units.push_back(u);
+  std::fprintf(stderr, "sim_alu_sweep: %" PRIu64 " units (%.2f G cases) to go, %u threads\n",
+               pending, pending * (double)CASES_PER_UNIT / 1e9, threads);
+
+  std::mutex log_m;
+  std::atomic<uint64_t> finished{0};
+  const auto t0 = std::chrono::steady_clock::now();
+  auto last_report = t0;
+
+  auto worker = [&](unsigned self) {
+    auto ctx = std::make_unique<VerilatedContext>();
+    auto dut = std::make_unique<Valu>(ctx.get());
+    unsigned unit;
+    for (;;) {
+      bool got = queues[self]->pop(unit, false);
+      for (unsigned k = 1; !got && k < threads; k++) got = queues[(self + k) % threads]->pop(unit, true);
+      if (!got) break;
+
+      const UnitResult r = run_unit(*dut, unit);
+      const std::string line = format_unit(unit, r);
+
+      std::lock_guard<std::mutex> lk(log_m);
+      std::fputs(line.c_str(), log);
+      std::fflush(log);
+      op_counts[unit / UNITS_PER_OP].add(r.c);
+      if (r.has_first) firsts.push_back(OP_NAME[unit / UNITS_PER_OP] + format_first(r));
+      const uint64_t n = ++finished;
+      const auto now = std::chrono::steady_clock::now();
+      if (now - last_report > std::chrono::seconds(10) || n == pending) {
+        last_report = now;
+        const double s = std::chrono::duration<double>(now - t0).count();
+        std::fprintf(stderr, "  %" PRIu64 "/%" PRIu64 " units, %.1f M cases/s, eta %.0f s\n", n, pending,
+                     n * (double)CASES_PER_UNIT / s / 1e6, s / n * (pending - n));
+      }
+    }
+    dut->final();
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; t++) pool.emplace_back(worker, t);
+  for (std::thread& th : pool) th.join();
+  std::fclose(log);
+
+  // summary over everything in the checkpoint, this run and the previous ones
+  std::printf("\nfp16 exhaustive sweep (%s)\n", ckpt_path);
+  std::printf("  op   cases         mismatches    y            invalid      div0         ovf          unf          inx\n");
+  uint64_t total_bad = 0;
+  for (int o = 0; o < 4; o++) {
+    const Counts& c = op_counts[o];
+    std::printf("  %-4s %-13" PRIu64 " %-13" PRIu64 " %-12" PRIu64, OP_NAME[o], c.cases, c.bad, c.y);
+    for (int f = 4; f >= 0; f--) std::printf(" %-12" PRIu64, c.flag[f]);
+    std::printf("%s\n", c.cases == CASES_PER_UNIT * UNITS_PER_OP ? "" : "  (partial)");
+    total_bad += c.bad;
+  }
+  if (!firsts.empty()) {
+    std::printf("first mismatch of each failing unit (op a b rtl_y<<5|flags model_y<<5|flags):\n");
+    for (size_t i = 0; i < firsts.size() && i < 20; i++) std::printf("  %s\n", firsts[i].c_str());
+    if (firsts.size() > 20) std::printf("  ... %zu more units\n", firsts.size() - 20);
+  }
+  return total_bad ? 1 : 0;
+}
@@ -0,0 +1,303 @@
+// sim_cosim.cpp - lockstep co-simulation of the RISC-V top against iss.h
+//
+// Every instruction the RTL retires (sim_retire, called from
+// pipeline/riscvsingle.v) is replayed on the ISS and compared: PC,
+// instruction word, integer write-back, FP write-back and stores. The
+// multi-cycle fdiv writes its result later (sim_fpdiv_done); those results
+// are checked against a queue of the expected ones. The run stops at the
+// first divergence and prints the last retired instructions.
+//
+// --ff N runs the first N instructions on the ISS only and then hands the
+// architectural state (PC, registers, fcsr, mcountinhibit, mhpmevent,
+// memory) to the RTL, so long programs can skip their boot/setup code at ISS
+// speed.
+//
+// Build (from arquitectura_proyecto_alu.srcs/, Verilator 5):
+//   verilator -f verilator/top.f --cc --exe --build -j 0 -O3
+//     -GMEM_BITS=20 -GMEMFILE='""' --Mdir obj_cosim -o sim_cosim verilator/sim_cosim.cpp
+//
+// Usage:
+//   obj_cosim/sim_cosim [options] program.{elf,hex,txt}
+//     --max-cycles N   stop after N cycles (default 100000000), exit code 3
+//     --ff N           fast-forward N instructions on the ISS first
+//     --iss-only       run the whole program on the ISS
+//     --history N      retired instructions printed on a divergence (default 16)
+//     --quiet          only print the console output
+//
+// Exit code: 0 on pass, the tohost code on fail, 2 on usage errors,
+// 3 on timeout, 4 on a divergence.
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "Vtop.h"
+#include "Vtop__Dpi.h"
+#include "svdpi.h"
+#include "verilated.h"
+
+#include "image.h"
+#include "iss.h"
+
+static const uint32_t TOHOST  = 0xFFFFFFF0;
+static const uint32_t CONSOLE = 0xFFFFFFF4;
+static const unsigned MEM_BITS = 20; // must match -GMEM_BITS
+
+static Iss iss(MEM_BITS);
+static uint64_t instret = 0;
+static bool diverged = false;
+
+struct PendingDiv {
+  uint32_t frd, fwd;
+};
+static std::deque<PendingDiv> pending;
+
+// recent retires for the divergence report
+struct Entry {
+  Retire iss;
+  uint32_t rd, wd, frd, fwd, madr, mwd;
+  bool we, fwe, mwe;
+};
+static std::deque<Entry> history;
+static size_t history_len = 16;
+
+static void report(const char* what) {
+  std::fprintf(stderr, "*** DIVERGENCE after %" PRIu64 " instructions: %s\n", instret, what);
+  std::fprintf(stderr, "last retired (ISS | RTL):\n");
+  for (const Entry& e : history) {
+    std::fprintf(stderr, "  %08x %08x", e.iss.pc, e.iss.instr);
+    if (e.iss.we)  std::fprintf(stderr, "  x%-2u=%08x", e.iss.rd, e.iss.wd);
+    if (e.iss.fwe) std::fprintf(stderr, "  f%-2u=%08x%s", e.iss.frd, e.iss.fwd, e.iss.fwe_late ? " (late)" : "");
+    if (e.iss.mwe) std::fprintf(stderr, "  [%08x]=%08x", e.iss.madr, e.iss.mwd);
+    std::fprintf(stderr, "  |");
+    if (e.we && e.rd)  std::fprintf(stderr, "  x%-2u=%08x", e.rd, e.wd);
+    if (e.fwe) std::fprintf(stderr, "  f%-2u=%08x", e.frd, e.fwd);
+    if (e.mwe) std::fprintf(stderr, "  [%08x]=%08x", e.madr, e.mwd);
+    std::fprintf(stderr, "\n");
+  }
+  diverged = true;
+}
+
+void sim_retire(int pc, int instr, svBit we, int rd, int wd, svBit fwe, int frd, int fwd,
+                svBit mwe, int msize, int madr, int mwd) {
+  if (diverged) return;
+  Retire r = iss.step();
+  instret++;
+
+  Entry e{r, (uint32_t)rd, (uint32_t)wd, (uint32_t)frd, (uint32_t)fwd, (uint32_t)madr,
+          (uint32_t)mwd, we != 0, fwe != 0, mwe != 0};
+  history.push_back(e);
+  if (history.size() > history_len) history.pop_front();
+
+  char msg[160];
+  if ((uint32_t)pc != r.pc || (uint32_t)instr != r.instr) {
+    std::snprintf(msg, sizeof msg, "pc/instr %08x %08x, expected %08x %08x", pc, instr, r.pc, r.instr);
+    return report(msg);
+  }
+  if (r.illegal) {
+    std::snprintf(msg, sizeof msg, "instruction %08x at %08x not implemented in the ISS", r.instr, r.pc);
+    return report(msg);
+  }
+
+  // integer write-back; x0 writes are not architectural
+  const bool rtl_we = we && rd != 0;
+  if (rtl_we != r.we || (r.we && (uint32_t)rd != r.rd)) {
+    std::snprintf(msg, sizeof msg, "register write %s x%d, expected %s x%u",
+                  rtl_we ? "to" : "none", rd, r.we ? "to" : "none", r.rd);
+    return report(msg);
+  }
+  if (r.we && r.counter_read) iss.sync_counter_read(r, (uint32_t)wd);
+  else if (r.we && (uint32_t)wd != r.wd) {
+    std::snprintf(msg, sizeof msg, "x%u = %08x, expected %08x", r.rd, wd, r.wd);
+    return report(msg);
+  }
+
+  // FP write-back; fdiv results come later through sim_fpdiv_done
+  if (r.fwe && r.fwe_late) pending.push_back({r.frd, r.fwd});
+  const bool iss_fwe = r.fwe && !r.fwe_late;
+  if ((fwe != 0) != iss_fwe || (iss_fwe && ((uint32_t)frd != r.frd || (uint32_t)fwd != r.fwd))) {
+    std::snprintf(msg, sizeof msg, "FP write %s f%d = %08x, expected %s f%u = %08x",
+                  fwe ? "to" : "none", frd, fwd, iss_fwe ? "to" : "none", r.frd, r.fwd);
+    return report(msg);
+  }
+
+  // stores: the RTL replicates a byte/half in every lane, compare the stored bytes only
+  if ((mwe != 0) != r.mwe) {
+    std::snprintf(msg, sizeof msg, "store %s, expected %s", mwe ? "issued" : "missing", r.mwe ? "one" : "none");
+    return report(msg);
+  }
+  if (r.mwe) {
+    const uint32_t mask = r.msize == 4 ? 0xffffffffu : (1u << (8 * r.msize)) - 1;
+    const unsigned rtl_size = (unsigned)msize;
+    if ((uint32_t)madr != r.madr || rtl_size != r.msize || (((uint32_t)mwd ^ r.mwd) & mask)) {
+      std::snprintf(msg, sizeof msg, "store %u bytes [%08x] = %08x, expected %u bytes [%08x] = %08x",
+                    rtl_size, madr, mwd, r.msize, r.madr, r.mwd & mask);
+      return report(msg);
+    }
+  }
+}
+
+void sim_fpdiv_done(int frd, int fwd) {
+  if (diverged) return;
+  char msg[160];
+  if (pending.empty()) {
+    std::snprintf(msg, sizeof msg, "unexpected fdiv result f%d = %08x", frd, fwd);
+    return report(msg);
+  }
+  PendingDiv p = pending.front();
+  pending.pop_front();
+  if ((uint32_t)frd != p.frd || (uint32_t)fwd != p.fwd) {
+    std::snprintf(msg, sizeof msg, "fdiv f%d = %08x, expected f%u = %08x", frd, fwd, p.frd, p.fwd);
+    return report(msg);
+  }
+}
+
+static void set_scope(const char* name) {
+  svScope s = svGetScopeFromName(name);
+  if (!s) {
+    std::fprintf(stderr, "sim_cosim: scope %s not found (top must be built with CACHES=1)\n", name);
+    std::exit(2);
+  }
+  svSetScope(s);
+}
+
+// copies the ISS instruction and data memories into the backing memories
+static void poke_all() {
+  set_scope("TOP.top.mem.imainmem");
+  if ((unsigned)mainmem_addr_bits() != MEM_BITS) {
+    std::fprintf(stderr, "sim_cosim: mainmem built with -GMEM_BITS=%d, the ISS uses %u\n",
+                 mainmem_addr_bits(), MEM_BITS);
+    std::exit(2);
+  }
+  for (size_t w = 0; w < iss.mem_words(); w++) mainmem_poke((int)w, (int)iss.fetch_word((uint32_t)w));
+  set_scope("TOP.top.mem.dmainmem");
+  for (size_t w = 0; w < iss.mem_words(); w++) mainmem_poke((int)w, (int)iss.load_word((uint32_t)w));
+}
+
+// MMIO store seen by the ISS or the RTL; returns the tohost code or -1
+static int mmio_store(uint32_t adr, uint32_t wd) {
+  if (adr == CONSOLE) {
+    std::putchar((int)(wd & 0xff));
+    std::fflush(stdout);
+  } else if (adr == TOHOST && wd != 0) {
+    return wd == 1 ? 0 : (int)(wd >> 1);
+  }
+  return -1;
+}
+
+int main(int argc, char** argv) {
+  auto ctx = std::make_unique<VerilatedContext>();
+  ctx->commandArgs(argc, argv);
+
+  uint64_t max_cycles = 100000000, ff = 0;
+  const char* prog = nullptr;
+  bool quiet = false, iss_only = false;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--max-cycles" && i + 1 < argc)   max_cycles = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--ff" && i + 1 < argc)      ff = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--history" && i + 1 < argc) history_len = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--iss-only")                iss_only = true;
+    else if (a == "--quiet")                   quiet = true;
+    else if (a[0] == '+')                      continue; // plusargs for Verilator
+    else if (a[0] != '-' && !prog)             prog = argv[i];
+    else {
+      std::fprintf(stderr, "sim_cosim: unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (!prog || history_len == 0) {
+    std::fprintf(stderr, "usage: sim_cosim [options] program.{elf,hex,txt}\n");
+    return 2;
+  }
+
+  Image img;
+  std::string err;
+  if (!load_image(prog, img, err)) {
+    std::fprintf(stderr, "sim_cosim: %s\n", err.c_str());
+    return 2;
+  }
+  if (!image_fits(img, MEM_BITS, err)) {
+    std::fprintf(stderr, "sim_cosim: %s; rebuild with a larger -GMEM_BITS and MEM_BITS\n", err.c_str());
+    return 2;
+  }
+  img.for_each_word([](uint32_t waddr, uint32_t w) { iss.store_word(waddr, w); });
+
+  // fast-forward (or the whole run) on the ISS
+  int code = -1;
+  if (iss_only) ff = max_cycles;
+  for (uint64_t n = 0; n < ff && code < 0; n++) {
+    Retire r = iss.step();
+    if (r.illegal) {
+      std::fprintf(stderr, "sim_cosim: instruction %08x at %08x not implemented in the ISS\n", r.instr, r.pc);
+      return 2;
+    }
+    if (r.mwe && Iss::mmio(r.madr)) code = mmio_store(r.madr, r.mwd);
+  }
+  if (iss_only || code >= 0) {
+    if (!quiet) {
+      if (code < 0)       std::fprintf(stderr, "*** TIMEOUT after %" PRIu64 " instructions\n", iss.instret);
+      else if (code == 0) std::fprintf(stderr, "*** PASSED (ISS)\n");
+      else                std::fprintf(stderr, "*** FAILED (ISS) with code %d\n", code);
+      std::fprintf(stderr, "instret %" PRIu64 "\n", iss.instret);
+    }
+    return code < 0 ? 3 : code;
+  }
+
+  auto top = std::make_unique<Vtop>(ctx.get());
+
+  // reset, then load the memories (the ISS image, after the fast-forward)
+  top->clk = 0;
+  top->reset = 1;
+  top->eval();
+  poke_all();
+  for (int i = 0; i < 2; i++) {
+    top->clk = 1; top->eval();
+    top->clk = 0; top->eval();
+  }
+  top->reset = 0;
+  top->eval();
+
+  // hand over the architectural state
+  if (ff) {
+    set_scope("TOP.top.rvsingle");
+    sim_set_pc((int)iss.pc);
+    for (int r = 1; r < 32; r++) sim_set_x(r, (int)iss.x[r]);
+    for (int r = 0; r < 32; r++) sim_set_f(r, (int)iss.f[r]);
+    sim_set_fcsr((int)((iss.frm << 5) | iss.fflags));
+    sim_set_mcountinhibit((int)iss.mcountinhibit());
+    for (int n = 3; n < 32; n++) sim_set_mhpmevent(n, (int)iss.mhpmevent(n));
+    top->eval();
+    if (!quiet) std::fprintf(stderr, "fast-forwarded %" PRIu64 " instructions, RTL starts at %08x\n", ff, iss.pc);
+  }
+
+  uint64_t cycle = 0;
+  while (code < 0 && !diverged && cycle < max_cycles && !ctx->gotFinish()) {
+    // the store of the current cycle is visible before the rising edge
+    if (top->MemWrite) code = mmio_store(top->DataAdr, top->WriteData);
+
+    top->clk = 1;
+    top->eval();
+    top->clk = 0;
+    top->eval();
+    cycle++;
+  }
+  top->final();
+
+  if (!diverged && code >= 0 && !pending.empty())
+    std::fprintf(stderr, "sim_cosim: warning: %zu fdiv results still in flight\n", pending.size());
+
+  if (!quiet) {
+    if (diverged)       {} // already reported
+    else if (code < 0)  std::fprintf(stderr, "*** TIMEOUT after %" PRIu64 " cycles\n", cycle);
+    else if (code == 0) std::fprintf(stderr, "*** PASSED\n");
+    else                std::fprintf(stderr, "*** FAILED with code %d\n", code);
+    std::fprintf(stderr, "cycles  %" PRIu64 "\ninstret %" PRIu64 " (RTL), %" PRIu64 " (ISS)\n",
+                 cycle, instret, iss.instret);
+  }
+  if (diverged) return 4;
+  return code < 0 ? 3 : code;
+}
@@ -0,0 +1,194 @@
+// sim_top.cpp - Verilator harness for the RISC-V top (pipeline/top.v)
+//
+// Loads an ELF or hex program into both backing memories (mainmem, through
+// its DPI backdoor), runs until the program writes tohost and reports
+// cycles, retired instructions and IPC.
+//
+// Memory-mapped I/O (see pipeline/top.v):
+//   0xFFFFFFF0  tohost   1 = pass, (code << 1) | 1 = fail with code
+//   0xFFFFFFF4  console  putchar of the low byte
+//
+// Build (from arquitectura_proyecto_alu.srcs/, Verilator 5):
+//   verilator -f verilator/top.f --cc --exe --build -j 0 -O3
+//     -GMEM_BITS=20 -GMEMFILE='""' --Mdir obj_top -o sim_top verilator/sim_top.cpp
+// add --trace (VCD) or --trace-fst (FST) to enable --trace
+//
+// Usage:
+//   obj_top/sim_top [options] program.{elf,hex,txt}
+//     --max-cycles N   stop after N cycles (default 100000000), exit code 3
+//     --trace FILE     dump waves to FILE
+//     --trace-from N   first cycle in the dump (default 0)
+//     --trace-to N     last cycle in the dump (default: end of the run)
+//     --trace-scope S  only the signals under S (e.g. top.rvsingle.dp)
+//     --trace-depth D  hierarchy levels under the scope (default 0 = all)
+//     --quiet          only print the console output
+//
+// Exit code: 0 on pass, the tohost code on fail, 2 on usage errors.
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "Vtop.h"
+#include "Vtop__Dpi.h"
+#include "svdpi.h"
+#include "verilated.h"
+#if VM_TRACE_FST
+#include "verilated_fst_c.h"
+typedef VerilatedFstC TraceFile;
+#elif VM_TRACE
+#include "verilated_vcd_c.h"
+typedef VerilatedVcdC TraceFile;
+#endif
+
+#include "image.h"
+
+static const uint32_t TOHOST  = 0xFFFFFFF0;
+static const uint32_t CONSOLE = 0xFFFFFFF4;
+
+static uint64_t instret = 0;
+
+// pipeline/riscvsingle.v calls these once per retired instruction and once
+// per fdiv result; only sim_cosim.cpp looks at the arguments
+void sim_retire(int, int, svBit, int, int, svBit, int, int, svBit, int, int, int) {
+  instret++;
+}
+
+void sim_fpdiv_done(int, int) {}
+
+static void poke_all(const Image& img) {
+  const char* scopes[] = {"TOP.top.mem.imainmem", "TOP.top.mem.dmainmem"};
+  for (const char* name : scopes) {
+    svScope s = svGetScopeFromName(name);
+    if (!s) {
+      std::fprintf(stderr, "sim_top: scope %s not found (top must be built with CACHES=1)\n", name);
+      std::exit(2);
+    }
+    svSetScope(s);
+    std::string err;
+    if (!image_fits(img, (unsigned)mainmem_addr_bits(), err)) {
+      std::fprintf(stderr, "sim_top: %s; rebuild with a larger -GMEM_BITS\n", err.c_str());
+      std::exit(2);
+    }
+    img.for_each_word([](uint32_t waddr, uint32_t w) { mainmem_poke((int)waddr, (int)w); });
+  }
+}
+
+int main(int argc, char** argv) {
+  auto ctx = std::make_unique<VerilatedContext>();
+  ctx->commandArgs(argc, argv);
+
+  uint64_t max_cycles = 100000000, trace_from = 0, trace_to = UINT64_MAX;
+  const char* trace_path = nullptr;
+  std::string trace_scope;
+  int trace_depth = 0;
+  const char* prog = nullptr;
+  bool quiet = false;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--max-cycles" && i + 1 < argc)      max_cycles = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--trace" && i + 1 < argc)      trace_path = argv[++i];
+    else if (a == "--trace-from" && i + 1 < argc) trace_from = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--trace-to" && i + 1 < argc)   trace_to = std::strtoull(argv[++i], nullptr, 0);
+    else if (a == "--trace-scope" && i + 1 < argc) trace_scope = argv[++i];
+    else if (a == "--trace-depth" && i + 1 < argc) trace_depth = std::atoi(argv[++i]);
+    else if (a == "--quiet")                      quiet = true;
+    else if (a[0] == '+')                         continue; // plusargs for Verilator
+    else if (a[0] != '-' && !prog)                prog = argv[i];
+    else {
+      std::fprintf(stderr, "sim_top: unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (!prog) {
+    std::fprintf(stderr, "usage: sim_top [options] program.{elf,hex,txt}\n");
+    return 2;
+  }
+
+  Image img;
+  std::string err;
+  if (!load_image(prog, img, err)) {
+    std::fprintf(stderr, "sim_top: %s\n", err.c_str());
+    return 2;
+  }
+  if (img.entry != 0)
+    std::fprintf(stderr, "sim_top: warning: entry point 0x%08x, the core starts at 0\n", img.entry);
+
+  auto top = std::make_unique<Vtop>(ctx.get());
+
+#if VM_TRACE
+  std::unique_ptr<TraceFile> tf;
+  if (trace_path) ctx->traceEverOn(true);
+#else
+  if (trace_path) std::fprintf(stderr, "sim_top: built without --trace, ignoring --trace\n");
+  (void)trace_from;
+  (void)trace_to;
+  (void)trace_depth;
+#endif
+
+  // reset, then load the program (the memories are not cleared by reset)
+  top->clk = 0;
+  top->reset = 1;
+  top->eval();
+  poke_all(img);
+  for (int i = 0; i < 2; i++) {
+    top->clk = 1; top->eval();
+    top->clk = 0; top->eval();
+  }
+  top->reset = 0;
+  top->eval();
+
+  uint64_t cycle = 0;
+  int code = -1;
+  while (code < 0 && cycle < max_cycles && !ctx->gotFinish()) {
+#if VM_TRACE
+    if (trace_path && !tf && cycle >= trace_from && cycle <= trace_to) {
+      tf = std::make_unique<TraceFile>();
+      top->trace(tf.get(), 99);
+      if (!trace_scope.empty()) tf->dumpvars(trace_depth, trace_scope);
+      tf->open(trace_path);
+    }
+    if (tf && cycle > trace_to) { tf->close(); tf.reset(); trace_path = nullptr; }
+#endif
+
+    // the store of the current cycle is visible before the rising edge
+    if (top->MemWrite) {
+      uint32_t adr = top->DataAdr;
+      if (adr == CONSOLE) {
+        std::putchar((int)(top->WriteData & 0xff));
+        std::fflush(stdout);
+      } else if (adr == TOHOST && top->WriteData != 0) {
+        code = (top->WriteData == 1) ? 0 : (int)(top->WriteData >> 1);
+      }
+    }
+
+    top->clk = 1;
+    top->eval();
+#if VM_TRACE
+    if (tf) tf->dump(2 * cycle + 1);
+#endif
+    top->clk = 0;
+    top->eval();
+#if VM_TRACE
+    if (tf) tf->dump(2 * cycle + 2);
+#endif
+    cycle++;
+  }
+
+#if VM_TRACE
+  if (tf) tf->close();
+#endif
+  top->final();
+
+  if (!quiet) {
+    if (code < 0)       std::fprintf(stderr, "*** TIMEOUT after %llu cycles\n", (unsigned long long)cycle);
+    else if (code == 0) std::fprintf(stderr, "*** PASSED\n");
+    else                std::fprintf(stderr, "*** FAILED with code %d\n", code);
+    std::fprintf(stderr, "cycles  %llu\ninstret %llu\nIPC     %.3f\n",
+                 (unsigned long long)cycle, (unsigned long long)instret,
+                 cycle ? (double)instret / (double)cycle : 0.0);
+  }
+  return code < 0 ? 3 : code;
+}
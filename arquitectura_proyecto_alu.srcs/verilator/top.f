@@ -0,0 +1,47 @@
+// Verilator file list for the RISC-V top (pipeline/top.v), relative to
+// arquitectura_proyecto_alu.srcs/; see sim_top.cpp for the build command
+--top-module top
+--timescale 1ns/1ps
++1800-2017ext+v
+verilator/lint.vlt
+-Ipipeline
+-Isources_1/new
+pipeline/top.v
+pipeline/riscvsingle.v
+pipeline/cdec.v
+pipeline/controller.v
+pipeline/maindec.v
+pipeline/aludec.v
+pipeline/fpdec.v
+pipeline/datapath.v
+pipeline/flopr.v
+pipeline/flopenr.v
+pipeline/adder.v
+pipeline/mux2.v
+pipeline/mux3.v
+pipeline/mux4.v
+pipeline/regfile.v
+pipeline/regfile2w.v
+pipeline/dualslot.v
+pipeline/fpregfile.v
+pipeline/extend.v
+pipeline/alu.v
+pipeline/mdu.v
+pipeline/fpu.v
+pipeline/fpdiv.v
+pipeline/scoreboard.v
+pipeline/csr.v
+pipeline/loaduse.v
+pipeline/bpred.v
+pipeline/cache.v
+pipeline/mainmem.v
+pipeline/imem.v
+pipeline/dmem.v
+pipeline/lsu.v
+sources_1/new/alu.v
+sources_1/new/SumaResta.v
+sources_1/new/Multiplicacion.v
+sources_1/new/Division.v
+sources_1/new/RoundNearestEven.v
+sources_1/new/flags_operations.v
+sources_1/new/fp16_special_cases.v